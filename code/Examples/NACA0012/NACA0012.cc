@@ -30,6 +30,8 @@ int main()
 
     // Store meshes
     std::shared_ptr<MESH::mesh> su2Mesh = std::make_shared<MESH::mesh>(testMesh.get_mesh());
+    // Renumber cells and faces for cache locality (before the solver is built on the mesh)
+    su2Mesh->renumber(MESH::renumberingEnum::RCM);
 
     // Construct SIMPLE solver
     // NOTE: this HAS to be a smart pointer so that the boundary condition solver pointers do not go out of scope and return null pointers
@@ -37,7 +39,7 @@ int main()
 
 
     // Set boundary conditions
-    MATH::Vector velocity(std::vector<double>{1.0,0.0});  // m/s
+    MATH::Vec<3> velocity(std::vector<double>{1.0,0.0});  // m/s
     BOUNDARIES::inlet inlet(simpleSolver,"inlet",velocity);
     BOUNDARIES::outlet outlet(simpleSolver,"outlet",0.0);
     BOUNDARIES::outlet farfield(simpleSolver,"farfield",0.0);
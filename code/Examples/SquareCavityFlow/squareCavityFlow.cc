@@ -28,6 +28,8 @@ int main()
 
     // Store meshes
     std::shared_ptr<MESH::mesh> su2Mesh = std::make_shared<MESH::mesh>(testMesh.get_mesh());
+    // Renumber cells and faces for cache locality (before the solver is built on the mesh)
+    su2Mesh->renumber(MESH::renumberingEnum::RCM);
 
     // Construct SIMPLE solver
     // NOTE: this HAS to be a smart pointer so that the boundary condition solver pointers do not go out of scope and return null pointers
@@ -37,7 +39,7 @@ int main()
     // Set boundary conditions
     BOUNDARIES::viscousWallBC bottom(simpleSolver,"bottom");
     BOUNDARIES::viscousWallBC top(simpleSolver,"top");
-    top.set_velocity(MATH::Vector(std::vector<double>{0.1,0.0}));
+    top.set_velocity(MATH::Vec<3>(std::vector<double>{0.1,0.0}));
     simpleSolver->setBoundaryCondition(std::make_shared<BOUNDARIES::viscousWallBC>(bottom));
     simpleSolver->setBoundaryCondition(std::make_shared<BOUNDARIES::viscousWallBC>(top));
 
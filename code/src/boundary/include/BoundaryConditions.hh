@@ -16,7 +16,7 @@
 
 #include "MeshEntities.hh"
 #include "Solver.hh"
-#include "Vector.hh"
+#include "Vec.hh"
 
 namespace BOUNDARIES {
 
@@ -49,11 +49,11 @@ public:
         // Method to check if BC is complete or not
         virtual bool isComplete() {return false;};
         // Methods to set velocity
-        virtual void set_velocity(MATH::Vector) {};
+        virtual void set_velocity(MATH::Vec<3>) {};
         // Methods to get pressure
         virtual double get_pressure(int) = 0;
         // Methods to get Velocity
-        virtual MATH::Vector get_velocity(int) = 0;
+        virtual MATH::Vec<3> get_velocity(int) = 0;
         // Method to get mass flux
         virtual double get_massFlux(int) = 0;
 
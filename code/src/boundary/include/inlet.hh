@@ -25,9 +25,9 @@ class inlet
 public:
     // Constructor
         // Construct with BC copy constructor
-        inlet(std::weak_ptr<SOLVER::Solver> solver, std::string BCname, MATH::Vector);
+        inlet(std::weak_ptr<SOLVER::Solver> solver, std::string BCname, MATH::Vec<3>);
         // Construct with name, ID
-        inlet(std::weak_ptr<SOLVER::Solver> , int, MATH::Vector);
+        inlet(std::weak_ptr<SOLVER::Solver> , int, MATH::Vec<3>);
 
     // Methods
         // Check if BC is complete
@@ -37,14 +37,14 @@ public:
         // Get Pressure From face index and internal pressure field
         double get_pressure(int) override;
         // Get Velocity for specific index
-        MATH::Vector get_velocity(int) override;
+        MATH::Vec<3> get_velocity(int) override;
         // get Mass Flux
         double get_massFlux(int) override;
 
 private:
     // Member data
         // Velocity constant at the inlet
-        MATH::Vector _velocity;
+        MATH::Vec<3> _velocity;
         // Pressure varies along inlet
         std::vector<double> _pressure;
 
@@ -37,7 +37,7 @@ public:
         // Get Pressure From face index and internal pressure field
         double get_pressure(int) override;
         // Get Velocity for specific index
-        MATH::Vector get_velocity(int) override;
+        MATH::Vec<3> get_velocity(int) override;
         // get Mass Flux
         double get_massFlux(int) override;
 
@@ -33,19 +33,19 @@ public:
         // Check if BC is complete
         bool isComplete() override;
         // Set velocity
-        void set_velocity(MATH::Vector velocity) override { _velocity = velocity; };
+        void set_velocity(MATH::Vec<3> velocity) override { _velocity = velocity; };
 
     // Methods to get Boundary condition values
         // Get Pressure From face index and internal pressure field
         double get_pressure(int) override;
         // Get Velocity for specific index
-        MATH::Vector get_velocity(int) override;
+        MATH::Vec<3> get_velocity(int) override;
         // get Mass Flux
         double get_massFlux(int) override;
 
 protected:
     // Member data
-        MATH::Vector _velocity; // Assume constant, cartesian aligned velocity for now
+        MATH::Vec<3> _velocity; // Assume constant, cartesian aligned velocity for now
         std::vector<double> _pressure; // Pressure is constant at the wall
         boundaryConditionType _bcType = boundaryConditionType::WALL;
 
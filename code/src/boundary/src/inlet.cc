@@ -18,7 +18,7 @@
 
 // * * * * * * * * * * * * * *  Constructors * * * * * * * * * * * * * * * //
 // Construct with BC copy constructor
-BOUNDARIES::inlet::inlet(std::weak_ptr<SOLVER::Solver> solver , std::string BCname, MATH::Vector velocity)
+BOUNDARIES::inlet::inlet(std::weak_ptr<SOLVER::Solver> solver , std::string BCname, MATH::Vec<3> velocity)
 : 
     BOUNDARIES::BoundaryCondition(solver, BCname)
 { 
@@ -32,7 +32,7 @@ BOUNDARIES::inlet::inlet(std::weak_ptr<SOLVER::Solver> solver , std::string BCna
 };
 
 // Construct with name, faces vector and ID
-BOUNDARIES::inlet::inlet(std::weak_ptr<SOLVER::Solver> solver , int BCID, MATH::Vector velocity)
+BOUNDARIES::inlet::inlet(std::weak_ptr<SOLVER::Solver> solver , int BCID, MATH::Vec<3> velocity)
 : 
     BOUNDARIES::BoundaryCondition(solver, BCID) 
 { 
@@ -69,7 +69,7 @@ double BOUNDARIES::inlet::get_pressure(int globalFaceIdx)
 }
 
 // * * * * * * * * * * * * * *  Get Velocity for specific face * * * * * * * * * * * * * * * //
-MATH::Vector BOUNDARIES::inlet::get_velocity(int globalFaceIdx)
+MATH::Vec<3> BOUNDARIES::inlet::get_velocity(int globalFaceIdx)
 {
     auto solverPtr = get_solver();
 
@@ -54,7 +54,7 @@ double BOUNDARIES::outlet::get_pressure(int globalFaceIdx)
 }
 
 // * * * * * * * * * * * * * *  Get Velocity for specific face * * * * * * * * * * * * * * * //
-MATH::Vector BOUNDARIES::outlet::get_velocity(int globalFaceIdx)
+MATH::Vec<3> BOUNDARIES::outlet::get_velocity(int globalFaceIdx)
 {
     auto solverPtr = get_solver();
 
@@ -63,7 +63,7 @@ MATH::Vector BOUNDARIES::outlet::get_velocity(int globalFaceIdx)
 
     // Get velocity from nearest internal cell
     int internalID = solverPtr->get_mesh()->get_faces()[globalFaceIdx]->get_elements()[0]->get_id();
-    MATH::Vector v = solverPtr->get_cellVelocityField().get_internal()[internalID];
+    MATH::Vec<3> v = solverPtr->get_cellVelocityField().get_internal()[internalID];
 
     return v;
 }
@@ -82,7 +82,7 @@ double BOUNDARIES::outlet::get_massFlux(int globalFaceIdx)
     std::shared_ptr<MESH::element> cell = f->get_elements()[0];
 
     // Get the velocity from the nearest internal element
-    MATH::Vector v = get_velocity(globalFaceIdx);
+    MATH::Vec<3> v = get_velocity(globalFaceIdx);
 
     // Mass flux going INTO the cell
     return - ( solverPtr->get_density() * v * cell->get_normals()[*cell == *f] * f->get_volume() );
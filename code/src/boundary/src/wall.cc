@@ -25,7 +25,7 @@ BOUNDARIES::viscousWallBC::viscousWallBC(std::weak_ptr<SOLVER::Solver> solver ,
     // Lock weak pointer to create shared pointer
     auto solverPtr = get_solver();
 
-    _velocity = MATH::Vector(solverPtr->get_mesh()->get_dimension(), 0.0); 
+    _velocity = MATH::Vec<3>(solverPtr->get_mesh()->get_dimension(), 0.0); 
 };
 // Construct with name, faces vector and ID
 BOUNDARIES::viscousWallBC::viscousWallBC(std::weak_ptr<SOLVER::Solver> solver , int BCID)
@@ -35,7 +35,7 @@ BOUNDARIES::viscousWallBC::viscousWallBC(std::weak_ptr<SOLVER::Solver> solver ,
     // Lock weak pointer to create shared pointer
     auto solverPtr = get_solver();
 
-    _velocity = MATH::Vector(solverPtr->get_mesh()->get_dimension(), 0.0); 
+    _velocity = MATH::Vec<3>(solverPtr->get_mesh()->get_dimension(), 0.0); 
 };
 
 // * * * * * * * * * * * * * *  Check if BC is complete * * * * * * * * * * * * * * * //
@@ -61,7 +61,7 @@ double BOUNDARIES::viscousWallBC::get_pressure(int globalFaceIdx)
 }
 
 // * * * * * * * * * * * * * *  Get Velocity for specific face * * * * * * * * * * * * * * * //
-MATH::Vector BOUNDARIES::viscousWallBC::get_velocity(int globalFaceIdx)
+MATH::Vec<3> BOUNDARIES::viscousWallBC::get_velocity(int globalFaceIdx)
 {
     auto solverPtr = get_solver();
 
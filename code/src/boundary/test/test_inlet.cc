@@ -13,7 +13,7 @@
 #include "BoundaryConditions.hh"
 #include "mesh.hh"
 #include "read_su2.hh"
-#include "Vector.hh"
+#include "Vec.hh"
 #include "inlet.hh"
 
 
@@ -51,7 +51,7 @@ public:
 
 // * * * * * * * * * * * * test test setting velocity * * * * * * * * * * * * * * //
 TEST_F(test_inlet, testInletVelocity) {
-    MATH::Vector velocity(std::vector<double>{1.0,0.0});
+    MATH::Vec<3> velocity(std::vector<double>{1.0,0.0});
     BOUNDARIES::inlet testInlet(solver,"lower",velocity);
 
     std::cout << "Testing Inlet Velocity" << std::endl;
@@ -13,7 +13,7 @@
 #include "BoundaryConditions.hh"
 #include "mesh.hh"
 #include "read_su2.hh"
-#include "Vector.hh"
+#include "Vec.hh"
 #include "wall.hh"
 
 
@@ -54,7 +54,7 @@ TEST_F(test_BCs, testWallVelocity) {
     BOUNDARIES::viscousWallBC testWall(solver,"lower");
 
     std::cout << "Testing Wall Velocity" << std::endl;
-    MATH::Vector vel(std::vector<double>{1.0,0.0});
+    MATH::Vec<3> vel(std::vector<double>{1.0,0.0});
     testWall.set_velocity(vel);
 
     std::cout << "Asserting velocity..." << std::endl;
@@ -0,0 +1,139 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      solverBenchmark.cc
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     Replays a Matrix Market system through every linear solver / preconditioner combination
+**
+**  usage:      solverBenchmark A.mtx [b.mtx] [tolerance] [maxIterations] [repeats]
+**              (b = A * ones if no right-hand side is given, e.g. systems dumped by SIMPLE::set_systemDump)
+**
+\*------------------------------------------------------------------------*/
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "matrixMarket.hh"
+#include "linearSolvers.hh"
+
+
+// Solver, its name and the sparse products it performs per iteration (for the GFLOP/s estimate)
+struct solverEntry
+{
+    MATH::linearSolverType type;
+    std::string name;
+    int productsPerIteration;
+    bool preconditioned;
+};
+
+struct preconditionerEntry
+{
+    MATH::preconditionerType type;
+    std::string name;
+};
+
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " A.mtx [b.mtx] [tolerance] [maxIterations] [repeats]" << std::endl;
+        return 1;
+    }
+
+    MATH::matrixCSR A(0, 0);
+    MATH::Vector b;
+    try {
+        A = MATH::read_matrix_market_matrix(argv[1]);
+        if (argc > 2) {
+            b = MATH::read_matrix_market_vector(argv[2]);
+        }
+        else {
+            b = A * MATH::Vector(A.get_num_columns(), 1.0);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    double tolerance = argc > 3 ? std::atof(argv[3]) : 1.0e-6;
+    unsigned maxIterations = argc > 4 ? std::atoi(argv[4]) : 10000;
+    int repeats = argc > 5 ? std::atoi(argv[5]) : 3;
+
+    int nnz = A.get_values().size();
+    std::cout << "System: " << A.get_num_rows() << " rows, " << nnz << " nonzeros, tolerance " << tolerance << std::endl;
+
+    const std::vector<solverEntry> solvers = {
+        {MATH::linearSolverType::gauss_seidel,            "gauss_seidel",            1, false},
+        {MATH::linearSolverType::multicolor_gauss_seidel, "multicolor_gauss_seidel", 1, false},
+        {MATH::linearSolverType::jacobi,                  "jacobi",                  1, false},
+        {MATH::linearSolverType::sor,                     "sor",                     1, false},
+        {MATH::linearSolverType::ssor,                    "ssor",                    2, false},
+        {MATH::linearSolverType::conjugate_gradient,      "conjugate_gradient",      1, true},
+        {MATH::linearSolverType::bicgstab,                "bicgstab",                2, true},
+        {MATH::linearSolverType::gmres,                   "gmres",                   1, true},
+        {MATH::linearSolverType::mixed_precision,         "mixed_precision",         2, true},
+        // Direct solvers: one refactorization per solve (the symbolic phase is reused), iterations are refinement steps
+        {MATH::linearSolverType::direct_cholesky,         "direct_cholesky",         1, false},
+        {MATH::linearSolverType::direct_lu,               "direct_lu",               1, false}
+    };
+    const std::vector<preconditionerEntry> preconditioners = {
+        {MATH::preconditionerType::none,   "none"},
+        {MATH::preconditionerType::jacobi, "jacobi"},
+        {MATH::preconditionerType::ic0,    "ic0"},
+        {MATH::preconditionerType::ssor,   "ssor"},
+        {MATH::preconditionerType::amg,    "amg"}
+    };
+
+    std::cout << std::left << std::setw(26) << "solver" << std::setw(10) << "precond"
+              << std::right << std::setw(12) << "time [ms]" << std::setw(12) << "iterations"
+              << std::setw(14) << "rel. resid" << std::setw(10) << "GFLOP/s" << std::endl;
+
+    for (const solverEntry& s : solvers) {
+        for (const preconditionerEntry& p : preconditioners) {
+            // Stationary solvers ignore preconditioners
+            if (!s.preconditioned && p.type != MATH::preconditionerType::none) continue;
+
+            std::unique_ptr<MATH::linear_solver_base<MATH::matrixCSR>> solver = MATH::make_linear_solver<MATH::matrixCSR>(s.type);
+            solver->set_matrix(A);
+            solver->set_rhs(b);
+            solver->set_preconditioner(MATH::make_preconditioner<MATH::matrixCSR>(p.type));
+
+            // Best of the repeats, preconditioner setup included (it is redone at every solve)
+            double best = 0.0;
+            MATH::Vector x;
+            try {
+                for (int r = 0; r < repeats; r++) {
+                    solver->set_guess(MATH::Vector(A.get_num_rows(), 0.0));
+                    auto start = std::chrono::steady_clock::now();
+                    x = solver->solve(maxIterations, tolerance);
+                    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                    if (r == 0 || elapsed < best) best = elapsed;
+                }
+            }
+            catch (const std::exception& e) {
+                std::cout << std::left << std::setw(26) << s.name << std::setw(10) << p.name << "failed: " << e.what() << std::endl;
+                continue;
+            }
+
+            // Same residual measure for every solver
+            MATH::Vector r = b - A * x;
+            double relativeResidual = r.getL2Norm() / b.getL2Norm();
+            // Sparse products only (2 flops per nonzero), vector updates and preconditioners are not counted
+            double gflops = 2.0 * nnz * s.productsPerIteration * solver->get_iterations() / best * 1.0e-9;
+
+            std::cout << std::left << std::setw(26) << s.name << std::setw(10) << p.name
+                      << std::right << std::fixed << std::setprecision(3) << std::setw(12) << best*1.0e3
+                      << std::setw(12) << solver->get_iterations()
+                      << std::scientific << std::setprecision(2) << std::setw(14) << relativeResidual
+                      << std::fixed << std::setw(10) << gflops << std::defaultfloat << std::endl;
+        }
+    }
+
+    return 0;
+}
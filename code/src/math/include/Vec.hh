@@ -0,0 +1,137 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      Vec.hh
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     header file for the fixed-size Vec class (coordinates, normals, velocities)
+**
+\*------------------------------------------------------------------------*/
+
+#ifndef _VEC_HH_
+#define _VEC_HH_
+
+#include <iostream>
+#include <vector>
+#include <cassert>
+#include <cmath>
+
+namespace MATH {
+
+/*------------------------------------------------------------------------*\
+**  Class Vec Declaration
+\*------------------------------------------------------------------------*/
+
+// Small vector stored inline (no heap allocation) with the same operator set as Vector
+//      N is the capacity; the size is the mesh dimension set at construction (size <= N),
+//      so a Vec<3> holds both 2D and 3D quantities. Unused components are kept at zero.
+template<int N>
+class Vec
+{
+    static_assert(N == 2 || N == 3, "Vec is only defined for 2 or 3 components");
+
+public:
+    // Constructors
+        Vec() : _data{}, _size(0) {}
+        Vec(const unsigned &size) : Vec(size, 0.0) {}
+        Vec(const unsigned &size, double value)
+        :
+            _size(size)
+        {
+            assert(size <= N && "Vec size exceeds its capacity");
+            for (int i=0 ; i<N ; i++) _data[i] = i < int(size) ? value : 0.0;
+        }
+        Vec(const std::vector<double> &vector)
+        :
+            Vec(vector.size())
+        {
+            for (unsigned i=0 ; i<_size ; i++) _data[i] = vector[i];
+        }
+
+    // Member Functions
+        unsigned size() const { return _size; }
+        // L2 norm
+        double getL2Norm() const { return std::sqrt((*this) * (*this)); }
+
+    // In-place updates
+        // this = this + alpha * x
+        Vec &axpy(double alpha, const Vec &x)
+        {
+            assert(_size == x._size && "vectors must have the same dimension");
+            for (int i=0 ; i<N ; i++) _data[i] += alpha * x._data[i];
+            return *this;
+        }
+        // this = alpha * this
+        Vec &scale(double alpha)
+        {
+            for (int i=0 ; i<N ; i++) _data[i] *= alpha;
+            return *this;
+        }
+
+    // Get methods
+        std::vector<double> get_vector() const { return std::vector<double>(_data, _data + _size); }
+
+    // Operator Overloading
+        const double &operator[](unsigned index) const { assert(index < _size && "Vec index out of range"); return _data[index]; }
+        double &operator[](unsigned index) { assert(index < _size && "Vec index out of range"); return _data[index]; }
+
+        Vec &operator+=(const Vec &other)
+        {
+            assert(_size == other._size && "vectors must have the same dimension");
+            for (int i=0 ; i<N ; i++) _data[i] += other._data[i];
+            return *this;
+        }
+        Vec &operator-=(const Vec &other)
+        {
+            assert(_size == other._size && "vectors must have the same dimension");
+            for (int i=0 ; i<N ; i++) _data[i] -= other._data[i];
+            return *this;
+        }
+        Vec &operator*=(double scaleFactor) { return scale(scaleFactor); }
+        Vec &operator/=(double divisor)
+        {
+            for (int i=0 ; i<N ; i++) _data[i] /= divisor;
+            return *this;
+        }
+
+        friend Vec operator+(Vec lhs, const Vec &rhs) { return lhs += rhs; }
+        friend Vec operator-(Vec lhs, const Vec &rhs) { return lhs -= rhs; }
+        friend Vec operator*(const double &scaleFactor, Vec vector) { return vector.scale(scaleFactor); }
+        friend Vec operator*(Vec vector, const double &scaleFactor) { return vector.scale(scaleFactor); }
+        friend Vec operator/(Vec vector, const double &divisor) { return vector /= divisor; }
+
+        // Dot product
+        double operator*(const Vec &other) const
+        {
+            assert(_size == other._size && "vectors must have the same dimension");
+            double dot = 0.0;
+            for (unsigned i=0 ; i<_size ; i++) dot += _data[i] * other._data[i];
+            return dot;
+        }
+
+        bool operator==(const Vec &other) const
+        {
+            if (_size != other._size) return false;
+            for (unsigned i=0 ; i<_size ; i++) {
+                if (_data[i] != other._data[i]) return false;
+            }
+            return true;
+        }
+
+        friend std::ostream &operator<<(std::ostream &out, const Vec &vector)
+        {
+            out << "( ";
+            for (unsigned i=0 ; i<vector._size ; i++) out << vector._data[i] << " ";
+            out << ")";
+            return out;
+        }
+
+private:
+    // Member Data
+        double _data[N];
+        unsigned _size;
+};
+
+}
+
+#endif  // _VEC_HH_
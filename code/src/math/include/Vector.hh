@@ -16,11 +16,14 @@
 #include <cassert>
 #include <cmath>
 
+#include "alignedAllocator.hh"
+
 namespace MATH {
 
 class Vector {
 public:
-  using VectorType = std::vector<double>;
+  // Cache-line aligned storage for the SIMD kernels
+  using VectorType = std::vector<double, alignedAllocator<double, vectorAlignment>>;
 
 public:
   Vector();
@@ -33,16 +36,34 @@ public:
   // Member functions
   Vector transpose();
   double getL2Norm() const;
+
+  // In-place updates (no temporaries)
+  Vector &axpy(double alpha, const Vector &x);
+  Vector &xpay(const Vector &x, double alpha);
+  Vector &axpby(double alpha, const Vector &x, double beta);
+  Vector &scale(double alpha);
   
   // Get methods
-  VectorType get_vector() const { return _vector; };
+  std::vector<double> get_vector() const { return std::vector<double>(_vector.begin(), _vector.end()); };
 
   // Operator Overloading
   const double &operator[](unsigned index) const;
   double &operator[](unsigned index);
 
-  Vector operator+(const Vector &other) const;
-  Vector operator-(const Vector &other) const;
+  friend Vector operator+(const Vector &lhs, const Vector &rhs);
+  friend Vector operator-(const Vector &lhs, const Vector &rhs);
+  // Temporaries are reused as the result (a*x + b*y needs no third vector)
+  friend Vector operator+(Vector &&lhs, const Vector &rhs);
+  friend Vector operator+(const Vector &lhs, Vector &&rhs);
+  friend Vector operator+(Vector &&lhs, Vector &&rhs);
+  friend Vector operator-(Vector &&lhs, const Vector &rhs);
+  friend Vector operator-(const Vector &lhs, Vector &&rhs);
+  friend Vector operator-(Vector &&lhs, Vector &&rhs);
+
+  Vector &operator+=(const Vector &other);
+  Vector &operator-=(const Vector &other);
+  Vector &operator*=(double scaleFactor);
+  Vector &operator/=(double divisor);
 
   // Vector &operator*(const double &scaleFactor);
   friend Vector operator*(const double &scaleFactor, Vector vector);
@@ -0,0 +1,61 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      alignedAllocator.hh
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     std::allocator replacement returning over-aligned storage
+**
+\*------------------------------------------------------------------------*/
+
+#ifndef _ALIGNEDALLOCATOR_HH_
+#define _ALIGNEDALLOCATOR_HH_
+
+#include <cstddef>
+#include <new>
+
+namespace MATH {
+
+// Alignment of the Vector storage: one cache line, which is also one AVX-512 register
+constexpr std::size_t vectorAlignment = 64;
+
+/*------------------------------------------------------------------------*\
+**  Class alignedAllocator Declaration
+\*------------------------------------------------------------------------*/
+
+template<typename T, std::size_t Alignment>
+class alignedAllocator
+{
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0, "Alignment must be a power of two");
+
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = alignedAllocator<U, Alignment>; };
+
+    // Constructors
+        alignedAllocator() noexcept = default;
+        template<typename U>
+        alignedAllocator(const alignedAllocator<U, Alignment>&) noexcept {}
+
+    // Member Functions
+        T* allocate(std::size_t n)
+        {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+        }
+        void deallocate(T* p, std::size_t) noexcept
+        {
+            ::operator delete(p, std::align_val_t(Alignment));
+        }
+
+    // Stateless: all instances are interchangeable
+        template<typename U>
+        bool operator==(const alignedAllocator<U, Alignment>&) const noexcept { return true; }
+        template<typename U>
+        bool operator!=(const alignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+}
+
+#endif // _ALIGNEDALLOCATOR_HH_
@@ -0,0 +1,48 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      cpuFeatures.hh
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     runtime detection of the SIMD instruction sets used by the MATH kernels
+**
+\*------------------------------------------------------------------------*/
+
+#ifndef _CPUFEATURES_HH_
+#define _CPUFEATURES_HH_
+
+// x86 intrinsics are only compiled on x86 targets, everything else uses the scalar kernels
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define LUNA_X86 1
+    #include <immintrin.h>
+#endif
+
+// GCC/Clang need a per-function target to emit AVX code without global -mavx flags
+//      (MSVC accepts intrinsics in any function)
+#if defined(__GNUC__) || defined(__clang__)
+    #define LUNA_TARGET(isa) __attribute__((target(isa)))
+#else
+    #define LUNA_TARGET(isa)
+#endif
+
+namespace MATH {
+
+// Instruction set levels with dedicated kernels (ordered)
+enum class simdLevel
+{
+    scalar = 0,
+    avx2 = 1,       // AVX2 + FMA
+    avx512 = 2      // AVX-512F
+};
+
+// Highest level supported by the CPU and operating system
+simdLevel get_supported_simd_level();
+
+// Level used by the kernels (defaults to the supported level)
+simdLevel get_simd_level();
+// Restrict the kernels to a lower level (clamped to the supported level), e.g. for testing
+void set_simd_level(simdLevel level);
+
+}
+
+#endif // _CPUFEATURES_HH_
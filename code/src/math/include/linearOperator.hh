@@ -0,0 +1,69 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      linearOperator.hh
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     header for matrix-free linear operators
+**
+\*------------------------------------------------------------------------*/
+
+#ifndef _LINEAROPERATOR_HH_
+#define _LINEAROPERATOR_HH_
+
+#include <concepts>
+
+#include "Vector.hh"
+
+namespace MATH {
+
+/*------------------------------------------------------------------------*\
+**  Concept solverOperator
+\*------------------------------------------------------------------------*/
+
+// What the linear solvers need from their system: its size and the product y = A x
+//      (satisfied by the assembled matrices and by linearOperator)
+template <class matrix>
+concept solverOperator = requires(const matrix& A, const Vector& x, Vector& y)
+{
+    { A.get_num_rows() } -> std::convertible_to<int>;
+    { A.get_num_columns() } -> std::convertible_to<int>;
+    A.multiply(x, y);
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class linearOperator Declaration
+\*------------------------------------------------------------------------*/
+
+// Matrix-free operator: A is only available through its action on a vector (no stored entries),
+//      the Krylov solvers and the Jacobi preconditioner accept it in place of an assembled matrix
+class linearOperator
+{
+public:
+    // Constructor
+        linearOperator(int num_rows, int num_columns) : _num_rows(num_rows), _num_columns(num_columns) {};
+    // Destructor
+        virtual ~linearOperator() = default;
+
+    // Member Functions
+        // y = A x into existing storage (y holds get_num_rows() entries)
+        virtual void multiply(const Vector& x, Vector& y) const = 0;
+        // Diagonal of A (Jacobi preconditioning, SIMPLE coefficients)
+        virtual Vector get_diagonal() const = 0;
+
+    // Get member functions
+        int get_num_rows() const { return _num_rows; };
+        int get_num_columns() const { return _num_columns; };
+
+    // Overloaded Operators
+        Vector operator*(const Vector& x) const { Vector y(_num_rows); multiply(x, y); return y; };
+
+protected:
+    int _num_rows;
+    int _num_columns;
+};
+
+}
+
+#endif // _LINEAROPERATOR_HH_
@@ -12,8 +12,12 @@
 #define _LINEARSOLVERS_HH_
 
 #include <vector>
+#include <memory>
+#include <type_traits>
 #include "sparseMatrix.hh"
 #include "Vector.hh"
+#include "preconditioners.hh"
+#include "linearOperator.hh"
 
 namespace MATH {
 
@@ -21,41 +25,77 @@ namespace MATH {
 **  Class linear_solver_base Declaration
 \*------------------------------------------------------------------------*/
 
-// Template for matrix class
+// Template for matrix class (an assembled matrix or a matrix-free linearOperator)
 template <class matrix>
 class linear_solver_base
 {
+    static_assert(solverOperator<matrix>, "linear solvers need get_num_rows(), get_num_columns() and multiply(x, y)");
 
 public:
     // Constructor
-        linear_solver_base() : _A(0,0), _b(0), _x(0) {}; // initialize A as empty matrix
+        linear_solver_base() : _x(0) {};
 
     // Member Functions
         void check_inputs();
         // Set all the relevent member data
-        void set_matrix(matrix A) { _A = A; };
-        void set_rhs(Vector b) { _b = b; };
-        void set_rhs(std::vector<double> b) { _b=Vector(b); };
+        //      The matrix and rhs are referenced, not copied (they must outlive the solves), so a
+        //      long-lived solver follows their updates. Temporaries are moved into the solver instead
+        //      (only for concrete matrices, an abstract linearOperator is always referenced).
+        void set_matrix(const matrix& A) { _A = &A; };
+        void set_matrix(matrix&& A) requires (!std::is_abstract_v<matrix>) { _ownedA = std::make_shared<const matrix>(std::move(A)); _A = _ownedA.get(); };
+        void set_rhs(const Vector& b) { _b = &b; };
+        void set_rhs(Vector&& b) { _ownedb = std::make_shared<const Vector>(std::move(b)); _b = _ownedb.get(); };
+        void set_rhs(std::vector<double> b) { set_rhs(Vector(b)); };
         // Set guess of solution (required)
         void set_guess(std::vector<double> x) { _x = Vector(x); x_has_been_set = true; };
-        void set_guess(Vector x) { _x = x; x_has_been_set = true; };
-        void set_guess() { _x = _b; x_has_been_set = true; };
-        // Solve the linear system
-        virtual Vector solve(unsigned maxIterations, double tolerance) = 0; // pure virtual function
+        void set_guess(const Vector& x) { _x = x; x_has_been_set = true; };
+        void set_guess() { _x = *_b; x_has_been_set = true; };
+        // Set preconditioner (kept across set_matrix calls, set up again at every solve)
+        void set_preconditioner(std::shared_ptr<preconditioner_base<matrix>> M) { _M = M; };
+        // Solve the linear system, the solution is kept in the solver until the next solve
+        virtual const Vector& solve(unsigned maxIterations, double tolerance) = 0; // pure virtual function
+        // Solve A x_k = b_k for a block of right-hand sides sharing the matrix, x[k] holds the guess on input
+        //      (one solve per right-hand side unless the solver sweeps them together)
+        virtual void solve_multiple(const std::vector<Vector>& b, std::vector<Vector>& x, unsigned maxIterations, double tolerance);
 
     // get member functions
-        matrix get_matrix() const { return _A; };
-        Vector get_rhs() const { return _b; };
+        const matrix& get_matrix() const { return *_A; };
+        const Vector& get_rhs() const { return *_b; };
         double get_residual() const { return _resid; };
         int get_iterations() const { return this->_iterations; };
+        std::shared_ptr<preconditioner_base<matrix>> get_preconditioner() const { return _M; };
+        // Residual and iterations of right-hand side k of the last solve_multiple
+        double get_residual(int k) const { return _residuals[k]; };
+        int get_iterations(int k) const { return _multipleIterations[k]; };
 
 protected:
+    // Member Functions
+        // Set up the preconditioner for the current matrix (if any)
+        void setup_preconditioner() { if (_M) _M->setup(*_A); };
+        // z = M^-1 r in place (identity without preconditioner), z is a workspace of the solver
+        void precondition(const Vector& r, Vector& z) const { reserve(z, r.size()); if (_M) _M->apply(r, z); else z = r; };
+        // ||A x - b|| of the current iterate (computed in the _r workspace)
+        double residual_norm() { reserve(_r, _x.size()); _A->multiply(_x, _r); _r.axpy(-1.0, *_b); return _r.getL2Norm(); };
+        // x = 0 for a zero rhs
+        const Vector& trivial_solution() { for (unsigned i = 0; i < _x.size(); i++) _x[i] = 0.0; return _x; };
+        // Size a workspace vector, allocates only when the system size changed
+        static void reserve(Vector& v, unsigned n) { if (v.size() != n) v = Vector(n); };
+
     // Member Data
-        matrix _A;
-        Vector _b;
+        std::shared_ptr<preconditioner_base<matrix>> _M;
+        const matrix* _A = nullptr;
+        const Vector* _b = nullptr;
+        // Storage of a matrix or rhs that was passed as a temporary
+        std::shared_ptr<const matrix> _ownedA;
+        std::shared_ptr<const Vector> _ownedb;
         Vector _x;
+        // Residual workspace
+        Vector _r;
         double _resid = 0.0;
-        int _iterations = 0;
+        // Counted in the type of the iteration limit (maxIterations)
+        unsigned _iterations = 0;
+        std::vector<double> _residuals;
+        std::vector<unsigned> _multipleIterations;
         bool x_has_been_set = false;
 };
 
@@ -75,12 +115,146 @@ public:
     gauss_seidel() : linear_solver_base<matrix>() {};
 
     // Member Functions
-        Vector solve(unsigned maxIterations, double tolerance) override;
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
+        // All right-hand sides are swept together, every matrix entry is read once per sweep
+        void solve_multiple(const std::vector<Vector>& b, std::vector<Vector>& x, unsigned maxIterations, double tolerance) override;
+
+private:
+    // Member Data
+        // Workspace of solve_multiple (interleaved rhs/iterates, per chunk sums), kept between solves
+        std::vector<double> _interleavedb;
+        std::vector<double> _interleavedx;
+        std::vector<double> _partialSums;
+        std::vector<double> _rowWork;
+        std::vector<char> _active;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class gauss_seidel<matrixBSR> Declaration
+\*------------------------------------------------------------------------*/
+
+// Block Gauss-Seidel: every sweep solves the B x B diagonal block system of each block row
+template <int B>
+class gauss_seidel<matrixBSR<B>>
+: 
+    public linear_solver_base<matrixBSR<B>>
+{
+
+public:
+    // Constructor
+    gauss_seidel() : linear_solver_base<matrixBSR<B>>() {};
+
+    // Member Functions
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
 
     // Member Data
 };
 
 
+/*------------------------------------------------------------------------*\
+**  Class sor Declaration
+\*------------------------------------------------------------------------*/
+
+// Successive over-relaxation, x_i += omega (b_i - A_i x) / a_ii
+//      The residual b_i - A_i x of every row is available while it is relaxed, the norm of these
+//      in-sweep residuals is the convergence monitor. Once it drops below the tolerance the true
+//      residual is computed to confirm, so no extra SpMV is spent on the iterations before.
+//      The sweeps work in place and allocate nothing.
+template <class matrix>
+class sor
+: 
+    public linear_solver_base<matrix>
+{
+
+public:
+    // Constructor
+    sor(double omega = 1.0) : linear_solver_base<matrix>(), _omega(omega) {};
+
+    // Member Functions
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
+
+    // Set member functions
+        // Relaxation factor, 0 < w < 2 (w = 1 is Gauss-Seidel)
+        void set_omega(double omega) { _omega = omega; };
+
+    // Get member functions
+        double get_omega() const { return _omega; };
+
+protected:
+    // Member Data
+        double _omega;
+        // Backward sweep after every forward sweep (SSOR)
+        bool _symmetric = false;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class ssor Declaration
+\*------------------------------------------------------------------------*/
+
+// Symmetric SOR, one forward and one backward sweep per iteration
+template <class matrix>
+class ssor
+: 
+    public sor<matrix>
+{
+
+public:
+    // Constructor
+    ssor(double omega = 1.0) : sor<matrix>(omega) { this->_symmetric = true; };
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class multicolor_gauss_seidel Declaration
+\*------------------------------------------------------------------------*/
+
+// Gauss-Seidel sweeping the rows color by color (coloring of the sparsity pattern),
+//      rows of one color are independent and relaxed in parallel
+template <class matrix>
+class multicolor_gauss_seidel
+: 
+    public linear_solver_base<matrix>
+{
+
+public:
+    // Constructor
+    multicolor_gauss_seidel() : linear_solver_base<matrix>() {};
+
+    // Member Functions
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
+
+    // Member Data
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class jacobi Declaration
+\*------------------------------------------------------------------------*/
+
+// (Block) Jacobi: x += omega * D^-1 (b - A x), D is the scalar or block diagonal
+template <class matrix>
+class jacobi 
+: 
+    public linear_solver_base<matrix>
+{
+
+public:
+    // Constructor
+    jacobi() : linear_solver_base<matrix>() {};
+
+    // Member Functions
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
+        // Set relaxation factor (1 = plain Jacobi)
+        void set_weight(double omega) { _omega = omega; };
+
+    // Member Data
+private:
+        double _omega = 1.0;
+};
+
+
 /*------------------------------------------------------------------------*\
 **  Class conjugate_gradient Declaration
 \*------------------------------------------------------------------------*/
@@ -96,12 +270,312 @@ public:
     conjugate_gradient() : linear_solver_base<matrix>() {};
 
     // Member Functions
-        Vector solve(unsigned maxIterations, double tolerance) override;
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
+
+private:
+    // Member Data
+        // Krylov workspace (search direction, A p, preconditioned residual)
+        Vector _p;
+        Vector _q;
+        Vector _z;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class deflated_conjugate_gradient Declaration
+\*------------------------------------------------------------------------*/
+
+// Deflated (preconditioned) CG for sequences of slowly changing SPD systems (Saad, Yeung, Erhel, Guyomarc'h 2000):
+//      search directions are kept A-orthogonal to a small deflation space W, which starts the solve with the
+//      Galerkin solution on W and removes its modes from the iteration. W is refreshed on the first solve, every
+//      few solves and when the iteration count rises: the CG coefficients of that solve give its Lanczos matrix,
+//      a restarted window of Lanczos vectors keeps the Ritz vectors of the smallest eigenvalues (eigCG, Stathopoulos
+//      and Orginos 2010), and a Rayleigh-Ritz step on span{W, Ritz vectors} gives the next W. Refreshing needs no
+//      products with A beyond those of the solve, the other solves only pay for A W and the deflation itself.
+//      The deflation reads W and A W once per iteration (2k vectors), so it only saves time when an iteration
+//      is expensive compared to that (IC0, AMG); with Jacobi on a 5-point stencil plain CG is as fast.
+template <class matrix>
+class deflated_conjugate_gradient
+: 
+    public linear_solver_base<matrix>
+{
+
+public:
+    // Constructor
+    deflated_conjugate_gradient(int deflationSize = 4) : linear_solver_base<matrix>(), _deflationSize(deflationSize) {};
+
+    // Member Functions
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
+        // Forget the recycled space (e.g. after the mesh changed), the next solve builds it again
+        void clear_deflation() { _W.clear(); };
+
+    // Set member functions
+        // Number of recycled vectors (0 gives plain CG)
+        void set_deflation_size(int deflationSize) { _deflationSize = deflationSize; };
+        // Solves between refreshes of W (0 only refreshes when the iterations rise)
+        void set_refresh_interval(int solves) { _refreshInterval = solves; };
+
+    // Get member functions
+        int get_deflation_size() const { return _deflationSize; };
+        int get_refresh_interval() const { return _refreshInterval; };
+        // Number of solves that refreshed W
+        int get_refreshes() const { return _refreshes; };
+        // Current deflation space (empty before the first solve)
+        const std::vector<Vector>& get_deflation_vectors() const { return _W; };
+
+private:
+    // Member Functions
+        // mu = (W^T A W)^-1 (A W)^T z and r^T z in one pass over the vectors
+        double project(const Vector& r, const Vector& z);
+        // z = z - W mu (the deflated preconditioned residual) and p = z + beta p in one pass
+        void update_direction(double beta);
+        // Add the Lanczos vector z / sqrt(rz) to the window, coupled to the previous one by offdiagonal
+        void lanczos_append(const Vector& z, double rz, double offdiagonal);
+        // Compress a full window to the Ritz vectors of the smallest eigenvalues of T and of T without its last row
+        void lanczos_restart();
+        // Rayleigh-Ritz on span{W, Ritz vectors of the window} gives the next W
+        void update_deflation_space();
 
     // Member Data
+        int _deflationSize;
+        int _refreshInterval = 10;
+        int _refreshes = 0;
+        int _solvesSinceRefresh = 0;
+        // Iterations of the first solve after a refresh, later solves refresh again when they need more
+        int _referenceIterations = 0;
+        bool _refreshPending = false;
+        // Deflation space and A W of the current matrix
+        std::vector<Vector> _W;
+        std::vector<Vector> _AW;
+        // W and A W packed row by row (row-major, n x k) so that project() and update_direction() read each one in a single pass
+        std::vector<double> _packedW;
+        std::vector<double> _packedAW;
+        // Per-block partial sums of (A W)^T z and r^T z
+        std::vector<double> _blockSums;
+        // Galerkin matrix W^T A W and its Cholesky factor (row-major, size k x k)
+        std::vector<double> _galerkin;
+        std::vector<double> _WAW;
+        std::vector<double> _mu;
+        // Lanczos window of a refreshing solve: vectors (column-major, n x window), projected matrix T (window x window),
+        //      coupling of the next vector to the window, columns in use and columns with a known diagonal of T
+        std::vector<double> _lanczosVectors;
+        std::vector<double> _lanczosMatrix;
+        std::vector<double> _lanczosCoupling;
+        int _lanczosWindow = 0;
+        int _lanczosSize = 0;
+        int _lanczosKnown = 0;
+        // Krylov workspace (search direction, A p, preconditioned residual)
+        Vector _p;
+        Vector _q;
+        Vector _z;
 };
 
 
+
+/*------------------------------------------------------------------------*\
+**  Class chebyshev Declaration
+\*------------------------------------------------------------------------*/
+
+// Preconditioned Chebyshev iteration for SPD systems (Saad, Iterative Methods, Alg. 12.1):
+//      the iterates only need matrix-vector products and preconditioner applications, the residual
+//      norm is the single reduction and is only taken every few iterations. The extreme eigenvalues
+//      of M^-1 A come from the Lanczos tridiagonal of a few PCG steps (which also improve the iterate)
+//      and are kept between solves, so a long-lived solver estimates them once every few systems.
+template <class matrix>
+class chebyshev
+: 
+    public linear_solver_base<matrix>
+{
+
+public:
+    // Constructor
+    chebyshev(int lanczosSteps = 20) : linear_solver_base<matrix>(), _lanczosSteps(lanczosSteps) {};
+
+    // Member Functions
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
+        // Estimate the eigenvalues again at the next solve (e.g. after the matrix changed a lot)
+        void clear_eigenvalue_estimates() { _estimated = false; };
+
+    // Set member functions
+        // PCG steps of an eigenvalue estimate
+        void set_lanczos_steps(int steps) { _lanczosSteps = steps; };
+        // Solves between estimates (0 keeps the first estimate)
+        void set_estimate_interval(int solves) { _estimateInterval = solves; };
+        // Iterations between residual norm checks
+        void set_check_interval(int iterations) { _checkInterval = iterations; };
+        // Bounds of the spectrum of M^-1 A, no periodic estimates (a stalling solve still widens them)
+        void set_eigenvalue_bounds(double lambdaMin, double lambdaMax) { _lambdaMin = lambdaMin; _lambdaMax = lambdaMax; _estimated = true; _estimateInterval = 0; };
+
+    // Get member functions
+        double get_min_eigenvalue() const { return _lambdaMin; };
+        double get_max_eigenvalue() const { return _lambdaMax; };
+        // Number of eigenvalue estimates since construction
+        int get_estimates() const { return _estimates; };
+
+private:
+    // Member Functions
+        // Lanczos estimate of the extreme eigenvalues from PCG steps on the current residual (widen keeps
+        //      the union with the cached interval), returns true if the PCG steps already met the tolerance.
+        //      Throws std::runtime_error if M^-1 A is not positive definite (no positive step at all).
+        bool estimate_eigenvalues(unsigned maxIterations, double tolerance, bool widen);
+
+    // Member Data
+        int _lanczosSteps;
+        int _estimateInterval = 20;
+        int _checkInterval = 10;
+        // Cached bounds of the spectrum of M^-1 A
+        double _lambdaMin = 0.0;
+        double _lambdaMax = 0.0;
+        bool _estimated = false;
+        int _estimates = 0;
+        int _solvesSinceEstimate = 0;
+        // Workspace (update direction, A d, preconditioned residual)
+        Vector _d;
+        Vector _q;
+        Vector _z;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class bicgstab Declaration
+\*------------------------------------------------------------------------*/
+
+// Stabilized bi-conjugate gradient (van der Vorst) for non-symmetric systems, right preconditioned
+template <class matrix>
+class bicgstab
+: 
+    public linear_solver_base<matrix>
+{
+
+public:
+    // Constructor
+    bicgstab() : linear_solver_base<matrix>() {};
+
+    // Member Functions
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
+
+private:
+    // Member Data
+        // Krylov workspace
+        Vector _r_hat;
+        Vector _p;
+        Vector _v;
+        Vector _p_hat;
+        Vector _s;
+        Vector _s_hat;
+        Vector _t;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class gmres Declaration
+\*------------------------------------------------------------------------*/
+
+// Restarted GMRES(m) with modified Gram-Schmidt and Givens rotations, right preconditioned
+//      (the residual checked against the tolerance is the true residual b - A x)
+template <class matrix>
+class gmres
+: 
+    public linear_solver_base<matrix>
+{
+
+public:
+    // Constructor
+    gmres(int restart = 30) : linear_solver_base<matrix>(), _restart(restart) {};
+
+    // Member Functions
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
+        // Krylov basis size before restarting
+        void set_restart(int restart) { _restart = restart; };
+
+    // Get member functions
+        int get_restart() const { return _restart; };
+
+    // Member Data
+private:
+        int _restart;
+        // Krylov basis, Hessenberg matrix, Givens rotations and work vectors
+        std::vector<Vector> _V;
+        std::vector<std::vector<double>> _H;
+        std::vector<double> _cs;
+        std::vector<double> _sn;
+        std::vector<double> _g;
+        std::vector<double> _y;
+        Vector _w;
+        Vector _z;
+        Vector _update;
+};
+
+
+// Solvers selectable per linear system
+enum class linearSolverType
+{
+    gauss_seidel,
+    jacobi,
+    conjugate_gradient,
+    bicgstab,
+    gmres,
+    multicolor_gauss_seidel,
+    sor,
+    ssor,
+    mixed_precision,    // iterative refinement around a single precision BiCGSTAB
+    deflated_conjugate_gradient,    // CG recycling a deflation space between solves
+    chebyshev,                      // Chebyshev iteration with cached Lanczos eigenvalue estimates
+    direct_cholesky,                // sparse Cholesky (sparseDirect.hh), symbolic phase kept while the pattern is fixed
+    direct_lu                       // sparse LU without pivoting (sparseDirect.hh)
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class mixed_precision_refinement Declaration
+\*------------------------------------------------------------------------*/
+
+// Iterative refinement with a single precision inner solver: the inner Krylov solver works on a
+//      matrixCSRFloat copy of A, while the residual b - A x is computed and the correction added
+//      in double. The tolerance is checked on the double precision residual, so the converged
+//      solution meets the same tolerance as a double precision solve.
+//      The preconditioner (if any) is set up on the double matrix and used by the inner solver.
+template <class matrix>
+class mixed_precision_refinement
+: 
+    public linear_solver_base<matrix>
+{
+
+public:
+    // Constructor
+        // Inner solver: conjugate_gradient, bicgstab or gmres
+        mixed_precision_refinement(linearSolverType innerSolver = linearSolverType::conjugate_gradient);
+
+    // Member Functions
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
+
+    // Set member functions
+        // Residual reduction asked from every inner solve (relative to the current outer residual)
+        void set_inner_reduction(double reduction) { _innerReduction = reduction; };
+
+    // Get member functions
+        double get_inner_reduction() const { return _innerReduction; };
+        // Outer (double precision) corrections of the last solve, get_iterations() counts inner iterations
+        int get_refinements() const { return _refinements; };
+        const matrixCSRFloat& get_float_matrix() const { return _Af; };
+
+private:
+    // Member Data
+        std::unique_ptr<linear_solver_base<matrixCSRFloat>> _inner;
+        double _innerReduction = 1.0e-3;
+        int _refinements = 0;
+        // Single precision copy of A, refreshed at every solve
+        matrixCSRFloat _Af{0,0};
+        // Correction of one refinement step (starts at zero)
+        Vector _correction;
+};
+
+
+// * * * * * * * * * * * * * *  make_linear_solver * * * * * * * * * * * * * * * //
+// New solver of the given type with default settings
+template <class matrix>
+std::unique_ptr<linear_solver_base<matrix>> make_linear_solver(linearSolverType type);
+
 }
 
 #endif // _LINEARSOLVERS_HH_
\ No newline at end of file
@@ -0,0 +1,34 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      matrixMarket.hh
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     Matrix Market (.mtx) reading and writing of sparse matrices and vectors
+**
+\*------------------------------------------------------------------------*/
+
+#ifndef _MATRIXMARKET_HH_
+#define _MATRIXMARKET_HH_
+
+#include <filesystem>
+
+#include "sparseMatrix.hh"
+#include "Vector.hh"
+
+namespace MATH {
+
+// Write a matrix as "coordinate real general" (stored entries only, 1-based, full double precision)
+void write_matrix_market(const std::filesystem::path& file, const matrixCSR& A);
+// Write a vector as "array real general" (one column)
+void write_matrix_market(const std::filesystem::path& file, const Vector& v);
+
+// Read a "coordinate" matrix (real or integer, general or symmetric, duplicates are summed)
+//      throws std::runtime_error on files that cannot be read or are not in a supported format
+matrixCSR read_matrix_market_matrix(const std::filesystem::path& file);
+// Read a vector stored as a one column "array" or "coordinate" matrix
+Vector read_matrix_market_vector(const std::filesystem::path& file);
+
+}
+
+#endif // _MATRIXMARKET_HH_
@@ -0,0 +1,255 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      preconditioners.hh
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     header for preconditioners used by the Krylov solvers
+**
+\*------------------------------------------------------------------------*/
+
+#ifndef _PRECONDITIONERS_HH_
+#define _PRECONDITIONERS_HH_
+
+#include <vector>
+#include <memory>
+#include "sparseMatrix.hh"
+#include "Vector.hh"
+#include "linearOperator.hh"
+
+namespace MATH {
+
+// CSR storage behind a matrix type (preconditioners are built from the CSR data)
+inline const matrixCSR& as_CSR(const matrixCSR& A) { return A; };
+inline const matrixCSR& as_CSR(const matrixAutotuned& A) { return A.get_CSR(); };
+
+
+/*------------------------------------------------------------------------*\
+**  Class preconditioner_base Declaration
+\*------------------------------------------------------------------------*/
+
+// Approximate inverse M^-1 of a system matrix
+template <class matrix>
+class preconditioner_base
+{
+
+public:
+    // Destructor
+        virtual ~preconditioner_base() = default;
+
+    // Member Functions
+        // Build (or refresh) the preconditioner for A, called by the solver before every solve
+        virtual void setup(const matrix& A) = 0;
+        // z = M^-1 r, written into z (sized like r by the caller, must not alias r)
+        virtual void apply(const Vector& r, Vector& z) const = 0;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class jacobi_preconditioner Declaration
+\*------------------------------------------------------------------------*/
+
+// M = D (also for a matrix-free linearOperator, through its get_diagonal())
+template <class matrix>
+class jacobi_preconditioner
+:
+    public preconditioner_base<matrix>
+{
+
+public:
+    // Constructor
+    jacobi_preconditioner() {};
+
+    // Member Functions
+        void setup(const matrix& A) override;
+        void apply(const Vector& r, Vector& z) const override;
+
+private:
+    // Member Data
+        std::vector<double> _inverseDiagonal;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class ic0_preconditioner Declaration
+\*------------------------------------------------------------------------*/
+
+// Incomplete Cholesky without fill-in, M = L L^T with L on the lower triangular pattern of A (SPD matrices)
+//      The pattern of L is kept while A keeps its sparsity pattern, later setups only refactor.
+//      Pivots that break down (e.g. the constant null space of a pressure correction) are replaced by a_ii.
+template <class matrix>
+class ic0_preconditioner
+:
+    public preconditioner_base<matrix>
+{
+
+public:
+    // Constructor
+    ic0_preconditioner() {};
+
+    // Member Functions
+        void setup(const matrix& A) override;
+        void apply(const Vector& r, Vector& z) const override;
+
+    // Get member functions
+        const matrixCSR& get_factor() const { return _L; };
+
+private:
+    // Member Data
+        // Pattern of A the factor was built for
+        std::shared_ptr<sparsityPattern> _pattern;
+        // Lower triangular factor (diagonal is the last entry of every row)
+        matrixCSR _L{0,0};
+        // Slot of A every entry of L is taken from
+        std::vector<int> _sourceSlots;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class ssor_preconditioner Declaration
+\*------------------------------------------------------------------------*/
+
+// Symmetric SOR, M = w/(2-w) (D/w + L) (D/w)^-1 (D/w + U), one forward and one backward sweep
+template <class matrix>
+class ssor_preconditioner
+:
+    public preconditioner_base<matrix>
+{
+
+public:
+    // Constructor
+    ssor_preconditioner(double omega = 1.0) : _omega(omega) {};
+
+    // Member Functions
+        // Only references A (the solver keeps it alive), nothing is copied per solve
+        void setup(const matrix& A) override { _A = &as_CSR(A); };
+        void apply(const Vector& r, Vector& z) const override;
+
+    // Set member functions
+        // Relaxation factor, 0 < w < 2 (w = 1 is symmetric Gauss-Seidel)
+        void set_omega(double omega) { _omega = omega; };
+
+private:
+    // Member Data
+        const matrixCSR* _A = nullptr;
+        double _omega;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class amg_preconditioner Declaration
+\*------------------------------------------------------------------------*/
+
+// Smoothers available on the AMG levels
+enum class amgSmoother
+{
+    jacobi,         // weighted Jacobi
+    gauss_seidel,   // forward sweeps before, backward sweeps after the coarse correction (symmetric)
+    multicolor_gauss_seidel, // as gauss_seidel, sweeping the colors of each level in parallel
+    chebyshev       // Jacobi preconditioned Chebyshev polynomial, only matrix-vector products (no inner products)
+};
+
+// Smoothed aggregation AMG, applied as one V-cycle
+//      Setup: strength graph -> aggregates -> tentative prolongator T -> P = (I - w D^-1 A) T
+//             -> Galerkin product A_c = P^T A P, repeated until the coarse size is reached.
+//      The aggregates and the sparsity patterns of all levels are kept while the fine matrix keeps
+//      its sparsity pattern, later setups only recompute the values (numeric phase).
+template <class matrix>
+class amg_preconditioner
+:
+    public preconditioner_base<matrix>
+{
+
+public:
+    // Constructor
+    amg_preconditioner() {};
+
+    // Member Functions
+        void setup(const matrix& A) override;
+        void apply(const Vector& r, Vector& z) const override;
+
+    // Set member functions
+        void set_smoother(amgSmoother smoother) { _smoother = smoother; };
+        void set_sweeps(int sweeps) { _sweeps = sweeps; };
+        void set_jacobi_weight(double omega) { _jacobiWeight = omega; };
+        // Polynomial degree of every Chebyshev smoothing step (per sweep)
+        void set_chebyshev_degree(int degree) { _chebyshevDegree = degree; };
+        // Connections with |a_ij| >= theta*sqrt(|a_ii a_jj|) are strong
+        void set_strength_threshold(double theta) { _theta = theta; _levels.clear(); };
+        void set_max_levels(int levels) { _maxLevels = levels; _levels.clear(); };
+        void set_coarse_size(int size) { _coarseSize = size; _levels.clear(); };
+
+    // Get member functions
+        int get_num_levels() const { return _levels.size(); };
+        int get_level_size(int level) const { return _levels[level].A.get_num_rows(); };
+        // Number of times the full (symbolic) setup was run
+        int get_symbolic_setups() const { return _symbolicSetups; };
+
+private:
+    // Level of the hierarchy (the last level only uses A)
+    struct level
+    {
+        matrixCSR A{0,0};
+        matrixCSR T{0,0};           // tentative prolongator
+        matrixCSR P{0,0};           // smoothed prolongator
+        matrixCSR R{0,0};           // restriction P^T
+        matrixCSR AP{0,0};          // A*P (kept for the numeric Galerkin product)
+        std::vector<int> R_sources; // slot of P each entry of R comes from
+        std::vector<int> T_slots;   // slot of T_ij inside P for every row
+        std::vector<double> inverseDiagonal;
+        double spectralRadius = 0.0;    // Gershgorin bound of rho(D^-1 A)
+        // V-cycle workspace, sized in numeric_setup so apply does not allocate
+        //      (rhs/x hold the restricted residual and correction of the coarser levels)
+        mutable Vector rhs;
+        mutable Vector x;
+        mutable Vector residual;
+        mutable Vector correction;
+        mutable Vector smootherWork;
+    };
+
+    // Member Functions
+        // Aggregation and all sparsity patterns
+        void symbolic_setup(const matrixCSR& A);
+        // Values of P, R and the coarse matrices for the current fine values
+        void numeric_setup(const matrixCSR& A);
+        // Dense LU of the coarsest matrix
+        void factor_coarse();
+        void solve_coarse(const Vector& b, Vector& x) const;
+        void smooth(int l, Vector& x, const Vector& b, bool pre) const;
+        void cycle(int l, const Vector& b, Vector& x) const;
+
+    // Member Data
+        std::vector<level> _levels;
+        std::vector<double> _coarseLU;
+        std::vector<int> _coarsePivots;
+        std::vector<bool> _coarseSingular;
+        amgSmoother _smoother = amgSmoother::gauss_seidel;
+        int _sweeps = 1;
+        double _jacobiWeight = 2.0/3.0;
+        int _chebyshevDegree = 3;
+        double _theta = 0.08;
+        int _maxLevels = 10;
+        int _coarseSize = 100;
+        int _symbolicSetups = 0;
+};
+
+
+
+// * * * * * * * * * * * * * *  make_preconditioner * * * * * * * * * * * * * * * //
+// Preconditioners selectable per linear system
+enum class preconditionerType
+{
+    none,
+    jacobi,
+    ic0,
+    ssor,
+    amg
+};
+
+// New preconditioner of the given type with default settings (nullptr for none)
+template <class matrix>
+std::shared_ptr<preconditioner_base<matrix>> make_preconditioner(preconditionerType type);
+
+}
+
+#endif // _PRECONDITIONERS_HH_
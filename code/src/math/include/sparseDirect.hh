@@ -0,0 +1,126 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      sparseDirect.hh
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     header for sparse direct (Cholesky / LU) solvers
+**
+\*------------------------------------------------------------------------*/
+
+#ifndef _SPARSEDIRECT_HH_
+#define _SPARSEDIRECT_HH_
+
+#include <vector>
+#include <memory>
+#include "linearSolvers.hh"
+
+namespace MATH {
+
+// Factorizations of the sparse direct solver
+enum class directFactorization
+{
+    cholesky,   // A = L L^T for SPD matrices (only the lower triangle of A is read)
+    lu          // A = L U without pivoting on the symmetrized pattern (diagonally dominant matrices)
+};
+
+/*------------------------------------------------------------------------*\
+**  Ordering functions
+\*------------------------------------------------------------------------*/
+
+// Approximate minimum degree ordering of the graph of A + A^T (Amestoy, Davis, Duff 1996), on the quotient
+//      graph with element absorption, approximate external degrees kept in degree buckets (no supervariables)
+//      returns the old index of every new position: order[new] = old
+std::vector<int> approximate_minimum_degree(const matrixCSR& A);
+
+
+/*------------------------------------------------------------------------*\
+**  Class sparse_direct Declaration
+\*------------------------------------------------------------------------*/
+
+// Sparse direct solver, split in the usual phases:
+//      Symbolic: AMD ordering, elimination tree and the row patterns of L (run again only when the
+//                sparsity pattern of A changes, so a long-lived solver keeps it across outer iterations)
+//      Numeric:  up-looking factorization on the known pattern, redone at every solve
+//      Solve:    triangular solves, followed by iterative refinement while the residual is above the tolerance
+//      Zero pivots (e.g. the pure Neumann pressure correction) pin their unknown, the solution is then
+//      made orthogonal to the resulting null vectors like the CG solution from a zero guess.
+//      Preconditioners are ignored, get_iterations() counts the solves with the factors.
+//      The factor grows faster than n, so a refactorization only beats AMG-CG on small meshes
+//      (around 10k cells for a 2D 5-point stencil); larger pressure systems should stay iterative.
+template <class matrix>
+class sparse_direct
+:
+    public linear_solver_base<matrix>
+{
+
+public:
+    // Constructor
+    sparse_direct(directFactorization factorization = directFactorization::cholesky) : linear_solver_base<matrix>(), _factorization(factorization) {};
+
+    // Member Functions
+        const Vector& solve(unsigned maxIterations, double tolerance) override;
+        // All right-hand sides share one numeric factorization
+        void solve_multiple(const std::vector<Vector>& b, std::vector<Vector>& x, unsigned maxIterations, double tolerance) override;
+        // Run the symbolic phase again at the next solve
+        void clear_symbolic() { _pattern.reset(); };
+
+    // Get member functions
+        directFactorization get_factorization() const { return _factorization; };
+        // Number of times the symbolic / numeric phase was run
+        int get_symbolic_factorizations() const { return _symbolicFactorizations; };
+        int get_numeric_factorizations() const { return _numericFactorizations; };
+        // Entries of L (strictly lower part), the fill of the ordering
+        int get_factor_nonzeros() const { return _LColumns.size(); };
+        // Number of zero pivots of the last factorization (dimension of the null space found)
+        int get_zero_pivots() const { return _nullVectors.size(); };
+        const std::vector<int>& get_ordering() const { return _order; };
+
+private:
+    // Member Functions
+        void symbolic_factorization(const matrixCSR& A);
+        void numeric_factorization(const matrixCSR& A);
+        // Numeric factorization of A, after the symbolic phase if its pattern changed
+        void factor(const matrixCSR& A);
+        // x = A^-1 b with the factors, in the original numbering
+        void solve_factored(const Vector& b, Vector& x);
+        // Solve the current rhs into _x with the factors, refined while the residual is above the tolerance
+        void solve_refined(unsigned maxIterations, double tolerance);
+
+    // Member Data
+        directFactorization _factorization;
+        int _symbolicFactorizations = 0;
+        int _numericFactorizations = 0;
+        // Pattern of A the symbolic phase was run for
+        std::shared_ptr<sparsityPattern> _pattern;
+        int _patternNonzeros = 0;
+        // Fill-reducing ordering (order[new] = old) and its inverse
+        std::vector<int> _order;
+        std::vector<int> _inverseOrder;
+        // Rows of the strictly lower part of L (columns ascending), the rows of U^T share the pattern
+        std::vector<int> _LRows;
+        std::vector<int> _LColumns;
+        std::vector<double> _L;
+        std::vector<double> _Ut;
+        std::vector<double> _diagonal;
+        std::vector<bool> _zeroPivot;
+        // Slots of A scattered into every permuted row: lower part (columns <= i) and upper part
+        //      (rows < i of column i), with their permuted column / row
+        std::vector<int> _lowerOffsets;
+        std::vector<int> _lowerSlots;
+        std::vector<int> _lowerIndices;
+        std::vector<int> _upperOffsets;
+        std::vector<int> _upperSlots;
+        std::vector<int> _upperIndices;
+        // Null vectors of the pinned zero pivots (original numbering, unit norm)
+        std::vector<Vector> _nullVectors;
+        // Workspace (permuted rhs / solution, dense rows of the numeric phase)
+        std::vector<double> _y;
+        std::vector<double> _rowL;
+        std::vector<double> _rowU;
+        Vector _correction;
+};
+
+}
+
+#endif // _SPARSEDIRECT_HH_
@@ -12,10 +12,14 @@
 #define _SPARSEMATRIX_HH_
 
 #include <vector>
+#include <memory>
 #include "Vector.hh"
 
 namespace MATH {
 
+// Forward declarations
+class matrixCOO;
+
 class sparseMatrixBase
 {
 public:
@@ -32,6 +36,8 @@ public:
 
     // pure virtual operator
         virtual Vector operator*(const Vector& rhs) const = 0;
+        // y = A x into existing storage (y holds get_num_rows() entries), no allocation for the CSR and BSR formats
+        virtual void multiply(const Vector& x, Vector& y) const = 0;
 
     // Operator to print matrix
         friend std::ostream& operator<<(std::ostream& os, const sparseMatrixBase& matrix);
@@ -41,6 +47,97 @@ protected:
     int _num_columns;
 };
 
+/*------------------------------------------------------------------------*\
+**  Class sparsityPattern Declaration
+\*------------------------------------------------------------------------*/
+
+// CSR index structure (row offsets + column indices, columns sorted within each row)
+//      Matrices with identical nonzero layout share one pattern and only own their values
+class sparsityPattern
+{
+public:
+    // friend declarations
+    friend class matrixCSR;
+    friend class matrixCOO;
+    template <int B>
+    friend class matrixBSR;
+
+public:
+    // Constructor
+        sparsityPattern(int num_rows, int num_columns)
+            : _num_rows(num_rows), _num_columns(num_columns)
+        {_row_indices.resize(_num_rows+1,0); _diagonal_positions.resize(_num_rows,-1);};
+        // Pattern from CSR index arrays (columns must be sorted within each row)
+        sparsityPattern(int num_rows, int num_columns, std::vector<int> row_indices, std::vector<int> column_indices);
+
+    // Member Functions
+        // Storage slot of entry (i,j), -1 if the entry is not part of the pattern (binary search)
+        int find(int i, int j) const;
+
+    // Get member functions
+        int get_num_rows() const { return _num_rows; };
+        int get_num_columns() const { return _num_columns; };
+        int get_nnz() const { return _column_indices.size(); };
+        const std::vector<int>& get_row_indices() const { return _row_indices; };
+        const std::vector<int>& get_column_indices() const { return _column_indices; };
+        // Storage slot of each row's diagonal entry (-1 if not stored)
+        const std::vector<int>& get_diagonal_positions() const { return _diagonal_positions; };
+        // Row bounds splitting the nonzeros evenly over num_parts threads (cached until the structure changes)
+        const std::vector<int>& get_row_partition(int num_parts) const;
+        // Greedy multicoloring of the rows: no two rows of one color are coupled through an entry (i,j) or (j,i),
+        //      rows of color c are get_color_rows()[offsets[c]] ... [offsets[c+1]-1] (cached until the structure changes)
+        const std::vector<int>& get_color_offsets() const;
+        const std::vector<int>& get_color_rows() const;
+
+private:
+    // Member Functions
+        void build_coloring() const;
+        // Add entry (i,j) to the structure, returns its storage slot (owners must insert their values there)
+        int insert(int i, int j);
+        // Remove the entry of row i stored at slot index (owners must erase their values there)
+        void erase(int i, int index);
+
+    // Member Data
+    int _num_rows;
+    int _num_columns;
+    std::vector<int> _row_indices;
+    std::vector<int> _column_indices;
+    std::vector<int> _diagonal_positions;
+    // Cached row partition and the thread count it was built for (0 = not built)
+    mutable std::vector<int> _row_partition;
+    mutable int _row_partition_parts = 0;
+    // Cached coloring (empty = not built)
+    mutable std::vector<int> _color_offsets;
+    mutable std::vector<int> _color_rows;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class diagonalView Declaration
+\*------------------------------------------------------------------------*/
+
+// Read-only view of a matrix diagonal through the cached diagonal positions
+//      NOTE: only valid while the matrix is alive and its nonzero structure is unchanged
+class diagonalView
+{
+public:
+    // Constructor
+        diagonalView(const std::vector<double>& values, const std::vector<int>& positions)
+            : _values(values), _positions(positions) {};
+
+    // Operator Overloading
+        double operator[](int i) const { return _positions[i] < 0 ? 0.0 : _values[_positions[i]]; };
+
+    // Get member functions
+        int size() const { return _positions.size(); };
+
+private:
+    // Member Data
+    const std::vector<double>& _values;
+    const std::vector<int>& _positions;
+};
+
+
 /*------------------------------------------------------------------------*\
 **  Class matrixCSR Declaration
 \*------------------------------------------------------------------------*/
@@ -53,28 +150,337 @@ public:
     // friend declarations
     template <class T>
     friend class gauss_seidel;
+    friend class matrixCOO;
 
 public:
     // Constructor
+        // Empty matrix with its own pattern
         matrixCSR(int num_rows, int num_columns)
-            : sparseMatrixBase(num_rows, num_columns) 
-        {_row_indices.resize(_num_rows+1,0.0);};
+            : sparseMatrixBase(num_rows, num_columns),
+              _pattern(std::make_shared<sparsityPattern>(num_rows, num_columns)) {};
+        // Zero matrix on an existing (shared) pattern
+        explicit matrixCSR(std::shared_ptr<sparsityPattern> pattern)
+            : sparseMatrixBase(pattern->get_num_rows(), pattern->get_num_columns()),
+              _pattern(pattern),
+              _values(pattern->get_nnz(), 0.0) {};
 
     // Member Functions
         double get_value(int i, int j) const override;
         void set_value(int i, int j, double value) override;
 
+    // Get member functions
+        // Shared index structure
+        std::shared_ptr<sparsityPattern> get_pattern() const { return _pattern; };
+        const std::vector<int>& get_row_indices() const { return _pattern->_row_indices; };
+        const std::vector<int>& get_column_indices() const { return _pattern->_column_indices; };
+        // Diagonal entries (direct loads, no row search)
+        diagonalView diagonal() const { return diagonalView(_values, _pattern->_diagonal_positions); };
+        double get_diagonal(int i) const { return diagonal()[i]; };
+        // Stored values in pattern order (can be overwritten in place without changing the structure)
+        const std::vector<double>& get_values() const { return _values; };
+        std::vector<double>& get_values() { return _values; };
+
+    // Member Functions
+        // Apply the inverse diagonal, D^-1 r (result sized like r, may be r itself)
+        Vector diagonal_solve(const Vector& r) const;
+        void diagonal_solve(const Vector& r, Vector& result) const;
+
     // Overloaded Operators
         matrixCSR operator*(const double &scaleFactor) const;
         Vector operator*(const Vector& rhs) const override;
+        void multiply(const Vector& x, Vector& y) const override;
 
 private:
+    // Member Functions
+        // Copy the pattern if it is shared, before changing the nonzero structure
+        sparsityPattern& unique_pattern();
+
     // Member Data
-    std::vector<double>_values;
-    std::vector<int> _row_indices;
+    std::shared_ptr<sparsityPattern> _pattern;
+    std::vector<double> _values;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class matrixCOO Declaration
+\*------------------------------------------------------------------------*/
+
+// Coordinate (triplet) format assembly builder:
+//      entries are pushed in any order and converted to CSR in one pass,
+//      avoiding the O(nnz) insertion cost of matrixCSR::set_value
+class matrixCOO
+{
+public:
+    // Constructor
+        matrixCOO(int num_rows, int num_columns)
+            : _num_rows(num_rows), _num_columns(num_columns) {};
+
+    // Member Functions
+        // Reserve memory for the expected number of entries
+        void reserve(int nnz);
+        // Add an entry (duplicate entries are summed during conversion)
+        void add_value(int i, int j, double value);
+        // Remove all entries (reserved memory is kept)
+        void clear();
+        // Sort entries, merge duplicates and convert to CSR
+        matrixCSR to_CSR() const;
+
+    // Get member functions
+        int get_num_rows() const { return _num_rows; };
+        int get_num_columns() const { return _num_columns; };
+        int get_num_entries() const { return _values.size(); };
+
+private:
+    // Member Data
+    int _num_rows;
+    int _num_columns;
+    std::vector<int> _rows;
+    std::vector<int> _columns;
+    std::vector<double> _values;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class matrixSELL Declaration
+\*------------------------------------------------------------------------*/
+
+// Sliced ELLPACK (SELL-C-sigma) format:
+//      rows are sorted by length inside windows of sigma rows and grouped into chunks of C rows,
+//      each chunk is padded to its longest row and stored column-major so C rows are processed
+//      per SIMD instruction. Built once from a matrixCSR; values can be refreshed in place.
+class matrixSELL
+:
+    public sparseMatrixBase
+{
+public:
+    // Constructor
+        // Empty matrix
+        matrixSELL(int num_rows, int num_columns);
+        // Convert from CSR (chunk height C, sorting window sigma in rows)
+        explicit matrixSELL(const matrixCSR& A, int chunk_height = 8, int sigma = 256);
+
+    // Member Functions
+        double get_value(int i, int j) const override;
+        // NOTE: only existing entries can be changed, the sliced structure is fixed
+        void set_value(int i, int j, double value) override;
+        // Copy new values from a CSR matrix with the same structure as the one converted
+        void update_values(const matrixCSR& A);
+
+    // Get member functions
+        int get_chunk_height() const { return _chunk_height; };
+        int get_sigma() const { return _sigma; };
+        int get_num_chunks() const { return _chunk_lengths.size(); };
+        // Stored entries including padding
+        int get_num_slots() const { return _values.size(); };
+        // Original row of every sorted row position (-1 for padding rows)
+        const std::vector<int>& get_permutation() const { return _permutation; };
+
+    // Overloaded Operators
+        Vector operator*(const Vector& rhs) const override;
+        void multiply(const Vector& x, Vector& y) const override;
+
+private:
+    // Member Data
+    int _chunk_height = 8;
+    int _sigma = 1;
+    // Sorted row position -> original row and back
+    std::vector<int> _permutation;
+    std::vector<int> _inverse_permutation;
+    // Number of stored entries of each sorted row
+    std::vector<int> _row_lengths;
+    // Per chunk: padded row length and first storage slot (size num_chunks+1)
+    std::vector<int> _chunk_lengths;
+    std::vector<int> _chunk_offsets;
+    // Storage: slot = chunk_offset + j*C + lane
     std::vector<int> _column_indices;
+    std::vector<double> _values;
+    // CSR storage index of every slot (-1 for padding)
+    std::vector<int> _csr_positions;
+    // Products in sorted row order (workspace of multiply)
+    mutable std::vector<double> _sorted;
 };
 
+
+/*------------------------------------------------------------------------*\
+**  Class matrixAutotuned Declaration
+\*------------------------------------------------------------------------*/
+
+// CSR matrix which also keeps a SELL copy and times both SpMV kernels on the first product,
+//      every later product uses the faster format. The decision is kept while the values are
+//      updated on the same sparsity pattern and is shared with copies (e.g. the copy held by a solver).
+class matrixAutotuned
+:
+    public sparseMatrixBase
+{
+public:
+    // Storage format used for products
+    enum class format { undecided, CSR, SELL };
+
+    // Constructor
+        matrixAutotuned(int num_rows, int num_columns)
+            : sparseMatrixBase(num_rows, num_columns), _csr(num_rows, num_columns), _sell(num_rows, num_columns),
+              _format(std::make_shared<format>(format::undecided)) {};
+        explicit matrixAutotuned(const matrixCSR& A);
+
+    // Member Functions
+        double get_value(int i, int j) const override { return _csr.get_value(i, j); };
+        void set_value(int i, int j, double value) override;
+        // Replace the matrix (the format choice is kept when A has the same sparsity pattern)
+        void update(const matrixCSR& A);
+        // Force a format (skips the timing)
+        void set_format(format f) { *_format = f; };
+
+    // Get member functions
+        format get_format() const { return *_format; };
+        const matrixCSR& get_CSR() const { return _csr; };
+        // CSR access for row based solvers (Gauss-Seidel)
+        const std::vector<int>& get_row_indices() const { return _csr.get_row_indices(); };
+        const std::vector<int>& get_column_indices() const { return _csr.get_column_indices(); };
+        const std::vector<double>& get_values() const { return _csr.get_values(); };
+        diagonalView diagonal() const { return _csr.diagonal(); };
+        Vector diagonal_solve(const Vector& r) const { return _csr.diagonal_solve(r); };
+        void diagonal_solve(const Vector& r, Vector& result) const { _csr.diagonal_solve(r, result); };
+
+    // Overloaded Operators
+        Vector operator*(const Vector& rhs) const override;
+        void multiply(const Vector& x, Vector& y) const override;
+
+private:
+    // Member Functions
+        // Time both kernels on rhs and keep the faster one
+        void tune(const Vector& rhs) const;
+
+    // Member Data
+    matrixCSR _csr;
+    matrixSELL _sell;
+    // Tuning result, shared by copies of this matrix
+    std::shared_ptr<format> _format;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class matrixCSRFloat Declaration
+\*------------------------------------------------------------------------*/
+
+// Single precision copy of a CSR matrix sharing its sparsity pattern, for mixed-precision solvers
+//      Products read the values in float (8 instead of 12 bytes per nonzero) and accumulate in double.
+class matrixCSRFloat
+:
+    public sparseMatrixBase
+{
+public:
+    // Constructor
+        // Empty matrix
+        matrixCSRFloat(int num_rows, int num_columns)
+            : sparseMatrixBase(num_rows, num_columns),
+              _pattern(std::make_shared<sparsityPattern>(num_rows, num_columns)) {};
+        // Round the values of A to float
+        explicit matrixCSRFloat(const matrixCSR& A);
+
+    // Member Functions
+        double get_value(int i, int j) const override;
+        // NOTE: only existing entries can be changed, the structure belongs to the (shared) pattern
+        void set_value(int i, int j, double value) override;
+        // Round the values of a CSR matrix to float again (the structure is rebuilt if A has another pattern)
+        void update_values(const matrixCSR& A);
+
+    // Get member functions
+        std::shared_ptr<sparsityPattern> get_pattern() const { return _pattern; };
+        const std::vector<float>& get_values() const { return _values; };
+
+    // Overloaded Operators
+        Vector operator*(const Vector& rhs) const override;
+        void multiply(const Vector& x, Vector& y) const override;
+
+private:
+    // Member Data
+    std::shared_ptr<sparsityPattern> _pattern;
+    std::vector<float> _values;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class matrixBSR Declaration
+\*------------------------------------------------------------------------*/
+
+// Block CSR format with dense B x B blocks (B = number of coupled unknowns per cell):
+//      the sparsity pattern describes block rows/columns (e.g. the cell connectivity) and
+//      every block is stored row-major, so one column index addresses B*B values.
+//      Scalar row i belongs to block row i/B, component i%B (unknowns are interlaced).
+template <int B>
+class matrixBSR
+:
+    public sparseMatrixBase
+{
+public:
+    static_assert(B >= 1, "Block size must be positive");
+    static constexpr int block_size = B;
+    static constexpr int block_entries = B*B;
+
+    // Constructor
+        // Empty matrix (sizes in scalar rows/columns, must be multiples of B)
+        matrixBSR(int num_rows, int num_columns)
+            : sparseMatrixBase(num_rows, num_columns),
+              _pattern(std::make_shared<sparsityPattern>(num_rows/B, num_columns/B)) {};
+        // Zero matrix on an existing block pattern (shared)
+        explicit matrixBSR(std::shared_ptr<sparsityPattern> pattern)
+            : sparseMatrixBase(B*pattern->get_num_rows(), B*pattern->get_num_columns()),
+              _pattern(pattern),
+              _values(block_entries*pattern->get_nnz(), 0.0) {};
+
+    // Member Functions
+        // Scalar access
+        double get_value(int i, int j) const override;
+        void set_value(int i, int j, double value) override;
+        // Block access, nullptr if block (I,J) is not stored
+        const double* get_block(int I, int J) const;
+        // Block (I,J), inserted as a zero block if not stored yet
+        double* insert_block(int I, int J);
+        // Apply the inverse block diagonal, D^-1 r (result sized like r, may be r itself)
+        Vector diagonal_solve(const Vector& r) const;
+        void diagonal_solve(const Vector& r, Vector& result) const;
+
+    // Get member functions
+        int get_num_block_rows() const { return _pattern->get_num_rows(); };
+        std::shared_ptr<sparsityPattern> get_pattern() const { return _pattern; };
+        const std::vector<int>& get_row_indices() const { return _pattern->_row_indices; };
+        const std::vector<int>& get_column_indices() const { return _pattern->_column_indices; };
+        // Diagonal block of block row I, nullptr if not stored
+        const double* get_diagonal_block(int I) const;
+        // Block values (slot k occupies [k*B*B, (k+1)*B*B))
+        const std::vector<double>& get_values() const { return _values; };
+        std::vector<double>& get_values() { return _values; };
+
+    // Overloaded Operators
+        Vector operator*(const Vector& rhs) const override;
+        void multiply(const Vector& x, Vector& y) const override;
+
+private:
+    // Member Functions
+        // Copy the pattern if it is shared, before changing the nonzero structure
+        sparsityPattern& unique_pattern();
+
+    // Member Data
+    std::shared_ptr<sparsityPattern> _pattern;
+    std::vector<double> _values;
+};
+
+
+// * * * * * * * * * * * * * *  solve_block * * * * * * * * * * * * * * * //
+// Solve the dense B x B system D x = r in place (Gaussian elimination, partial pivoting)
+//      Returns false for a (near) singular block
+template <int B>
+bool solve_block(const double* D, double* x);
+
+
+// * * * * * * * * * * * * * *  Sparse matrix products * * * * * * * * * * * * * * * //
+// C = A*B (symbolic and numeric phase)
+matrixCSR multiply(const matrixCSR& A, const matrixCSR& B);
+// Recompute the values of C = A*B on the pattern returned by multiply() (numeric phase only)
+void multiply_values(const matrixCSR& A, const matrixCSR& B, matrixCSR& C);
+// A^T, optionally returning the slot of A each entry of A^T was taken from (to refresh values later)
+matrixCSR transpose(const matrixCSR& A, std::vector<int>* source_slots = nullptr);
+
 }
 
 #endif // _SPARSEMATRIX_HH_
\ No newline at end of file
@@ -0,0 +1,189 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      threadPool.hh
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     header for the shared-memory parallel backend of the MATH kernels
+**
+\*------------------------------------------------------------------------*/
+
+#ifndef _THREADPOOL_HH_
+#define _THREADPOOL_HH_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <type_traits>
+
+namespace MATH {
+
+// Runtime thread count used by the SpMV and Vector kernels
+//      Defaults to the LUNA_NUM_THREADS environment variable, otherwise the hardware concurrency
+void set_num_threads(int num_threads);
+int get_num_threads();
+
+// Minimum amount of work (entries) handed to a single thread
+constexpr int parallelGrainSize = 4096;
+
+// Entries summed by one block of a deterministic reduction (a multiple of 8, blocks start on cache lines)
+constexpr int reductionBlockSize = 1024;
+
+// How deterministic_sum combines values
+enum class summationMode
+{
+    blocked,        // plain sums inside every block, block sums added in block order
+    compensated     // compensated (Neumaier) sums of the block sums, kernels that support it compensate inside the blocks
+};
+
+// Process wide summation mode of the reductions (blocked by default)
+void set_summation_mode(summationMode mode);
+summationMode get_summation_mode();
+
+// Split [0,n) into at most get_num_threads() contiguous chunks of (nearly) equal length
+//      Chunk starts are multiples of 8 so that each chunk of a Vector begins on a cache line
+//      Returns chunk bounds (size = number of chunks + 1)
+std::vector<int> partition_uniform(int n);
+
+// Split [0,n) into the fixed reduction blocks [k*reductionBlockSize, (k+1)*reductionBlockSize), independent of the thread count
+//      Returns block bounds (size = number of blocks + 1)
+std::vector<int> partition_blocks(int n);
+
+// Result of a compensated kernel over one block: the rounded sum and its accumulated rounding error
+struct compensatedSum
+{
+    double sum = 0.0;
+    double error = 0.0;
+};
+
+// Sum of values[0], values[stride], ... values[(count-1)*stride] in index order (compensated if selected)
+double ordered_sum(const double* values, int count, int stride = 1);
+// Compensated sum of the block results of compensated kernels (their errors are kept until the end)
+double ordered_sum(const compensatedSum* values, int count);
+
+// Split the rows of a CSR matrix into at most num_parts chunks holding roughly the same number of nonzeros
+//      Returns row bounds (size = number of chunks + 1)
+std::vector<int> partition_by_nnz(const std::vector<int>& row_indices, int num_parts);
+
+
+/*------------------------------------------------------------------------*\
+**  Class threadPool Declaration
+\*------------------------------------------------------------------------*/
+
+// Persistent pool of worker threads; the calling thread also executes tasks
+class threadPool
+{
+public:
+    // Constructor
+        explicit threadPool(int num_threads);
+    // Destructor
+        ~threadPool();
+
+    // Delete copy
+        threadPool(const threadPool&) = delete;
+        threadPool& operator=(const threadPool&) = delete;
+
+    // Member Functions
+        // Execute task(0) ... task(num_tasks-1) and wait for all of them to finish
+        //      Nested calls from inside a task run serially on the calling thread,
+        //      concurrent calls from different external threads are serialized
+        void run(int num_tasks, const std::function<void(int)>& task);
+
+    // Get member functions
+        int get_num_threads() const { return _workers.size() + 1; };
+        // Process wide pool sized by set_num_threads()
+        static threadPool& instance();
+
+private:
+    // Member Functions
+        void worker_loop();
+        void execute_tasks();
+
+    // Member Data
+    std::vector<std::thread> _workers;
+    // Held by run() for a whole run, so concurrent callers cannot replace the task of a run in progress
+    std::mutex _runMutex;
+    std::mutex _mutex;
+    std::condition_variable _start;
+    std::condition_variable _done;
+    const std::function<void(int)>* _task = nullptr;
+    std::atomic<int> _num_tasks{0};
+    std::atomic<int> _next_task{0};
+    std::atomic<int> _remaining{0};
+    int _active = 0;
+    unsigned long _generation = 0;
+    bool _stop = false;
+};
+
+
+// * * * * * * * * * * * * * *  parallel_for * * * * * * * * * * * * * * * //
+// Calls body(begin, end) once per chunk of bounds
+template <class Body>
+void parallel_for(const std::vector<int>& bounds, const Body& body)
+{
+    int num_chunks = bounds.size() - 1;
+    if (num_chunks == 1) {
+        body(bounds[0], bounds[1]);
+        return;
+    }
+    threadPool::instance().run(num_chunks, [&](int chunk) { body(bounds[chunk], bounds[chunk+1]); });
+}
+
+
+// * * * * * * * * * * * * * *  parallel_blocks * * * * * * * * * * * * * * * //
+// Calls body(first, last) on contiguous runs of the fixed blocks [k*reductionBlockSize, (k+1)*reductionBlockSize)
+//      of [0,n), one run per thread and at least parallelGrainSize entries per run. Kernels that keep one
+//      result per block (and add them in block order) stay bitwise identical for any thread count.
+template <class Body>
+void parallel_blocks(int n, const Body& body)
+{
+    int num_blocks = (n + reductionBlockSize - 1) / reductionBlockSize;
+    int blocksPerGrain = std::max(1, parallelGrainSize / reductionBlockSize);
+    int num_parts = std::max(1, std::min(get_num_threads(), num_blocks / blocksPerGrain));
+    if (num_parts == 1) {
+        body(0, num_blocks);
+        return;
+    }
+    std::vector<int> bounds(num_parts + 1);
+    for (int p = 0; p <= num_parts; p++) bounds[p] = static_cast<long long>(num_blocks) * p / num_parts;
+    threadPool::instance().run(num_parts, [&](int part) { body(bounds[part], bounds[part+1]); });
+}
+
+
+// * * * * * * * * * * * * * *  deterministic_sum * * * * * * * * * * * * * * * //
+// Sums body(begin, end) over the fixed blocks [k*reductionBlockSize, (k+1)*reductionBlockSize) of [0,n)
+//      The blocks only depend on n: threads take contiguous runs of blocks and the block results are added
+//      in block order afterwards (ordered_sum), so the result is bitwise identical for any thread count.
+//      body returns a double, or a compensatedSum when it compensates inside the block.
+template <class Body>
+double deterministic_sum(int n, const Body& body)
+{
+    using blockResult = decltype(body(0, n));
+    int num_blocks = (n + reductionBlockSize - 1) / reductionBlockSize;
+    if (num_blocks <= 1) {
+        blockResult result = body(0, n);
+        if constexpr (std::is_same_v<blockResult, compensatedSum>) {
+            return result.sum + result.error;
+        }
+        else {
+            return result;
+        }
+    }
+
+    std::vector<blockResult> partial(num_blocks);
+    parallel_blocks(n, [&](int first, int last) {
+        for (int k = first; k < last; k++) {
+            partial[k] = body(k*reductionBlockSize, std::min(n, (k+1)*reductionBlockSize));
+        }
+    });
+
+    return ordered_sum(partial.data(), num_blocks);
+}
+
+}
+
+#endif // _THREADPOOL_HH_
@@ -13,7 +13,7 @@
 
 #include <vector>
 
-#include "Vector.hh"
+#include "Vec.hh"
 
 namespace MATH {
 
@@ -22,10 +22,35 @@ namespace MATH {
 \*------------------------------------------------------------------------*/
 
 // Orientation of 3 points
-int orientation(Vector p0, Vector p1, Vector q, Vector r);
+int orientation(const Vec<3>& p0, const Vec<3>& p1, const Vec<3>& q, const Vec<3>& r);
 
 // jarvis march (or gift wrapping algorithm)  to determine convex hull
-std::vector<int> jarvis_march(std::vector<Vector> points);
+std::vector<int> jarvis_march(const std::vector<Vec<3>>& points);
+
+
+/*------------------------------------------------------------------------*\
+**  Polygon Functions Definitions
+\*------------------------------------------------------------------------*/
+// Polygon kernels on flat coordinate arrays (x0,y0,x1,y1,...): no allocation, no trigonometry
+
+// Orientation predicate of the points a, b, c: cross product (b-a) x (c-a)
+//      > 0 counter-clockwise, < 0 clockwise, 0 collinear
+inline double orient2d(const double* a, const double* b, const double* c)
+{
+    return (b[0] - a[0]) * (c[1] - a[1]) - (b[1] - a[1]) * (c[0] - a[0]);
+}
+
+// Counter-clockwise order of the count vertices of a polygon, starting at the leftmost vertex (lowest index on ties)
+//      Vertices are sorted by orientation about the leftmost one, which gives the Jarvis march order for the
+//      convex polygons of a mesh without trigonometry or allocation
+void polygon_order(const double* coords, int count, int* order);
+
+// Signed area of the polygon visited in the given order (shoelace formula, > 0 for counter-clockwise)
+double polygon_area(const double* coords, const int* order, int count);
+
+// Signed area and area centroid (centroid[0], centroid[1]) of the polygon visited in the given order
+//      degenerate polygons (zero area) return the vertex average
+double polygon_centroid(const double* coords, const int* order, int count, double* centroid);
 
 }
 
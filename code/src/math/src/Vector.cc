@@ -9,9 +9,222 @@
 \*------------------------------------------------------------------------*/
 
 #include "Vector.hh"
+#include "threadPool.hh"
+#include "cpuFeatures.hh"
+
+#include <cmath>
+#include <utility>
 
 namespace MATH {
 
+namespace {
+
+/**
+ * @brief Elementwise and reduction kernels behind the Vector operations
+ *
+ * @details Each kernel works on the index range [begin, end) so that it can be handed one chunk
+ * of a parallel_for / deterministic_sum. The AVX2/AVX-512 versions use unaligned loads (the storage is
+ * 64-byte aligned and partition_uniform() keeps chunk starts on cache lines, so these never
+ * split a line) and finish the remainder with scalar code. axpy and xpay are expressed through
+ * axpby with beta = 1 or alpha = 1, which are exact in floating point.
+ *
+ * Results agree with the scalar kernels to rounding: axpby uses an FMA and dot/getL2Norm sum
+ * in SIMD lanes, so the last bits of these depend on the selected level. They do not depend on the
+ * thread count: reductions run the kernel on the fixed blocks of deterministic_sum.
+ */
+struct vectorKernels {
+  double (*dot)(const double *x, const double *y, int begin, int end);
+  void (*axpby)(double alpha, const double *x, double beta, double *y, int begin, int end);
+  void (*scale)(double alpha, double *y, int begin, int end);
+  void (*add)(const double *x, const double *y, double *z, int begin, int end);
+  void (*subtract)(const double *x, const double *y, double *z, int begin, int end);
+};
+
+double dot_scalar(const double *x, const double *y, int begin, int end) {
+  double sum = 0.0;
+  for (int i = begin; i < end; ++i)
+    sum += x[i] * y[i];
+  return sum;
+}
+
+// Compensated dot product (Dot2, Ogita, Rump, Oishi 2005): the rounding errors of the products (FMA)
+// and of the sums are accumulated separately, as accurate as a dot product in twice the precision
+compensatedSum dot_compensated(const double *x, const double *y, int begin, int end) {
+  double sum = 0.0;
+  double error = 0.0;
+  for (int i = begin; i < end; ++i) {
+    double product = x[i] * y[i];
+    double productError = std::fma(x[i], y[i], -product);
+    double t = sum + product;
+    double z = t - sum;
+    error += ((sum - (t - z)) + (product - z)) + productError;
+    sum = t;
+  }
+  return {sum, error};
+}
+
+void axpby_scalar(double alpha, const double *x, double beta, double *y, int begin, int end) {
+  for (int i = begin; i < end; ++i)
+    y[i] = x[i] * alpha + y[i] * beta;
+}
+
+void scale_scalar(double alpha, double *y, int begin, int end) {
+  for (int i = begin; i < end; ++i)
+    y[i] *= alpha;
+}
+
+void add_scalar(const double *x, const double *y, double *z, int begin, int end) {
+  for (int i = begin; i < end; ++i)
+    z[i] = x[i] + y[i];
+}
+
+void subtract_scalar(const double *x, const double *y, double *z, int begin, int end) {
+  for (int i = begin; i < end; ++i)
+    z[i] = x[i] - y[i];
+}
+
+#ifdef LUNA_X86
+LUNA_TARGET("avx2,fma")
+double dot_avx2(const double *x, const double *y, int begin, int end) {
+  // Two accumulators hide the latency of the dependent FMAs
+  __m256d sum0 = _mm256_setzero_pd();
+  __m256d sum1 = _mm256_setzero_pd();
+  int i = begin;
+  for (; i + 8 <= end; i += 8) {
+    sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+    sum1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4), _mm256_loadu_pd(y + i + 4), sum1);
+  }
+  for (; i + 4 <= end; i += 4)
+    sum0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i), sum0);
+
+  double lanes[4];
+  _mm256_storeu_pd(lanes, _mm256_add_pd(sum0, sum1));
+  double sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+  for (; i < end; ++i)
+    sum += x[i] * y[i];
+  return sum;
+}
+
+LUNA_TARGET("avx2,fma")
+void axpby_avx2(double alpha, const double *x, double beta, double *y, int begin, int end) {
+  __m256d a = _mm256_set1_pd(alpha);
+  __m256d b = _mm256_set1_pd(beta);
+  int i = begin;
+  for (; i + 4 <= end; i += 4)
+    _mm256_storeu_pd(y + i, _mm256_fmadd_pd(_mm256_loadu_pd(x + i), a, _mm256_mul_pd(_mm256_loadu_pd(y + i), b)));
+  axpby_scalar(alpha, x, beta, y, i, end);
+}
+
+LUNA_TARGET("avx2,fma")
+void scale_avx2(double alpha, double *y, int begin, int end) {
+  __m256d a = _mm256_set1_pd(alpha);
+  int i = begin;
+  for (; i + 4 <= end; i += 4)
+    _mm256_storeu_pd(y + i, _mm256_mul_pd(_mm256_loadu_pd(y + i), a));
+  scale_scalar(alpha, y, i, end);
+}
+
+LUNA_TARGET("avx2,fma")
+void add_avx2(const double *x, const double *y, double *z, int begin, int end) {
+  int i = begin;
+  for (; i + 4 <= end; i += 4)
+    _mm256_storeu_pd(z + i, _mm256_add_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+  add_scalar(x, y, z, i, end);
+}
+
+LUNA_TARGET("avx2,fma")
+void subtract_avx2(const double *x, const double *y, double *z, int begin, int end) {
+  int i = begin;
+  for (; i + 4 <= end; i += 4)
+    _mm256_storeu_pd(z + i, _mm256_sub_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+  subtract_scalar(x, y, z, i, end);
+}
+
+// The AVX-512 kernels handle the remainder with a masked load/store instead of a scalar loop
+LUNA_TARGET("avx512f")
+double dot_avx512(const double *x, const double *y, int begin, int end) {
+  __m512d sum0 = _mm512_setzero_pd();
+  __m512d sum1 = _mm512_setzero_pd();
+  int i = begin;
+  for (; i + 16 <= end; i += 16) {
+    sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), sum0);
+    sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i + 8), _mm512_loadu_pd(y + i + 8), sum1);
+  }
+  for (; i + 8 <= end; i += 8)
+    sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i), sum0);
+  if (i < end) {
+    __mmask8 mask = static_cast<__mmask8>((1u << (end - i)) - 1);
+    sum1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i), sum1);
+  }
+  return _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+}
+
+LUNA_TARGET("avx512f")
+void axpby_avx512(double alpha, const double *x, double beta, double *y, int begin, int end) {
+  __m512d a = _mm512_set1_pd(alpha);
+  __m512d b = _mm512_set1_pd(beta);
+  int i = begin;
+  for (; i + 8 <= end; i += 8)
+    _mm512_storeu_pd(y + i, _mm512_fmadd_pd(_mm512_loadu_pd(x + i), a, _mm512_mul_pd(_mm512_loadu_pd(y + i), b)));
+  if (i < end) {
+    __mmask8 mask = static_cast<__mmask8>((1u << (end - i)) - 1);
+    __m512d yv = _mm512_maskz_loadu_pd(mask, y + i);
+    _mm512_mask_storeu_pd(y + i, mask, _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, x + i), a, _mm512_mul_pd(yv, b)));
+  }
+}
+
+LUNA_TARGET("avx512f")
+void scale_avx512(double alpha, double *y, int begin, int end) {
+  __m512d a = _mm512_set1_pd(alpha);
+  int i = begin;
+  for (; i + 8 <= end; i += 8)
+    _mm512_storeu_pd(y + i, _mm512_mul_pd(_mm512_loadu_pd(y + i), a));
+  if (i < end) {
+    __mmask8 mask = static_cast<__mmask8>((1u << (end - i)) - 1);
+    _mm512_mask_storeu_pd(y + i, mask, _mm512_mul_pd(_mm512_maskz_loadu_pd(mask, y + i), a));
+  }
+}
+
+LUNA_TARGET("avx512f")
+void add_avx512(const double *x, const double *y, double *z, int begin, int end) {
+  int i = begin;
+  for (; i + 8 <= end; i += 8)
+    _mm512_storeu_pd(z + i, _mm512_add_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+  if (i < end) {
+    __mmask8 mask = static_cast<__mmask8>((1u << (end - i)) - 1);
+    _mm512_mask_storeu_pd(z + i, mask, _mm512_add_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i)));
+  }
+}
+
+LUNA_TARGET("avx512f")
+void subtract_avx512(const double *x, const double *y, double *z, int begin, int end) {
+  int i = begin;
+  for (; i + 8 <= end; i += 8)
+    _mm512_storeu_pd(z + i, _mm512_sub_pd(_mm512_loadu_pd(x + i), _mm512_loadu_pd(y + i)));
+  if (i < end) {
+    __mmask8 mask = static_cast<__mmask8>((1u << (end - i)) - 1);
+    _mm512_mask_storeu_pd(z + i, mask, _mm512_sub_pd(_mm512_maskz_loadu_pd(mask, x + i), _mm512_maskz_loadu_pd(mask, y + i)));
+  }
+}
+#endif
+
+// Kernel table for the SIMD level currently selected (see cpuFeatures.hh)
+const vectorKernels &active_kernels() {
+  static const vectorKernels scalar{dot_scalar, axpby_scalar, scale_scalar, add_scalar, subtract_scalar};
+#ifdef LUNA_X86
+  static const vectorKernels avx2{dot_avx2, axpby_avx2, scale_avx2, add_avx2, subtract_avx2};
+  static const vectorKernels avx512{dot_avx512, axpby_avx512, scale_avx512, add_avx512, subtract_avx512};
+  switch (get_simd_level()) {
+    case simdLevel::avx512: return avx512;
+    case simdLevel::avx2: return avx2;
+    default: break;
+  }
+#endif
+  return scalar;
+}
+
+} // namespace
+
 Vector::Vector() {
   _vector.resize(0);
 }
@@ -27,7 +240,7 @@ Vector::Vector(const unsigned &size) {
 }
 
 // Construct vector class from std::vector
-Vector::Vector(const std::vector<double> &vector) : _vector(vector) {}
+Vector::Vector(const std::vector<double> &vector) : _vector(vector.begin(), vector.end()) {}
 
 /**
  * @brief Returns the size of the Vector
@@ -62,29 +275,112 @@ Vector Vector::transpose() {
  * @return The L2Norm of the Vector
  */
 double Vector::getL2Norm() const {
-  double L2Norm = 0.0;
-  for (const auto &entry : _vector)
-    L2Norm += std::pow(entry, 2);
+  const vectorKernels &kernels = active_kernels();
+  const double *x = _vector.data();
+  double L2Norm;
+  if (get_summation_mode() == summationMode::compensated) {
+    L2Norm = deterministic_sum(_vector.size(), [&](int begin, int end) { return dot_compensated(x, x, begin, end); });
+  }
+  else {
+    L2Norm = deterministic_sum(_vector.size(), [&](int begin, int end) { return kernels.dot(x, x, begin, end); });
+  }
   L2Norm = std::sqrt(L2Norm);
   return L2Norm;
 }
 
+/**
+ * @brief Adds a scaled Vector to this Vector
+ *
+ * @details Computes this = this + alpha * x in place.
+ *
+ * @param alpha The scalar applied to x
+ * @param x The Vector to add
+ *
+ * @return Reference to this Vector
+ */
+Vector &Vector::axpy(double alpha, const Vector &x) {
+  assert(_vector.size() == x._vector.size() && "vectors must have the same dimension");
+  const vectorKernels &kernels = active_kernels();
+  parallel_for(partition_uniform(_vector.size()), [&](int begin, int end) {
+    kernels.axpby(alpha, x._vector.data(), 1.0, _vector.data(), begin, end);
+  });
+  return *this;
+}
+
+/**
+ * @brief Scales this Vector and adds another Vector to it
+ *
+ * @details Computes this = x + alpha * this in place (e.g. the search direction update in CG).
+ *
+ * @param x The Vector to add
+ * @param alpha The scalar applied to this Vector
+ *
+ * @return Reference to this Vector
+ */
+Vector &Vector::xpay(const Vector &x, double alpha) {
+  assert(_vector.size() == x._vector.size() && "vectors must have the same dimension");
+  const vectorKernels &kernels = active_kernels();
+  parallel_for(partition_uniform(_vector.size()), [&](int begin, int end) {
+    kernels.axpby(1.0, x._vector.data(), alpha, _vector.data(), begin, end);
+  });
+  return *this;
+}
+
+/**
+ * @brief Linear combination of another Vector and this Vector
+ *
+ * @details Computes this = alpha * x + beta * this in place, in a single pass over both Vectors.
+ *
+ * @param alpha The scalar applied to x
+ * @param x The Vector to add
+ * @param beta The scalar applied to this Vector
+ *
+ * @return Reference to this Vector
+ */
+Vector &Vector::axpby(double alpha, const Vector &x, double beta) {
+  assert(_vector.size() == x._vector.size() && "vectors must have the same dimension");
+  const vectorKernels &kernels = active_kernels();
+  parallel_for(partition_uniform(_vector.size()), [&](int begin, int end) {
+    kernels.axpby(alpha, x._vector.data(), beta, _vector.data(), begin, end);
+  });
+  return *this;
+}
+
+/**
+ * @brief Scales this Vector
+ *
+ * @details Computes this = alpha * this in place.
+ *
+ * @param alpha The scalar applied to this Vector
+ *
+ * @return Reference to this Vector
+ */
+Vector &Vector::scale(double alpha) {
+  const vectorKernels &kernels = active_kernels();
+  parallel_for(partition_uniform(_vector.size()), [&](int begin, int end) {
+    kernels.scale(alpha, _vector.data(), begin, end);
+  });
+  return *this;
+}
+
 /**
  * @brief Element-wise addition of two Vectors
  *
  * @details The result is a Vector with the same size as the operands, where each element
  * is the sum of the corresponding elements of the two operands.
  *
- * @param other Vector to add to this Vector
+ * @param lhs First operand
+ * @param rhs Vector to add
  *
  * @return The result of the element-wise addition
  */
-Vector Vector::operator+(const Vector &other) const {
-  assert(_vector.size() == other._vector.size() && "vectors must have the same dimension");
-  Vector resultVector(_vector.size());
-  resultVector._vector.resize(_vector.size());
-  for (unsigned i = 0; i < _vector.size(); ++i)
-    resultVector._vector[i] = _vector[i] + other._vector[i];
+Vector operator+(const Vector &lhs, const Vector &rhs) {
+  assert(lhs._vector.size() == rhs._vector.size() && "vectors must have the same dimension");
+  Vector resultVector(lhs._vector.size());
+  const vectorKernels &kernels = active_kernels();
+  parallel_for(partition_uniform(lhs._vector.size()), [&](int begin, int end) {
+    kernels.add(lhs._vector.data(), rhs._vector.data(), resultVector._vector.data(), begin, end);
+  });
   return resultVector;
 }
 
@@ -94,19 +390,98 @@ Vector Vector::operator+(const Vector &other) const {
  * @details The result is a Vector with the same size as the operands, where each element
  * is the difference of the corresponding elements of the two operands.
  *
- * @param other Vector to subtract from this Vector
+ * @param lhs First operand
+ * @param rhs Vector to subtract
  *
  * @return The result of the element-wise subtraction
  */
-Vector Vector::operator-(const Vector &other) const {
-  assert(_vector.size() == other._vector.size() && "vectors must have the same dimension");
-  Vector resultVector(_vector.size());
-  resultVector._vector.resize(_vector.size());
-  for (unsigned i = 0; i < _vector.size(); ++i)
-    resultVector._vector[i] = _vector[i] - other._vector[i];
+Vector operator-(const Vector &lhs, const Vector &rhs) {
+  assert(lhs._vector.size() == rhs._vector.size() && "vectors must have the same dimension");
+  Vector resultVector(lhs._vector.size());
+  const vectorKernels &kernels = active_kernels();
+  parallel_for(partition_uniform(lhs._vector.size()), [&](int begin, int end) {
+    kernels.subtract(lhs._vector.data(), rhs._vector.data(), resultVector._vector.data(), begin, end);
+  });
   return resultVector;
 }
 
+/**
+ * @brief Element-wise addition/subtraction with a temporary operand
+ *
+ * @details The storage of the temporary operand is reused for the result, so chained expressions
+ * such as a * x + b * y only allocate the Vectors of the scaled operands.
+ *
+ * @return The result of the element-wise addition/subtraction
+ */
+Vector operator+(Vector &&lhs, const Vector &rhs) {
+  lhs += rhs;
+  return std::move(lhs);
+}
+
+Vector operator+(const Vector &lhs, Vector &&rhs) {
+  rhs += lhs;
+  return std::move(rhs);
+}
+
+Vector operator+(Vector &&lhs, Vector &&rhs) {
+  lhs += rhs;
+  return std::move(lhs);
+}
+
+Vector operator-(Vector &&lhs, const Vector &rhs) {
+  lhs -= rhs;
+  return std::move(lhs);
+}
+
+Vector operator-(const Vector &lhs, Vector &&rhs) {
+  assert(lhs._vector.size() == rhs._vector.size() && "vectors must have the same dimension");
+  const vectorKernels &kernels = active_kernels();
+  parallel_for(partition_uniform(rhs._vector.size()), [&](int begin, int end) {
+    kernels.subtract(lhs._vector.data(), rhs._vector.data(), rhs._vector.data(), begin, end);
+  });
+  return std::move(rhs);
+}
+
+Vector operator-(Vector &&lhs, Vector &&rhs) {
+  lhs -= rhs;
+  return std::move(lhs);
+}
+
+/**
+ * @brief Compound assignment operators, applied in place
+ *
+ * @return Reference to this Vector
+ */
+Vector &Vector::operator+=(const Vector &other) {
+  assert(_vector.size() == other._vector.size() && "vectors must have the same dimension");
+  const vectorKernels &kernels = active_kernels();
+  parallel_for(partition_uniform(_vector.size()), [&](int begin, int end) {
+    kernels.add(_vector.data(), other._vector.data(), _vector.data(), begin, end);
+  });
+  return *this;
+}
+
+Vector &Vector::operator-=(const Vector &other) {
+  assert(_vector.size() == other._vector.size() && "vectors must have the same dimension");
+  const vectorKernels &kernels = active_kernels();
+  parallel_for(partition_uniform(_vector.size()), [&](int begin, int end) {
+    kernels.subtract(_vector.data(), other._vector.data(), _vector.data(), begin, end);
+  });
+  return *this;
+}
+
+Vector &Vector::operator*=(double scaleFactor) {
+  return scale(scaleFactor);
+}
+
+Vector &Vector::operator/=(double divisor) {
+  parallel_for(partition_uniform(_vector.size()), [&](int begin, int end) {
+    for (int i = begin; i < end; ++i)
+      _vector[i] /= divisor;
+  });
+  return *this;
+}
+
 double &Vector::operator[](unsigned index) {
   return _vector[index];
 }
@@ -127,10 +502,13 @@ const double &Vector::operator[](unsigned index) const {
  */
 double Vector::operator*(const Vector &other) const {
   // assert(_isRowVector && !other._isRowVector && "first vector must be a row vector, second must be a column vector");
-  double sum = 0.0;
-  for (unsigned i = 0; i < _vector.size(); ++i)
-    sum += _vector[i] * other._vector[i];
-  return sum;
+  const vectorKernels &kernels = active_kernels();
+  const double *x = _vector.data();
+  const double *y = other._vector.data();
+  if (get_summation_mode() == summationMode::compensated) {
+    return deterministic_sum(_vector.size(), [&](int begin, int end) { return dot_compensated(x, y, begin, end); });
+  }
+  return deterministic_sum(_vector.size(), [&](int begin, int end) { return kernels.dot(x, y, begin, end); });
 }
 
 /**
@@ -144,27 +522,19 @@ double Vector::operator*(const Vector &other) const {
  * @return The result of the element-wise multiplication.
  */
 Vector operator*(const double &scaleFactor, Vector vector) {
-  for (unsigned index = 0; index < vector.size(); ++index)
-  {
-    vector[index] *= scaleFactor;
-  }
+  vector.scale(scaleFactor);
   return vector;
 }
 
 Vector operator*(Vector vector, const double &scaleFactor) {
-  for (unsigned index = 0; index < vector.size(); ++index)
-  {
-    vector[index] *= scaleFactor;
-  }
-  return vector;
+  return scaleFactor * std::move(vector);
 }
 
 
 // Whereas this division does not modify the current vector
 // USAGE: vector2 = vector1 / divisor
 Vector operator/(Vector vector, const double &divisor) {
-  for (unsigned index = 0; index < vector.size(); ++index)
-    vector[index] /= divisor;
+  vector /= divisor;
   return vector;
 }
 
@@ -0,0 +1,88 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      cpuFeatures.cc
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     Implementation for runtime SIMD detection
+**
+\*------------------------------------------------------------------------*/
+
+#include "cpuFeatures.hh"
+
+#include <atomic>
+#include <algorithm>
+
+#if defined(LUNA_X86) && defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+
+namespace {
+
+MATH::simdLevel detect_simd_level()
+{
+#if defined(LUNA_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    int max_leaf = info[0];
+
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool fma = (info[2] & (1 << 12)) != 0;
+    if (!osxsave || max_leaf < 7) return MATH::simdLevel::scalar;
+
+    // The OS must save the YMM (and for AVX-512 the opmask/ZMM) registers
+    unsigned long long xcr0 = _xgetbv(0);
+    bool ymm = (xcr0 & 0x6) == 0x6;
+    bool zmm = (xcr0 & 0xE6) == 0xE6;
+
+    __cpuidex(info, 7, 0);
+    bool avx2 = (info[1] & (1 << 5)) != 0;
+    bool avx512f = (info[1] & (1 << 16)) != 0;
+
+    if (avx512f && zmm) return MATH::simdLevel::avx512;
+    if (avx2 && fma && ymm) return MATH::simdLevel::avx2;
+    return MATH::simdLevel::scalar;
+#elif defined(LUNA_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return MATH::simdLevel::avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return MATH::simdLevel::avx2;
+    return MATH::simdLevel::scalar;
+#else
+    return MATH::simdLevel::scalar;
+#endif
+}
+
+// -1 = not yet detected
+std::atomic<int> activeLevel{-1};
+
+}
+
+
+// * * * * * * * * * * * * * *  get_supported_simd_level * * * * * * * * * * * * * * * //
+MATH::simdLevel MATH::get_supported_simd_level()
+{
+    static const simdLevel supported = detect_simd_level();
+    return supported;
+}
+
+
+// * * * * * * * * * * * * * *  get_simd_level * * * * * * * * * * * * * * * //
+MATH::simdLevel MATH::get_simd_level()
+{
+    int level = activeLevel.load(std::memory_order_relaxed);
+    if (level < 0) {
+        level = static_cast<int>(get_supported_simd_level());
+        activeLevel.store(level, std::memory_order_relaxed);
+    }
+    return static_cast<simdLevel>(level);
+}
+
+
+// * * * * * * * * * * * * * *  set_simd_level * * * * * * * * * * * * * * * //
+void MATH::set_simd_level(simdLevel level)
+{
+    int clamped = std::min(static_cast<int>(level), static_cast<int>(get_supported_simd_level()));
+    activeLevel.store(clamped, std::memory_order_relaxed);
+}
@@ -8,8 +8,13 @@
 **
 \*------------------------------------------------------------------------*/
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <stdexcept>
 #include "linearSolvers.hh"
+#include "sparseDirect.hh"
+#include "threadPool.hh"
 
 
 /*------------------------------------------------------------------------*\
@@ -24,62 +29,89 @@ void MATH::linear_solver_base<matrix>::check_inputs()
     }
 
     // make sure we have a square matrix
-    assert(this->_A.get_num_rows() == this->_A.get_num_columns() && "Matrix is not square");
+    assert(this->_A->get_num_rows() == this->_A->get_num_columns() && "Matrix is not square");
     // Ensure vectors are properly size
-    assert(this->_x.size() == this->_A.get_num_rows() && this->_b.size() == this->_A.get_num_rows() && "Matrix and Vector sizes don't match");
+    assert(static_cast<int>(this->_x.size()) == this->_A->get_num_rows() && static_cast<int>(this->_b->size()) == this->_A->get_num_rows() && "Matrix and Vector sizes don't match");
+}
+
+template <class matrix>
+void MATH::linear_solver_base<matrix>::solve_multiple(const std::vector<Vector>& b, std::vector<Vector>& x, unsigned maxIterations, double tolerance)
+{
+    assert(b.size() == x.size() && "Need one guess per right-hand side");
+
+    _residuals.assign(b.size(), 0.0);
+    _multipleIterations.assign(b.size(), 0);
+    // The right-hand sides are bound one after the other, the caller's binding is restored afterwards
+    const Vector* rhs = _b;
+    for (std::size_t k = 0; k < b.size(); k++) {
+        this->set_rhs(b[k]);
+        this->set_guess(x[k]);
+        x[k] = this->solve(maxIterations, tolerance);
+        _residuals[k] = _resid;
+        _multipleIterations[k] = _iterations;
+    }
+    _b = rhs;
 }
 
 // Explicity Template Instantiation
 template class MATH::linear_solver_base<MATH::matrixCSR>;
+template class MATH::linear_solver_base<MATH::matrixAutotuned>;
+template class MATH::linear_solver_base<MATH::matrixSELL>;
+template class MATH::linear_solver_base<MATH::matrixCSRFloat>;
+template class MATH::linear_solver_base<MATH::linearOperator>;
+template class MATH::linear_solver_base<MATH::matrixBSR<2>>;
+template class MATH::linear_solver_base<MATH::matrixBSR<3>>;
+template class MATH::linear_solver_base<MATH::matrixBSR<4>>;
 
 /*------------------------------------------------------------------------*\
 **  Class gauss_seidel Implementation
 \*------------------------------------------------------------------------*/
 
 template <class matrix>
-MATH::Vector MATH::gauss_seidel<matrix>::solve(unsigned maxIterations, double tolerance)
+const MATH::Vector& MATH::gauss_seidel<matrix>::solve(unsigned maxIterations, double tolerance)
 {
     this->check_inputs();
     
     // refering to inherited members with this->
-    // Initialize some values
-    Vector x_old;
+    // Initialize some values (the sweep works in place, rows after i still hold the old iterate)
     double sigma = 0.0;
 
     // check for trivial case
-    if (this->_b.getL2Norm() == 0.0) {
-        return MATH::Vector(this->_A.get_num_rows(), 0.0);
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
     }
 
+    // CSR storage
+    const std::vector<int>& row_indices = this->_A->get_row_indices();
+    const std::vector<int>& column_indices = this->_A->get_column_indices();
+    const std::vector<double>& values = this->_A->get_values();
+    const MATH::diagonalView diagonal = this->_A->diagonal();
+
     this->_iterations = 0;
     while ( this->_iterations < maxIterations )
     {
-        x_old = this->_x;
-        for (int i = 0; i < this->_A.get_num_rows(); i++)
+        for (int i = 0; i < this->_A->get_num_rows(); i++)
         {
             sigma = 0.0;
             
             // Optimized for CSR
-            for (int index = this->_A._row_indices[i]; index < this->_A._row_indices[i + 1]; index++) {
-                if (this->_A._column_indices[index] < i) {
-                    sigma += this->_A._values[index] * this->_x[this->_A._column_indices[index]];
-                }
-                else if (this->_A._column_indices[index] > i) {
-                    sigma += this->_A._values[index] * x_old[this->_A._column_indices[index]];
+            for (int index = row_indices[i]; index < row_indices[i + 1]; index++) {
+                if (column_indices[index] != i) {
+                    sigma += values[index] * this->_x[column_indices[index]];
                 }
             }
 
             
             // Check for zero diagonal and solve
-            double diag = this->_A.get_value(i, i);
+            double diag = diagonal[i];
             if (std::abs(diag) < 1e-12) {  // Handle zero or near-zero diagonals
                 throw std::runtime_error("Zero or near-zero diagonal element in matrix");
             }
-            this->_x[i] = (this->_b[i] - sigma) / diag;
+            this->_x[i] = ((*this->_b)[i] - sigma) / diag;
         }
 
         // Calculate residual norm
-        this->_resid = (this->_A * this->_x - this->_b).getL2Norm();
+        this->_resid = this->residual_norm();
         if (this->_resid < tolerance)
         {
             break;
@@ -93,8 +125,406 @@ MATH::Vector MATH::gauss_seidel<matrix>::solve(unsigned maxIterations, double to
     return this->_x;
 }
 
+template <class matrix>
+void MATH::gauss_seidel<matrix>::solve_multiple(const std::vector<Vector>& b, std::vector<Vector>& x, unsigned maxIterations, double tolerance)
+{
+    assert(b.size() == x.size() && "Need one guess per right-hand side");
+    assert(this->_A->get_num_rows() == this->_A->get_num_columns() && "Matrix is not square");
+
+    int K = b.size();
+    int n = this->_A->get_num_rows();
+    this->_residuals.assign(K, 0.0);
+    this->_multipleIterations.assign(K, 0);
+
+    // Interleave the right-hand sides (entry i*K + k) so a matrix entry is applied to all of them at once
+    //      Systems with a zero rhs (trivial case) or that converged are no longer updated
+    std::vector<double>& B = _interleavedb;
+    std::vector<double>& X = _interleavedx;
+    B.assign(n*K, 0.0);
+    X.assign(n*K, 0.0);
+    std::vector<char>& active = _active;
+    active.assign(K, 0);
+    int num_active = 0;
+    for (int k = 0; k < K; k++) {
+        assert(static_cast<int>(b[k].size()) == n && static_cast<int>(x[k].size()) == n && "Vector size does not match the matrix");
+        if (b[k].getL2Norm() == 0.0) continue;
+        for (int i = 0; i < n; i++) {
+            B[i*K + k] = b[k][i];
+            X[i*K + k] = x[k][i];
+        }
+        active[k] = maxIterations > 0;
+        num_active += active[k];
+    }
+
+    // CSR storage
+    const MATH::matrixCSR& A = MATH::as_CSR(*this->_A);
+    const std::vector<int>& row_indices = A.get_row_indices();
+    const std::vector<int>& column_indices = A.get_column_indices();
+    const std::vector<double>& values = A.get_values();
+    const MATH::diagonalView diagonal = A.diagonal();
+
+    // Residual norms are summed per fixed block of rows, partial sums added in block order (any thread count)
+    int num_blocks = (n + MATH::reductionBlockSize - 1) / MATH::reductionBlockSize;
+    std::vector<double>& partial = _partialSums;
+    std::vector<double>& rowWork = _rowWork;
+    partial.assign(num_blocks*K, 0.0);
+    rowWork.assign(std::max(num_blocks, 1)*K, 0.0);
+    double* sigma = rowWork.data();
+
+    while ( num_active > 0 )
+    {
+        for (int i = 0; i < n; i++)
+        {
+            std::fill(sigma, sigma + K, 0.0);
+            for (int index = row_indices[i]; index < row_indices[i + 1]; index++) {
+                int j = column_indices[index];
+                if (j == i) continue;
+                const double* x_j = &X[j*K];
+                for (int k = 0; k < K; k++) {
+                    sigma[k] += values[index] * x_j[k];
+                }
+            }
+
+            // Check for zero diagonal and solve
+            double diag = diagonal[i];
+            if (std::abs(diag) < 1e-12) {  // Handle zero or near-zero diagonals
+                throw std::runtime_error("Zero or near-zero diagonal element in matrix");
+            }
+            for (int k = 0; k < K; k++) {
+                if (active[k]) X[i*K + k] = (B[i*K + k] - sigma[k]) / diag;
+            }
+        }
+
+        // Calculate residual norms, one pass over A for all right-hand sides (each thread takes a run of blocks)
+        MATH::parallel_blocks(n, [&](int first, int last) {
+            double* Ax = &rowWork[first*K];
+            for (int block = first; block < last; block++) {
+                double* sum = &partial[block*K];
+                std::fill(sum, sum + K, 0.0);
+                int end = std::min(n, (block+1)*MATH::reductionBlockSize);
+                for (int i = block*MATH::reductionBlockSize; i < end; i++) {
+                    std::fill(Ax, Ax + K, 0.0);
+                    for (int index = row_indices[i]; index < row_indices[i + 1]; index++) {
+                        const double* x_j = &X[column_indices[index]*K];
+                        for (int k = 0; k < K; k++) {
+                            Ax[k] += values[index] * x_j[k];
+                        }
+                    }
+                    for (int k = 0; k < K; k++) {
+                        double r = Ax[k] - B[i*K + k];
+                        sum[k] += r*r;
+                    }
+                }
+            }
+        });
+
+        for (int k = 0; k < K; k++) {
+            if (!active[k]) continue;
+            this->_residuals[k] = std::sqrt(MATH::ordered_sum(&partial[k], num_blocks, K));
+
+            // Update Iterations
+            if (this->_residuals[k] < tolerance || ++this->_multipleIterations[k] >= maxIterations) {
+                active[k] = 0;
+                num_active--;
+            }
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        for (int k = 0; k < K; k++) {
+            x[k][i] = X[i*K + k];
+        }
+    }
+}
+
 // Explicity Template Instantiation
 template class MATH::gauss_seidel<MATH::matrixCSR>;
+template class MATH::gauss_seidel<MATH::matrixAutotuned>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class gauss_seidel<matrixBSR> Implementation
+\*------------------------------------------------------------------------*/
+
+template <int B>
+const MATH::Vector& MATH::gauss_seidel<MATH::matrixBSR<B>>::solve(unsigned maxIterations, double tolerance)
+{
+    this->check_inputs();
+
+    // check for trivial case
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
+    }
+
+    // BSR storage
+    const std::vector<int>& row_indices = this->_A->get_row_indices();
+    const std::vector<int>& column_indices = this->_A->get_column_indices();
+    const std::vector<double>& values = this->_A->get_values();
+    constexpr int BB = B*B;
+
+    this->_iterations = 0;
+    while ( this->_iterations < maxIterations )
+    {
+        for (int I = 0; I < this->_A->get_num_block_rows(); I++)
+        {
+            // rhs of the block row with the off-diagonal blocks moved over
+            //      (block rows before I already hold the new iterate)
+            double r[B];
+            for (int i = 0; i < B; i++) {
+                r[i] = (*this->_b)[I*B + i];
+            }
+            for (int slot = row_indices[I]; slot < row_indices[I+1]; slot++) {
+                int J = column_indices[slot];
+                if (J == I) continue;
+                const double* block = &values[slot*BB];
+                for (int i = 0; i < B; i++) {
+                    for (int j = 0; j < B; j++) {
+                        r[i] -= block[i*B + j] * this->_x[J*B + j];
+                    }
+                }
+            }
+
+            // Solve with the diagonal block
+            const double* D = this->_A->get_diagonal_block(I);
+            if (D == nullptr || !MATH::solve_block<B>(D, r)) {
+                throw std::runtime_error("Singular or missing diagonal block in matrix");
+            }
+            for (int i = 0; i < B; i++) {
+                this->_x[I*B + i] = r[i];
+            }
+        }
+
+        // Calculate residual norm
+        this->_resid = this->residual_norm();
+        if (this->_resid < tolerance)
+        {
+            break;
+        }
+
+        // Update Iterations 
+        this->_iterations++;
+    }
+
+    return this->_x;
+}
+
+// Explicity Template Instantiation
+template class MATH::gauss_seidel<MATH::matrixBSR<2>>;
+template class MATH::gauss_seidel<MATH::matrixBSR<3>>;
+template class MATH::gauss_seidel<MATH::matrixBSR<4>>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class sor Implementation
+\*------------------------------------------------------------------------*/
+
+template <class matrix>
+const MATH::Vector& MATH::sor<matrix>::solve(unsigned maxIterations, double tolerance)
+{
+    this->check_inputs();
+
+    // check for trivial case
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
+    }
+
+    // CSR storage
+    const MATH::matrixCSR& A = MATH::as_CSR(*this->_A);
+    const std::vector<int>& row_indices = A.get_row_indices();
+    const std::vector<int>& column_indices = A.get_column_indices();
+    const std::vector<double>& values = A.get_values();
+    const MATH::diagonalView diagonal = A.diagonal();
+    const int n = A.get_num_rows();
+    Vector& x = this->_x;
+    const Vector& b = *this->_b;
+
+    for (int i = 0; i < n; i++) {
+        if (std::abs(diagonal[i]) < 1e-12) {  // Handle zero or near-zero diagonals
+            throw std::runtime_error("Zero or near-zero diagonal element in matrix");
+        }
+    }
+
+    // Relax row i, returns its residual before the update
+    auto relax = [&](int i) {
+        double r = b[i];
+        for (int index = row_indices[i]; index < row_indices[i + 1]; index++) {
+            r -= values[index] * x[column_indices[index]];
+        }
+        x[i] += _omega * r / diagonal[i];
+        return r;
+    };
+
+    // True residual norm ||b - A x||
+    auto residual = [&]() {
+        return std::sqrt(MATH::deterministic_sum(A.get_num_rows(), [&](int begin, int end) {
+            double sum = 0.0;
+            for (int i = begin; i < end; i++) {
+                double r = b[i];
+                for (int index = row_indices[i]; index < row_indices[i + 1]; index++) {
+                    r -= values[index] * x[column_indices[index]];
+                }
+                sum += r*r;
+            }
+            return sum;
+        }));
+    };
+
+    this->_iterations = 0;
+    while ( this->_iterations < maxIterations )
+    {
+        double sweep_resid = 0.0;
+        for (int i = 0; i < n; i++) {
+            double r = relax(i);
+            sweep_resid += r*r;
+        }
+        if (_symmetric) {
+            sweep_resid = 0.0;
+            for (int i = n-1; i >= 0; i--) {
+                double r = relax(i);
+                sweep_resid += r*r;
+            }
+        }
+
+        // Confirm convergence with the true residual
+        this->_resid = std::sqrt(sweep_resid);
+        if (this->_resid < tolerance)
+        {
+            this->_resid = residual();
+            if (this->_resid < tolerance) break;
+        }
+
+        // Update Iterations 
+        this->_iterations++;
+    }
+
+    // Not converged: report the true residual rather than the in-sweep monitor
+    if (this->_iterations >= maxIterations) this->_resid = residual();
+
+    return this->_x;
+}
+
+// Explicity Template Instantiation
+template class MATH::sor<MATH::matrixCSR>;
+template class MATH::sor<MATH::matrixAutotuned>;
+template class MATH::ssor<MATH::matrixCSR>;
+template class MATH::ssor<MATH::matrixAutotuned>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class multicolor_gauss_seidel Implementation
+\*------------------------------------------------------------------------*/
+
+template <class matrix>
+const MATH::Vector& MATH::multicolor_gauss_seidel<matrix>::solve(unsigned maxIterations, double tolerance)
+{
+    this->check_inputs();
+
+    // check for trivial case
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
+    }
+
+    // CSR storage and the coloring of its pattern
+    const MATH::matrixCSR& A = MATH::as_CSR(*this->_A);
+    const std::vector<int>& row_indices = A.get_row_indices();
+    const std::vector<int>& column_indices = A.get_column_indices();
+    const std::vector<double>& values = A.get_values();
+    const MATH::diagonalView diagonal = A.diagonal();
+    const std::vector<int>& color_offsets = A.get_pattern()->get_color_offsets();
+    const std::vector<int>& color_rows = A.get_pattern()->get_color_rows();
+
+    // Check for zero diagonals before the (threaded) sweeps
+    for (int i = 0; i < A.get_num_rows(); i++) {
+        if (std::abs(diagonal[i]) < 1e-12) {
+            throw std::runtime_error("Zero or near-zero diagonal element in matrix");
+        }
+    }
+
+    this->_iterations = 0;
+    while ( this->_iterations < maxIterations )
+    {
+        for (std::size_t c = 0; c + 1 < color_offsets.size(); c++)
+        {
+            const int* rows = &color_rows[color_offsets[c]];
+            MATH::parallel_for(MATH::partition_uniform(color_offsets[c+1] - color_offsets[c]), [&](int begin, int end) {
+                for (int r = begin; r < end; r++) {
+                    int i = rows[r];
+                    double sigma = 0.0;
+                    for (int index = row_indices[i]; index < row_indices[i + 1]; index++) {
+                        if (column_indices[index] != i) {
+                            sigma += values[index] * this->_x[column_indices[index]];
+                        }
+                    }
+                    this->_x[i] = ((*this->_b)[i] - sigma) / diagonal[i];
+                }
+            });
+        }
+
+        // Calculate residual norm
+        this->_resid = this->residual_norm();
+        if (this->_resid < tolerance)
+        {
+            break;
+        }
+
+        // Update Iterations 
+        this->_iterations++;
+    }
+
+    return this->_x;
+}
+
+// Explicity Template Instantiation
+template class MATH::multicolor_gauss_seidel<MATH::matrixCSR>;
+template class MATH::multicolor_gauss_seidel<MATH::matrixAutotuned>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class jacobi Implementation
+\*------------------------------------------------------------------------*/
+
+template <class matrix>
+const MATH::Vector& MATH::jacobi<matrix>::solve(unsigned maxIterations, double tolerance)
+{
+    this->check_inputs();
+
+    // check for trivial case
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
+    }
+
+    Vector& r = this->_r;
+    this->reserve(r, this->_x.size());
+
+    this->_iterations = 0;
+    while ( this->_iterations < maxIterations )
+    {
+        // Residual of the current iterate
+        this->_A->multiply(this->_x, r);
+        r.xpay(*this->_b, -1.0);
+        this->_resid = r.getL2Norm();
+        if (this->_resid < tolerance)
+        {
+            break;
+        }
+
+        // All unknowns (blocks) are updated from the same iterate, D^-1 r overwrites the residual
+        this->_A->diagonal_solve(r, r);
+        this->_x.axpy(_omega, r);
+
+        // Update Iterations 
+        this->_iterations++;
+    }
+
+    return this->_x;
+}
+
+// Explicity Template Instantiation
+template class MATH::jacobi<MATH::matrixCSR>;
+template class MATH::jacobi<MATH::matrixAutotuned>;
+template class MATH::jacobi<MATH::matrixBSR<2>>;
+template class MATH::jacobi<MATH::matrixBSR<3>>;
+template class MATH::jacobi<MATH::matrixBSR<4>>;
 
 
 /*------------------------------------------------------------------------*\
@@ -102,46 +532,1080 @@ template class MATH::gauss_seidel<MATH::matrixCSR>;
 \*------------------------------------------------------------------------*/
 
 template <class matrix>
-MATH::Vector MATH::conjugate_gradient<matrix>::solve(unsigned maxIterations, double tolerance)
+const MATH::Vector& MATH::conjugate_gradient<matrix>::solve(unsigned maxIterations, double tolerance)
 {
     this->_iterations = 0;
     this->check_inputs();
 
     // check for trivial case
-    if (this->_b.getL2Norm() == 0.0) {
-        return MATH::Vector(this->_A.get_num_rows(), 0.0);
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
     }
 
-    // Initializing some vectors
-    Vector q(this->_b.size());
-    Vector rold(this->_b.size());
+    // Workspace kept between solves
+    int n = this->_x.size();
+    Vector& r = this->_r;
+    this->reserve(r, n);
+    this->reserve(_p, n);
+    this->reserve(_q, n);
+    this->reserve(_z, n);
     double alpha;
     double beta;
 
+    // Preconditioned CG if a preconditioner is set, plain CG otherwise (z = r)
+    bool preconditioned = (this->_M != nullptr);
+    this->setup_preconditioner();
+
     // Get initial residual 
-    Vector r = this->_b - this->_A * this->_x;
-    rold = r;
-    Vector p = r;
+    this->_A->multiply(this->_x, r);
+    r.xpay(*this->_b, -1.0);
+    this->precondition(r, _p);
+    double rz = r * _p;
+    double rz_new;
 
     // See MATH 6644 Notes
+    //      vectors are updated in place so every kernel runs on the thread pool without temporaries
     while ( this->_iterations < maxIterations)
     {
-        q = this->_A * p;
-        alpha = (r.transpose() * r) / (p.transpose() * q);
-        this->_x = this->_x + p*alpha;
-        r = rold - q*alpha;
-        beta = (r.transpose() * r) / (rold.transpose() * rold);
-        p = r + p*beta;
-        rold = r;
-        this->_resid = r.getL2Norm();
-        if (this->_resid < tolerance)
-        {
-            return this->_x;
+        this->_A->multiply(_p, _q);
+        alpha = rz / (_p * _q);
+        this->_x.axpy(alpha, _p);
+        r.axpy(-alpha, _q);
+        if (preconditioned) {
+            this->_resid = r.getL2Norm();
+            if (this->_resid < tolerance)
+            {
+                return this->_x;
+            }
+            this->precondition(r, _z);
+            rz_new = r * _z;
+        }
+        else {
+            rz_new = r * r;
+            this->_resid = std::sqrt(rz_new);
+            if (this->_resid < tolerance)
+            {
+                return this->_x;
+            }
         }
+        beta = rz_new / rz;
+        _p.xpay(preconditioned ? _z : r, beta);
+        rz = rz_new;
         this->_iterations++;
     }
     return this->_x;
 }
 
 // Explicity Template Instantiation
-template class MATH::conjugate_gradient<MATH::matrixCSR>;
\ No newline at end of file
+template class MATH::conjugate_gradient<MATH::matrixCSR>;
+template class MATH::conjugate_gradient<MATH::matrixAutotuned>;
+template class MATH::conjugate_gradient<MATH::matrixSELL>;
+template class MATH::conjugate_gradient<MATH::matrixCSRFloat>;
+template class MATH::conjugate_gradient<MATH::linearOperator>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class deflated_conjugate_gradient Implementation
+\*------------------------------------------------------------------------*/
+
+namespace {
+
+// In place Cholesky factor L of a small row-major SPD matrix, false if it is not positive definite
+bool cholesky_factor(std::vector<double>& E, int k)
+{
+    for (int j = 0; j < k; j++) {
+        double d = E[j*k + j];
+        for (int m = 0; m < j; m++) d -= E[j*k + m] * E[j*k + m];
+        if (!(d > 0.0)) return false;
+        E[j*k + j] = std::sqrt(d);
+        for (int i = j + 1; i < k; i++) {
+            double s = E[i*k + j];
+            for (int m = 0; m < j; m++) s -= E[i*k + m] * E[j*k + m];
+            E[i*k + j] = s / E[j*k + j];
+        }
+    }
+    return true;
+}
+
+// Solve L L^T y = y in place
+void cholesky_solve(const std::vector<double>& L, int k, std::vector<double>& y)
+{
+    for (int i = 0; i < k; i++) {
+        for (int m = 0; m < i; m++) y[i] -= L[i*k + m] * y[m];
+        y[i] /= L[i*k + i];
+    }
+    for (int i = k - 1; i >= 0; i--) {
+        for (int m = i + 1; m < k; m++) y[i] -= L[m*k + i] * y[m];
+        y[i] /= L[i*k + i];
+    }
+}
+
+// Cyclic Jacobi eigenvalue iteration for a small row-major symmetric matrix G (m x m):
+//      eigenvalues ascending, eigenvector j is column j of the returned row-major matrix
+std::vector<double> symmetric_eigenvectors(std::vector<double> G, int m, std::vector<double>& eigenvalues)
+{
+    std::vector<double> V(m*m, 0.0);
+    for (int i = 0; i < m; i++) V[i*m + i] = 1.0;
+
+    for (int sweep = 0; sweep < 50; sweep++) {
+        double offdiagonal = 0.0;
+        for (int i = 0; i < m; i++) {
+            for (int j = i + 1; j < m; j++) offdiagonal += G[i*m + j] * G[i*m + j];
+        }
+        if (offdiagonal < 1.0e-30) break;
+
+        for (int p = 0; p < m; p++) {
+            for (int q = p + 1; q < m; q++) {
+                if (G[p*m + q] == 0.0) continue;
+                // Rotation annihilating G(p,q)
+                double theta = (G[q*m + q] - G[p*m + p]) / (2.0 * G[p*m + q]);
+                double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta*theta + 1.0));
+                double c = 1.0 / std::sqrt(t*t + 1.0);
+                double s = t * c;
+                for (int i = 0; i < m; i++) {
+                    double gp = G[i*m + p], gq = G[i*m + q];
+                    G[i*m + p] = c*gp - s*gq;
+                    G[i*m + q] = s*gp + c*gq;
+                }
+                for (int i = 0; i < m; i++) {
+                    double gp = G[p*m + i], gq = G[q*m + i];
+                    G[p*m + i] = c*gp - s*gq;
+                    G[q*m + i] = s*gp + c*gq;
+                }
+                for (int i = 0; i < m; i++) {
+                    double vp = V[i*m + p], vq = V[i*m + q];
+                    V[i*m + p] = c*vp - s*vq;
+                    V[i*m + q] = s*vp + c*vq;
+                }
+            }
+        }
+    }
+
+    // Sort ascending
+    std::vector<int> order(m);
+    for (int i = 0; i < m; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return G[a*m + a] < G[b*m + b]; });
+    std::vector<double> sorted(m*m);
+    eigenvalues.resize(m);
+    for (int j = 0; j < m; j++) {
+        eigenvalues[j] = G[order[j]*m + order[j]];
+        for (int i = 0; i < m; i++) sorted[i*m + j] = V[i*m + order[j]];
+    }
+    return sorted;
+}
+
+// Eigenvectors of the count smallest eigenvalues of the leading m x m block of a symmetric matrix
+//      stored row-major with leading dimension ld: returns an m x count row-major matrix
+std::vector<double> smallest_eigenvectors(const std::vector<double>& T, int ld, int m, int count)
+{
+    std::vector<double> G(m*m);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) G[i*m + j] = T[i*ld + j];
+    }
+    std::vector<double> eigenvalues;
+    std::vector<double> V = symmetric_eigenvectors(G, m, eigenvalues);
+    std::vector<double> Y(m*count);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < count; j++) Y[i*count + j] = V[i*m + j];
+    }
+    return Y;
+}
+
+}
+
+template <class matrix>
+const MATH::Vector& MATH::deflated_conjugate_gradient<matrix>::solve(unsigned maxIterations, double tolerance)
+{
+    this->_iterations = 0;
+    this->check_inputs();
+
+    // check for trivial case
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
+    }
+
+    // Workspace kept between solves
+    int n = this->_x.size();
+    Vector& r = this->_r;
+    this->reserve(r, n);
+    this->reserve(_p, n);
+    this->reserve(_q, n);
+    this->reserve(_z, n);
+    double alpha;
+    double beta;
+    this->setup_preconditioner();
+
+    // Recycled space from the previous solve: A W and the factored Galerkin matrix W^T A W for the current matrix
+    if (!_W.empty() && static_cast<int>(_W[0].size()) != n) _W.clear();
+    int k = _W.size();
+    _AW.resize(k);
+    for (int i = 0; i < k; i++) {
+        this->reserve(_AW[i], n);
+        this->_A->multiply(_W[i], _AW[i]);
+    }
+    _galerkin.assign(k*k, 0.0);
+    for (int i = 0; i < k; i++) {
+        for (int j = 0; j <= i; j++) {
+            _galerkin[i*k + j] = 0.5 * (_W[i] * _AW[j] + _W[j] * _AW[i]);
+            _galerkin[j*k + i] = _galerkin[i*k + j];
+        }
+    }
+    _WAW = _galerkin;
+    if (!cholesky_factor(_WAW, k)) {
+        _W.clear();
+        _AW.clear();
+        _galerkin.clear();
+        k = 0;
+    }
+    _mu.resize(k);
+    _packedW.resize(static_cast<std::size_t>(n) * k);
+    _packedAW.resize(static_cast<std::size_t>(n) * k);
+    MATH::parallel_for(MATH::partition_uniform(n), [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            for (int j = 0; j < k; j++) {
+                _packedW[static_cast<std::size_t>(i)*k + j] = _W[j][i];
+                _packedAW[static_cast<std::size_t>(i)*k + j] = _AW[j][i];
+            }
+        }
+    });
+
+    // Refresh W on the first solve, every _refreshInterval solves and when the iterations rose
+    bool refresh = _deflationSize > 0 && (k == 0 || _refreshPending || (_refreshInterval > 0 && _solvesSinceRefresh + 1 >= _refreshInterval));
+    if (refresh) {
+        _lanczosWindow = std::max(4*_deflationSize, 8);
+        _lanczosVectors.resize(static_cast<std::size_t>(n) * _lanczosWindow);
+        _lanczosMatrix.assign(_lanczosWindow*_lanczosWindow, 0.0);
+        _lanczosCoupling.clear();
+        _lanczosSize = 0;
+        _lanczosKnown = 0;
+    }
+
+    // Initial residual, then the Galerkin correction on W (r becomes orthogonal to W)
+    this->_A->multiply(this->_x, r);
+    r.xpay(*this->_b, -1.0);
+    if (k > 0) {
+        for (int i = 0; i < k; i++) _mu[i] = _W[i] * r;
+        cholesky_solve(_WAW, k, _mu);
+        for (int i = 0; i < k; i++) {
+            this->_x.axpy(_mu[i], _W[i]);
+            r.axpy(-_mu[i], _AW[i]);
+        }
+    }
+
+    // r is orthogonal to W, so r^T z is the same before and after the deflation of z
+    this->precondition(r, _z);
+    double rz = project(r, _z);
+    update_direction(0.0);
+    double rz_new;
+    double offdiagonal = 0.0;
+    double lastDiagonal = 0.0;
+    if (refresh) lanczos_append(_z, rz, 0.0);
+
+    while ( this->_iterations < maxIterations)
+    {
+        this->_A->multiply(_p, _q);
+        alpha = rz / (_p * _q);
+        this->_x.axpy(alpha, _p);
+        r.axpy(-alpha, _q);
+
+        // Diagonal of the Lanczos matrix for the last vector: 1/alpha_j + beta_{j-1}/alpha_{j-1}
+        if (refresh) {
+            int last = _lanczosSize - 1;
+            _lanczosMatrix[last*_lanczosWindow + last] = 1.0/alpha + lastDiagonal;
+            _lanczosKnown = _lanczosSize;
+        }
+
+        this->_resid = r.getL2Norm();
+        if (this->_resid < tolerance)
+        {
+            break;
+        }
+        this->precondition(r, _z);
+        rz_new = project(r, _z);
+        beta = rz_new / rz;
+        update_direction(beta);
+
+        // Next Lanczos vector, coupled to the last one by -sqrt(beta_j)/alpha_j
+        if (refresh) {
+            offdiagonal = -std::sqrt(beta) / alpha;
+            lastDiagonal = beta / alpha;
+            if (_lanczosSize == _lanczosWindow) lanczos_restart();
+            lanczos_append(_z, rz_new, offdiagonal);
+        }
+
+        rz = rz_new;
+        this->_iterations++;
+    }
+
+    // Refresh W, or watch the iteration count for the next refresh
+    if (refresh) {
+        update_deflation_space();
+        _refreshes++;
+        _solvesSinceRefresh = 0;
+        _referenceIterations = 0;
+        _refreshPending = false;
+    }
+    else {
+        _solvesSinceRefresh++;
+        if (_referenceIterations == 0) _referenceIterations = this->_iterations;
+        _refreshPending = this->_iterations > 1.1*_referenceIterations;
+    }
+    return this->_x;
+}
+
+template <class matrix>
+double MATH::deflated_conjugate_gradient<matrix>::project(const Vector& r, const Vector& z)
+{
+    int k = _W.size();
+    if (k == 0) return r * z;
+    int n = z.size();
+    const double* rp = &r[0];
+    const double* zp = &z[0];
+
+    // (A W)^T z and r^T z in one pass, block partial sums added in block order
+    int num_blocks = (n + reductionBlockSize - 1) / reductionBlockSize;
+    _blockSums.resize(static_cast<std::size_t>(num_blocks) * (k+1));
+    MATH::parallel_blocks(n, [&](int first, int last) {
+        for (int block = first; block < last; block++) {
+            double* sums = &_blockSums[static_cast<std::size_t>(block)*(k+1)];
+            std::fill(sums, sums + k+1, 0.0);
+            int end = std::min(n, (block+1)*reductionBlockSize);
+            for (int i = block*reductionBlockSize; i < end; i++) {
+                const double* AWrow = &_packedAW[static_cast<std::size_t>(i)*k];
+                for (int j = 0; j < k; j++) sums[j] += AWrow[j] * zp[i];
+                sums[k] += rp[i] * zp[i];
+            }
+        }
+    });
+    for (int j = 0; j < k; j++) _mu[j] = MATH::ordered_sum(_blockSums.data() + j, num_blocks, k+1);
+    cholesky_solve(_WAW, k, _mu);
+    return MATH::ordered_sum(_blockSums.data() + k, num_blocks, k+1);
+}
+
+template <class matrix>
+void MATH::deflated_conjugate_gradient<matrix>::update_direction(double beta)
+{
+    int k = _W.size();
+    if (k == 0) {
+        _p.xpay(_z, beta);
+        return;
+    }
+    int n = _z.size();
+    double* zp = &_z[0];
+    double* pp = &_p[0];
+    MATH::parallel_for(MATH::partition_uniform(n), [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const double* Wrow = &_packedW[static_cast<std::size_t>(i)*k];
+            double correction = 0.0;
+            for (int j = 0; j < k; j++) correction += Wrow[j] * _mu[j];
+            zp[i] -= correction;
+            pp[i] = zp[i] + beta * pp[i];
+        }
+    });
+}
+
+template <class matrix>
+void MATH::deflated_conjugate_gradient<matrix>::lanczos_append(const Vector& z, double rz, double offdiagonal)
+{
+    int n = z.size();
+    int m = _lanczosWindow;
+    int column = _lanczosSize;
+    double scale = 1.0 / std::sqrt(rz);
+    const double* zp = &z[0];
+    double* v = &_lanczosVectors[static_cast<std::size_t>(column)*n];
+    MATH::parallel_for(MATH::partition_uniform(n), [&](int begin, int end) {
+        for (int i = begin; i < end; i++) v[i] = scale * zp[i];
+    });
+
+    // Coupling to the window: the previous vector, or the last row of the restart rotation
+    if (column > 0) {
+        if (_lanczosCoupling.empty()) {
+            _lanczosMatrix[(column-1)*m + column] = offdiagonal;
+            _lanczosMatrix[column*m + column-1] = offdiagonal;
+        }
+        else {
+            for (int c = 0; c < column; c++) {
+                _lanczosMatrix[c*m + column] = offdiagonal * _lanczosCoupling[c];
+                _lanczosMatrix[column*m + c] = offdiagonal * _lanczosCoupling[c];
+            }
+            _lanczosCoupling.clear();
+        }
+    }
+    _lanczosSize++;
+}
+
+template <class matrix>
+void MATH::deflated_conjugate_gradient<matrix>::lanczos_restart()
+{
+    int m = _lanczosWindow;
+    int nev = std::min(_deflationSize, m/2 - 1);
+
+    // Ritz vectors of T and of T without its last vector (padded), orthonormalized: Q is m x c
+    std::vector<double> Y = smallest_eigenvectors(_lanczosMatrix, m, m, nev);
+    std::vector<double> Yl = smallest_eigenvectors(_lanczosMatrix, m, m-1, nev);
+    std::vector<std::vector<double>> columns;
+    for (int source = 0; source < 2; source++) {
+        for (int j = 0; j < nev; j++) {
+            std::vector<double> y(m, 0.0);
+            for (int i = 0; i < m; i++) {
+                if (source == 0) y[i] = Y[i*nev + j];
+                else if (i < m-1) y[i] = Yl[i*nev + j];
+            }
+            for (int pass = 0; pass < 2; pass++) {
+                for (const std::vector<double>& q : columns) {
+                    double d = 0.0;
+                    for (int i = 0; i < m; i++) d += q[i] * y[i];
+                    for (int i = 0; i < m; i++) y[i] -= d * q[i];
+                }
+            }
+            double norm = 0.0;
+            for (int i = 0; i < m; i++) norm += y[i] * y[i];
+            norm = std::sqrt(norm);
+            if (norm > 1.0e-10) {
+                for (int i = 0; i < m; i++) y[i] /= norm;
+                columns.push_back(y);
+            }
+        }
+    }
+    int c = columns.size();
+
+    // V = V Q on blocks of rows small enough for the new columns to stay in cache
+    int n = _lanczosVectors.size() / m;
+    constexpr int rows = 128;
+    MATH::parallel_for(MATH::partition_uniform(n), [&](int begin, int end) {
+        std::vector<double> block(c*rows);
+        for (int first = begin; first < end; first += rows) {
+            int length = std::min(rows, end - first);
+            std::fill(block.begin(), block.end(), 0.0);
+            for (int l = 0; l < m; l++) {
+                const double* v = &_lanczosVectors[static_cast<std::size_t>(l)*n + first];
+                for (int j = 0; j < c; j++) {
+                    double q = columns[j][l];
+                    double* out = &block[j*rows];
+                    for (int i = 0; i < length; i++) out[i] += q * v[i];
+                }
+            }
+            for (int j = 0; j < c; j++) {
+                std::copy(&block[j*rows], &block[j*rows] + length, &_lanczosVectors[static_cast<std::size_t>(j)*n + first]);
+            }
+        }
+    });
+
+    // T = Q^T T Q, the next vector couples to the window through the last row of Q
+    std::vector<double> TQ(m*c, 0.0);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < c; j++) {
+            for (int l = 0; l < m; l++) TQ[i*c + j] += _lanczosMatrix[i*m + l] * columns[j][l];
+        }
+    }
+    std::fill(_lanczosMatrix.begin(), _lanczosMatrix.end(), 0.0);
+    for (int i = 0; i < c; i++) {
+        for (int j = 0; j < c; j++) {
+            double sum = 0.0;
+            for (int l = 0; l < m; l++) sum += columns[i][l] * TQ[l*c + j];
+            _lanczosMatrix[i*m + j] = sum;
+        }
+    }
+    _lanczosCoupling.resize(c);
+    for (int j = 0; j < c; j++) _lanczosCoupling[j] = columns[j][m-1];
+    _lanczosSize = c;
+    _lanczosKnown = c;
+}
+
+template <class matrix>
+void MATH::deflated_conjugate_gradient<matrix>::update_deflation_space()
+{
+    if (_deflationSize <= 0) {
+        _W.clear();
+        return;
+    }
+
+    // Ritz vectors U of the window (M-orthonormal, U^T A U = diag(theta))
+    int m = _lanczosWindow;
+    int s = _lanczosKnown;
+    int nev = std::min(_deflationSize, s);
+    int n = _lanczosVectors.size() / m;
+    std::vector<double> eigenvalues;
+    std::vector<double> G(s*s);
+    for (int i = 0; i < s; i++) {
+        for (int j = 0; j < s; j++) G[i*s + j] = _lanczosMatrix[i*m + j];
+    }
+    std::vector<double> Y = symmetric_eigenvectors(G, s, eigenvalues);
+    std::vector<Vector> U(nev, Vector(n));
+    for (int j = 0; j < nev; j++) {
+        double* u = &U[j][0];
+        MATH::parallel_for(MATH::partition_uniform(n), [&](int begin, int end) {
+            for (int l = 0; l < s; l++) {
+                const double* v = &_lanczosVectors[static_cast<std::size_t>(l)*n];
+                double y = Y[l*s + j];
+                for (int i = begin; i < end; i++) u[i] += y * v[i];
+            }
+        });
+    }
+
+    // Rayleigh-Ritz on Z = [W, U]: Z^T A Z from W^T A W, (A W)^T U and theta, Z^T Z from inner products
+    int k = _W.size();
+    int z = k + nev;
+    auto basis = [&](int i) -> const Vector& { return i < k ? _W[i] : U[i - k]; };
+    std::vector<double> A(z*z, 0.0);
+    std::vector<double> F(z*z, 0.0);
+    for (int i = 0; i < z; i++) {
+        for (int j = 0; j <= i; j++) {
+            if (i < k) A[i*z + j] = _galerkin[i*k + j];
+            else if (j < k) A[i*z + j] = _AW[j] * U[i - k];
+            else if (i == j) A[i*z + j] = eigenvalues[i - k];
+            A[j*z + i] = A[i*z + j];
+            F[i*z + j] = F[j*z + i] = basis(i) * basis(j);
+        }
+    }
+
+    // Generalized problem A y = theta F y on the numerically independent part of span Z
+    std::vector<double> normEigenvalues;
+    std::vector<double> VF = symmetric_eigenvectors(F, z, normEigenvalues);
+    std::vector<int> kept;
+    for (int j = 0; j < z; j++) {
+        if (normEigenvalues[j] > 1.0e-12 * normEigenvalues[z-1]) kept.push_back(j);
+    }
+    int r = kept.size();
+    std::vector<double> B(z*r);
+    for (int i = 0; i < z; i++) {
+        for (int j = 0; j < r; j++) B[i*r + j] = VF[i*z + kept[j]] / std::sqrt(normEigenvalues[kept[j]]);
+    }
+    std::vector<double> C(r*r, 0.0);
+    for (int i = 0; i < r; i++) {
+        for (int j = 0; j < r; j++) {
+            for (int a = 0; a < z; a++) {
+                for (int b = 0; b < z; b++) C[i*r + j] += B[a*r + i] * A[a*z + b] * B[b*r + j];
+            }
+        }
+    }
+    std::vector<double> ritzValues;
+    std::vector<double> X = symmetric_eigenvectors(C, r, ritzValues);
+
+    // Next W: the Ritz vectors of the smallest Ritz values (unit norm)
+    int kNew = std::min(_deflationSize, r);
+    std::vector<Vector> W(kNew, Vector(n));
+    for (int j = 0; j < kNew; j++) {
+        for (int a = 0; a < z; a++) {
+            double y = 0.0;
+            for (int i = 0; i < r; i++) y += B[a*r + i] * X[i*r + j];
+            W[j].axpy(y, basis(a));
+        }
+        W[j].scale(1.0 / W[j].getL2Norm());
+    }
+    _W = std::move(W);
+}
+
+// Explicity Template Instantiation
+template class MATH::deflated_conjugate_gradient<MATH::matrixCSR>;
+template class MATH::deflated_conjugate_gradient<MATH::matrixAutotuned>;
+template class MATH::deflated_conjugate_gradient<MATH::linearOperator>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class chebyshev Implementation
+\*------------------------------------------------------------------------*/
+
+template <class matrix>
+bool MATH::chebyshev<matrix>::estimate_eigenvalues(unsigned maxIterations, double tolerance, bool widen)
+{
+    // PCG on A e = r from e = 0, the correction goes into x so the steps are not wasted
+    Vector& r = this->_r;
+    this->precondition(r, _z);
+    _d = _z;
+    double rz = r * _z;
+    std::vector<double> alphas;
+    std::vector<double> betas;
+    while (alphas.size() < static_cast<std::size_t>(_lanczosSteps) && this->_iterations < maxIterations)
+    {
+        this->_A->multiply(_d, _q);
+        double dq = _d * _q;
+        if (!(dq > 0.0)) {
+            // Without a single positive step there is no interval for the polynomial to target
+            if (alphas.empty()) {
+                throw std::runtime_error("Chebyshev eigenvalue estimate failed: the (preconditioned) matrix is not positive definite");
+            }
+            break;
+        }
+        double alpha = rz / dq;
+        this->_x.axpy(alpha, _d);
+        r.axpy(-alpha, _q);
+        alphas.push_back(alpha);
+        this->_iterations++;
+
+        this->_resid = r.getL2Norm();
+        if (this->_resid < tolerance) return true;
+
+        this->precondition(r, _z);
+        double rz_new = r * _z;
+        betas.push_back(rz_new / rz);
+        _d.xpay(_z, betas.back());
+        rz = rz_new;
+    }
+
+    // No iterations left for an estimate (the bounds stay as they are)
+    int m = alphas.size();
+    if (m == 0) return false;
+
+    // Lanczos tridiagonal of M^-1 A from the CG coefficients, its Ritz values bound the spectrum from inside
+    std::vector<double> T(m*m, 0.0);
+    for (int j = 0; j < m; j++) {
+        T[j*m + j] = 1.0 / alphas[j] + (j > 0 ? betas[j-1] / alphas[j-1] : 0.0);
+        if (j + 1 < m) {
+            T[j*m + j + 1] = std::sqrt(betas[j]) / alphas[j];
+            T[(j+1)*m + j] = T[j*m + j + 1];
+        }
+    }
+    std::vector<double> ritzValues;
+    symmetric_eigenvectors(T, m, ritzValues);
+
+    // The largest Ritz value underestimates lambda_max and the iteration diverges on modes above the
+    //      interval, so it is pushed out. Modes below the smallest Ritz value still converge (slower).
+    double lambdaMin = ritzValues.front();
+    double lambdaMax = 1.1 * ritzValues.back();
+    if (widen) {
+        lambdaMin = std::min(lambdaMin, _lambdaMin);
+        lambdaMax = std::max(lambdaMax, _lambdaMax);
+    }
+    _lambdaMin = lambdaMin;
+    _lambdaMax = lambdaMax;
+    _estimated = true;
+    _estimates++;
+    _solvesSinceEstimate = 0;
+    return false;
+}
+
+template <class matrix>
+const MATH::Vector& MATH::chebyshev<matrix>::solve(unsigned maxIterations, double tolerance)
+{
+    this->_iterations = 0;
+    this->check_inputs();
+
+    // check for trivial case
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
+    }
+
+    // Workspace kept between solves
+    int n = this->_x.size();
+    Vector& r = this->_r;
+    this->reserve(r, n);
+    this->reserve(_d, n);
+    this->reserve(_q, n);
+    this->reserve(_z, n);
+    this->setup_preconditioner();
+
+    // Get initial residual
+    this->_A->multiply(this->_x, r);
+    r.xpay(*this->_b, -1.0);
+    this->_resid = r.getL2Norm();
+    if (this->_resid < tolerance) {
+        return this->_x;
+    }
+
+    // Nothing to do without an iteration budget, the residual of the guess is reported
+    if (maxIterations == 0) {
+        return this->_x;
+    }
+
+    // Eigenvalue estimate of the first solve, then every _estimateInterval solves
+    if (!_estimated || (_estimateInterval > 0 && _solvesSinceEstimate >= _estimateInterval)) {
+        if (estimate_eigenvalues(maxIterations, tolerance, false)) return this->_x;
+    }
+    _solvesSinceEstimate++;
+
+    // See Saad Alg. 12.1: with theta, delta the center and half width of [lambda_min, lambda_max]
+    //      d_0 = z_0 / theta,  d_k = rho_k rho_{k-1} d_{k-1} + 2 rho_k / delta z_k,  rho_k = 1 / (2 sigma - rho_{k-1})
+    //      The residual polynomial after k steps is bounded by 1/T_k(sigma) = rho_0 rho_1 ... rho_{k-1}.
+    double theta, delta, sigma, rho, bound, restartResid;
+    bool restart = true;
+    int sinceCheck = 0;
+    while (this->_iterations < maxIterations)
+    {
+        this->precondition(r, _z);
+        if (restart) {
+            theta = (_lambdaMax + _lambdaMin) / 2.0;
+            delta = (_lambdaMax - _lambdaMin) / 2.0;
+            sigma = theta / delta;
+            rho = 1.0 / sigma;
+            bound = 1.0;
+            restartResid = this->_resid;
+            _d = _z;
+            _d.scale(1.0 / theta);
+            restart = false;
+        }
+        else {
+            double rho_new = 1.0 / (2.0*sigma - rho);
+            _d.scale(rho_new * rho);
+            _d.axpy(2.0 * rho_new / delta, _z);
+            rho = rho_new;
+        }
+        bound *= rho;
+        this->_x.axpy(1.0, _d);
+        this->_A->multiply(_d, _q);
+        r.axpy(-1.0, _q);
+        this->_iterations++;
+
+        // The residual norm is the only reduction of the iteration
+        if (++sinceCheck < _checkInterval) continue;
+        sinceCheck = 0;
+        this->_resid = r.getL2Norm();
+        if (this->_resid < tolerance) {
+            return this->_x;
+        }
+        // Far less reduction than the bound (or a growing residual) means the interval misses part of the
+        //      spectrum: lambda_max is too small for this matrix or the residual is left in modes below
+        //      lambda_min. Lanczos on that residual finds them, the interval is widened to cover them.
+        if (this->_resid > restartResid * std::sqrt(bound)) {
+            if (estimate_eigenvalues(maxIterations, tolerance, true)) return this->_x;
+            restart = true;
+        }
+    }
+    this->_resid = r.getL2Norm();
+    return this->_x;
+}
+
+// Explicity Template Instantiation
+template class MATH::chebyshev<MATH::matrixCSR>;
+template class MATH::chebyshev<MATH::matrixAutotuned>;
+template class MATH::chebyshev<MATH::linearOperator>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class bicgstab Implementation
+\*------------------------------------------------------------------------*/
+
+template <class matrix>
+const MATH::Vector& MATH::bicgstab<matrix>::solve(unsigned maxIterations, double tolerance)
+{
+    this->_iterations = 0;
+    this->check_inputs();
+
+    // check for trivial case
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
+    }
+
+    this->setup_preconditioner();
+
+    // Workspace kept between solves
+    int n = this->_x.size();
+    Vector& r = this->_r;
+    for (Vector* v : {&r, &_r_hat, &_p, &_v, &_p_hat, &_s, &_s_hat, &_t}) {
+        this->reserve(*v, n);
+    }
+
+    // Get initial residual, shadow residual is kept fixed
+    this->_A->multiply(this->_x, r);
+    r.xpay(*this->_b, -1.0);
+    _r_hat = r;
+    for (int i = 0; i < n; i++) {
+        _p[i] = 0.0;
+        _v[i] = 0.0;
+    }
+    double rho = 1.0;
+    double alpha = 1.0;
+    double omega = 1.0;
+    double rho_new;
+    double beta;
+
+    this->_resid = r.getL2Norm();
+    while ( this->_iterations < maxIterations && this->_resid >= tolerance )
+    {
+        rho_new = _r_hat * r;
+        if (rho_new == 0.0) {
+            break;  // breakdown, r is orthogonal to the shadow residual
+        }
+
+        // p = r + beta (p - omega v)
+        beta = (rho_new / rho) * (alpha / omega);
+        _p.axpy(-omega, _v);
+        _p.xpay(r, beta);
+
+        this->precondition(_p, _p_hat);
+        this->_A->multiply(_p_hat, _v);
+        alpha = rho_new / (_r_hat * _v);
+
+        // Half step
+        _s = r;
+        _s.axpy(-alpha, _v);
+        this->_iterations++;
+        if (_s.getL2Norm() < tolerance) {
+            this->_x.axpy(alpha, _p_hat);
+            this->_resid = _s.getL2Norm();
+            break;
+        }
+
+        // Stabilizing step
+        this->precondition(_s, _s_hat);
+        this->_A->multiply(_s_hat, _t);
+        omega = (_t * _s) / (_t * _t);
+        this->_x.axpy(alpha, _p_hat);
+        this->_x.axpy(omega, _s_hat);
+        r = _s;
+        r.axpy(-omega, _t);
+        this->_resid = r.getL2Norm();
+        rho = rho_new;
+
+        if (omega == 0.0) {
+            break;  // stagnation
+        }
+    }
+    return this->_x;
+}
+
+// Explicity Template Instantiation
+template class MATH::bicgstab<MATH::matrixCSR>;
+template class MATH::bicgstab<MATH::matrixAutotuned>;
+template class MATH::bicgstab<MATH::matrixSELL>;
+template class MATH::bicgstab<MATH::matrixCSRFloat>;
+template class MATH::bicgstab<MATH::linearOperator>;
+template class MATH::bicgstab<MATH::matrixBSR<2>>;
+template class MATH::bicgstab<MATH::matrixBSR<3>>;
+template class MATH::bicgstab<MATH::matrixBSR<4>>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class gmres Implementation
+\*------------------------------------------------------------------------*/
+
+template <class matrix>
+const MATH::Vector& MATH::gmres<matrix>::solve(unsigned maxIterations, double tolerance)
+{
+    this->_iterations = 0;
+    this->check_inputs();
+
+    // check for trivial case
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
+    }
+
+    this->setup_preconditioner();
+
+    // Workspace kept between solves (reallocated only if the size or restart length changed)
+    int n = this->_x.size();
+    int m = _restart;
+    Vector& r = this->_r;
+    std::vector<Vector>& V = _V;
+    std::vector<std::vector<double>>& H = _H;
+    V.resize(m + 1);
+    H.resize(m + 1);
+    for (int i = 0; i <= m; i++) {
+        this->reserve(V[i], n);
+        H[i].assign(m, 0.0);
+    }
+    for (Vector* v : {&r, &_w, &_z, &_update}) {
+        this->reserve(*v, n);
+    }
+    _cs.resize(m);
+    _sn.resize(m);
+    _g.resize(m + 1);
+    _y.resize(m);
+
+    while ( this->_iterations < maxIterations )
+    {
+        // Restart from the true residual
+        this->_A->multiply(this->_x, r);
+        r.xpay(*this->_b, -1.0);
+        double beta = r.getL2Norm();
+        this->_resid = beta;
+        if (beta < tolerance) {
+            break;
+        }
+        for (int i = 0; i < n; i++) V[0][i] = r[i] / beta;
+        std::fill(_g.begin(), _g.end(), 0.0);
+        _g[0] = beta;
+
+        // Arnoldi process
+        int k = 0;
+        while ( k < m && this->_iterations < maxIterations )
+        {
+            this->precondition(V[k], _z);
+            this->_A->multiply(_z, _w);
+            for (int i = 0; i <= k; i++) {
+                H[i][k] = _w * V[i];
+                _w.axpy(-H[i][k], V[i]);
+            }
+            H[k+1][k] = _w.getL2Norm();
+
+            // Previous rotations on the new column, then eliminate H[k+1][k]
+            for (int i = 0; i < k; i++) {
+                double temp = _cs[i]*H[i][k] + _sn[i]*H[i+1][k];
+                H[i+1][k] = -_sn[i]*H[i][k] + _cs[i]*H[i+1][k];
+                H[i][k] = temp;
+            }
+            double denom = std::hypot(H[k][k], H[k+1][k]);
+            _cs[k] = denom > 0.0 ? H[k][k] / denom : 1.0;
+            _sn[k] = denom > 0.0 ? H[k+1][k] / denom : 0.0;
+            double h_next = H[k+1][k];
+            H[k][k] = denom;
+            H[k+1][k] = 0.0;
+            _g[k+1] = -_sn[k]*_g[k];
+            _g[k] = _cs[k]*_g[k];
+
+            k++;
+            this->_iterations++;
+            this->_resid = std::abs(_g[k]);
+            if (this->_resid < tolerance || h_next == 0.0) {
+                break;  // converged (or lucky breakdown)
+            }
+            for (int i = 0; i < n; i++) V[k][i] = _w[i] / h_next;
+        }
+
+        // Least squares update x += M^-1 V y with H y = g
+        for (int i = k-1; i >= 0; i--) {
+            _y[i] = _g[i];
+            for (int j = i+1; j < k; j++) _y[i] -= H[i][j] * _y[j];
+            _y[i] /= H[i][i];
+        }
+        for (int i = 0; i < n; i++) _update[i] = 0.0;
+        for (int i = 0; i < k; i++) {
+            _update.axpy(_y[i], V[i]);
+        }
+        this->precondition(_update, _z);
+        this->_x.axpy(1.0, _z);
+
+        if (this->_resid < tolerance) {
+            break;
+        }
+    }
+    return this->_x;
+}
+
+// Explicity Template Instantiation
+template class MATH::gmres<MATH::matrixCSR>;
+template class MATH::gmres<MATH::matrixAutotuned>;
+template class MATH::gmres<MATH::matrixSELL>;
+template class MATH::gmres<MATH::matrixCSRFloat>;
+template class MATH::gmres<MATH::linearOperator>;
+template class MATH::gmres<MATH::matrixBSR<2>>;
+template class MATH::gmres<MATH::matrixBSR<3>>;
+template class MATH::gmres<MATH::matrixBSR<4>>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class mixed_precision_refinement Implementation
+\*------------------------------------------------------------------------*/
+
+namespace {
+
+// Hands the preconditioner of the outer (double precision) system to the inner solver,
+//      it is already set up on the double matrix so setup() has nothing to do
+template <class matrix>
+class forwarding_preconditioner
+:
+    public MATH::preconditioner_base<MATH::matrixCSRFloat>
+{
+public:
+    forwarding_preconditioner(std::shared_ptr<MATH::preconditioner_base<matrix>> M) : _M(M) {};
+
+    void setup(const MATH::matrixCSRFloat&) override {};
+    void apply(const MATH::Vector& r, MATH::Vector& z) const override { _M->apply(r, z); };
+
+private:
+    std::shared_ptr<MATH::preconditioner_base<matrix>> _M;
+};
+
+}
+
+template <class matrix>
+MATH::mixed_precision_refinement<matrix>::mixed_precision_refinement(linearSolverType innerSolver)
+:
+    linear_solver_base<matrix>()
+{
+    switch (innerSolver) {
+        case linearSolverType::conjugate_gradient: _inner = std::make_unique<conjugate_gradient<matrixCSRFloat>>(); break;
+        case linearSolverType::bicgstab:           _inner = std::make_unique<bicgstab<matrixCSRFloat>>(); break;
+        case linearSolverType::gmres:              _inner = std::make_unique<gmres<matrixCSRFloat>>(); break;
+        default: throw std::invalid_argument("mixed_precision_refinement: inner solver must be a Krylov solver");
+    }
+}
+
+template <class matrix>
+const MATH::Vector& MATH::mixed_precision_refinement<matrix>::solve(unsigned maxIterations, double tolerance)
+{
+    this->_iterations = 0;
+    _refinements = 0;
+    this->check_inputs();
+
+    // check for trivial case
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
+    }
+
+    // Round the current matrix to float (values only while the sparsity pattern is unchanged)
+    const matrixCSR& A = as_CSR(*this->_A);
+    if (_Af.get_pattern() == A.get_pattern()) {
+        _Af.update_values(A);
+    }
+    else {
+        _Af = matrixCSRFloat(A);
+    }
+    _inner->set_matrix(_Af);
+
+    this->setup_preconditioner();
+    if (this->_M) {
+        _inner->set_preconditioner(std::make_shared<forwarding_preconditioner<matrix>>(this->_M));
+    }
+    else {
+        _inner->set_preconditioner(nullptr);
+    }
+
+    int n = this->_x.size();
+    this->reserve(_correction, n);
+
+    // r = A x - b in double, the correction solves A d = b - A x in float
+    this->_resid = this->residual_norm();
+    while (this->_resid >= tolerance && this->_iterations < maxIterations)
+    {
+        this->_r.scale(-1.0);
+        for (int i = 0; i < n; i++) _correction[i] = 0.0;
+        _inner->set_rhs(this->_r);
+        _inner->set_guess(_correction);
+        const Vector& d = _inner->solve(maxIterations - this->_iterations, std::max(_innerReduction * this->_resid, 0.5 * tolerance));
+        this->_iterations += std::max(_inner->get_iterations(), 1);
+
+        this->_x += d;
+        _refinements++;
+
+        // Stop once the float matrix cannot reduce the residual any further (the last correction is undone)
+        double resid = this->residual_norm();
+        if (resid >= this->_resid) {
+            this->_x -= d;
+            break;
+        }
+        this->_resid = resid;
+    }
+
+    return this->_x;
+}
+
+// Explicity Template Instantiation
+template class MATH::mixed_precision_refinement<MATH::matrixCSR>;
+template class MATH::mixed_precision_refinement<MATH::matrixAutotuned>;
+
+
+// * * * * * * * * * * * * * *  make_linear_solver * * * * * * * * * * * * * * * //
+template <class matrix>
+std::unique_ptr<MATH::linear_solver_base<matrix>> MATH::make_linear_solver(linearSolverType type)
+{
+    switch (type) {
+        case linearSolverType::jacobi:             return std::make_unique<jacobi<matrix>>();
+        case linearSolverType::conjugate_gradient: return std::make_unique<conjugate_gradient<matrix>>();
+        case linearSolverType::bicgstab:           return std::make_unique<bicgstab<matrix>>();
+        case linearSolverType::gmres:              return std::make_unique<gmres<matrix>>();
+        case linearSolverType::multicolor_gauss_seidel: return std::make_unique<multicolor_gauss_seidel<matrix>>();
+        case linearSolverType::sor:                return std::make_unique<sor<matrix>>();
+        case linearSolverType::ssor:               return std::make_unique<ssor<matrix>>();
+        case linearSolverType::mixed_precision:    return std::make_unique<mixed_precision_refinement<matrix>>(linearSolverType::bicgstab);
+        case linearSolverType::deflated_conjugate_gradient: return std::make_unique<deflated_conjugate_gradient<matrix>>();
+        case linearSolverType::chebyshev:          return std::make_unique<chebyshev<matrix>>();
+        case linearSolverType::direct_cholesky:    return std::make_unique<sparse_direct<matrix>>(directFactorization::cholesky);
+        case linearSolverType::direct_lu:          return std::make_unique<sparse_direct<matrix>>(directFactorization::lu);
+        default:                                   return std::make_unique<gauss_seidel<matrix>>();
+    }
+}
+
+// Explicity Template Instantiation
+template std::unique_ptr<MATH::linear_solver_base<MATH::matrixCSR>> MATH::make_linear_solver<MATH::matrixCSR>(linearSolverType);
+template std::unique_ptr<MATH::linear_solver_base<MATH::matrixAutotuned>> MATH::make_linear_solver<MATH::matrixAutotuned>(linearSolverType);
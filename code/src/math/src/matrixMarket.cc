@@ -0,0 +1,174 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      matrixMarket.cc
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     Implementation of Matrix Market reading and writing
+**
+\*------------------------------------------------------------------------*/
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+#include <cctype>
+
+#include "matrixMarket.hh"
+
+
+namespace {
+
+// Banner of a Matrix Market file: "%%MatrixMarket matrix <format> <field> <symmetry>"
+struct matrixMarketHeader
+{
+    std::string format;
+    std::string field;
+    std::string symmetry;
+};
+
+std::ifstream open_for_reading(const std::filesystem::path& file)
+{
+    std::ifstream in(file);
+    if (!in) throw std::runtime_error("Matrix Market: could not open " + file.string());
+    return in;
+}
+
+std::ofstream open_for_writing(const std::filesystem::path& file)
+{
+    std::ofstream out(file);
+    if (!out) throw std::runtime_error("Matrix Market: could not create " + file.string());
+    // Enough digits to read back the same doubles
+    out.precision(std::numeric_limits<double>::max_digits10);
+    return out;
+}
+
+// Read the banner, skip the comments and leave the stream on the size line
+matrixMarketHeader read_header(std::istream& in, const std::filesystem::path& file)
+{
+    std::string line;
+    std::getline(in, line);
+    std::istringstream banner(line);
+    std::string tag, object;
+    matrixMarketHeader header;
+    banner >> tag >> object >> header.format >> header.field >> header.symmetry;
+    for (std::string* s : {&object, &header.format, &header.field, &header.symmetry}) {
+        std::transform(s->begin(), s->end(), s->begin(), [](unsigned char c) { return std::tolower(c); });
+    }
+
+    if (tag != "%%MatrixMarket" || object != "matrix") {
+        throw std::runtime_error("Matrix Market: missing banner in " + file.string());
+    }
+    if (header.format != "coordinate" && header.format != "array") {
+        throw std::runtime_error("Matrix Market: unknown format '" + header.format + "' in " + file.string());
+    }
+    if (header.field != "real" && header.field != "integer" && header.field != "double") {
+        throw std::runtime_error("Matrix Market: unsupported field '" + header.field + "' in " + file.string());
+    }
+    if (header.symmetry != "general" && header.symmetry != "symmetric") {
+        throw std::runtime_error("Matrix Market: unsupported symmetry '" + header.symmetry + "' in " + file.string());
+    }
+
+    while (in.peek() == '%') std::getline(in, line);
+    return header;
+}
+
+}
+
+
+// * * * * * * * * * * * * * *  write matrix * * * * * * * * * * * * * * * //
+void MATH::write_matrix_market(const std::filesystem::path& file, const matrixCSR& A)
+{
+    std::ofstream out = open_for_writing(file);
+    const std::vector<int>& rows = A.get_row_indices();
+    const std::vector<int>& columns = A.get_column_indices();
+    const std::vector<double>& values = A.get_values();
+
+    out << "%%MatrixMarket matrix coordinate real general\n";
+    out << A.get_num_rows() << " " << A.get_num_columns() << " " << values.size() << "\n";
+    for (int i = 0; i < A.get_num_rows(); i++) {
+        for (int k = rows[i]; k < rows[i+1]; k++) {
+            out << i+1 << " " << columns[k]+1 << " " << values[k] << "\n";
+        }
+    }
+    if (!out) throw std::runtime_error("Matrix Market: failed writing " + file.string());
+}
+
+
+// * * * * * * * * * * * * * *  write vector * * * * * * * * * * * * * * * //
+void MATH::write_matrix_market(const std::filesystem::path& file, const Vector& v)
+{
+    std::ofstream out = open_for_writing(file);
+
+    out << "%%MatrixMarket matrix array real general\n";
+    out << v.size() << " 1\n";
+    for (unsigned i = 0; i < v.size(); i++) {
+        out << v[i] << "\n";
+    }
+    if (!out) throw std::runtime_error("Matrix Market: failed writing " + file.string());
+}
+
+
+// * * * * * * * * * * * * * *  read matrix * * * * * * * * * * * * * * * //
+MATH::matrixCSR MATH::read_matrix_market_matrix(const std::filesystem::path& file)
+{
+    std::ifstream in = open_for_reading(file);
+    matrixMarketHeader header = read_header(in, file);
+    if (header.format != "coordinate") {
+        throw std::runtime_error("Matrix Market: dense 'array' matrices are not supported in " + file.string());
+    }
+
+    int num_rows, num_columns, nnz;
+    if (!(in >> num_rows >> num_columns >> nnz)) {
+        throw std::runtime_error("Matrix Market: bad size line in " + file.string());
+    }
+
+    bool symmetric = (header.symmetry == "symmetric");
+    matrixCOO triplets(num_rows, num_columns);
+    triplets.reserve(symmetric ? 2*nnz : nnz);
+    int i, j;
+    double value;
+    for (int k = 0; k < nnz; k++) {
+        if (!(in >> i >> j >> value) || i < 1 || i > num_rows || j < 1 || j > num_columns) {
+            throw std::runtime_error("Matrix Market: bad entry " + std::to_string(k+1) + " in " + file.string());
+        }
+        triplets.add_value(i-1, j-1, value);
+        // Only the lower triangle of symmetric matrices is stored
+        if (symmetric && i != j) triplets.add_value(j-1, i-1, value);
+    }
+    return triplets.to_CSR();
+}
+
+
+// * * * * * * * * * * * * * *  read vector * * * * * * * * * * * * * * * //
+MATH::Vector MATH::read_matrix_market_vector(const std::filesystem::path& file)
+{
+    std::ifstream in = open_for_reading(file);
+    matrixMarketHeader header = read_header(in, file);
+
+    int num_rows, num_columns;
+    if (!(in >> num_rows >> num_columns) || num_columns != 1) {
+        throw std::runtime_error("Matrix Market: expected a one column matrix in " + file.string());
+    }
+
+    Vector v(num_rows);
+    if (header.format == "array") {
+        for (int i = 0; i < num_rows; i++) {
+            if (!(in >> v[i])) throw std::runtime_error("Matrix Market: bad entry " + std::to_string(i+1) + " in " + file.string());
+        }
+        return v;
+    }
+
+    int nnz, i, j;
+    double value;
+    if (!(in >> nnz)) throw std::runtime_error("Matrix Market: bad size line in " + file.string());
+    for (int k = 0; k < nnz; k++) {
+        if (!(in >> i >> j >> value) || i < 1 || i > num_rows || j != 1) {
+            throw std::runtime_error("Matrix Market: bad entry " + std::to_string(k+1) + " in " + file.string());
+        }
+        v[i-1] += value;
+    }
+    return v;
+}
@@ -0,0 +1,617 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      preconditioners.cc
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     Implementation for preconditioners
+**
+\*------------------------------------------------------------------------*/
+
+#include "preconditioners.hh"
+#include "threadPool.hh"
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <type_traits>
+
+
+namespace {
+
+// * * * * * * * * * * * * * *  aggregate * * * * * * * * * * * * * * * //
+// Greedy aggregation on the strength graph (Vanek, Mandel, Brezina):
+//      1. nodes whose strong neighbours are all free form an aggregate with them
+//      2. remaining nodes join an aggregate of a strong neighbour
+//      3. leftovers form aggregates with their free strong neighbours (or alone)
+//  Returns the aggregate of every node and sets num_aggregates
+std::vector<int> aggregate(const MATH::matrixCSR& A, double theta, int& num_aggregates)
+{
+    const std::vector<int>& rows = A.get_row_indices();
+    const std::vector<int>& cols = A.get_column_indices();
+    const std::vector<double>& values = A.get_values();
+    const MATH::diagonalView D = A.diagonal();
+    int n = A.get_num_rows();
+
+    auto strong = [&](int i, int k) {
+        int j = cols[k];
+        return j != i && std::abs(values[k]) >= theta * std::sqrt(std::abs(D[i] * D[j]));
+    };
+
+    std::vector<int> aggregates(n, -1);
+    num_aggregates = 0;
+
+    // Phase 1: root nodes with a free neighbourhood
+    for (int i = 0; i < n; i++) {
+        if (aggregates[i] >= 0) continue;
+        bool free = true;
+        bool hasStrong = false;
+        for (int k = rows[i]; k < rows[i+1]; k++) {
+            if (!strong(i, k)) continue;
+            hasStrong = true;
+            if (aggregates[cols[k]] >= 0) { free = false; break; }
+        }
+        if (!free || !hasStrong) continue;
+
+        aggregates[i] = num_aggregates;
+        for (int k = rows[i]; k < rows[i+1]; k++) {
+            if (strong(i, k)) aggregates[cols[k]] = num_aggregates;
+        }
+        num_aggregates++;
+    }
+
+    // Phase 2: attach to a neighbouring aggregate from phase 1
+    std::vector<int> phase1(aggregates);
+    for (int i = 0; i < n; i++) {
+        if (aggregates[i] >= 0) continue;
+        for (int k = rows[i]; k < rows[i+1]; k++) {
+            if (strong(i, k) && phase1[cols[k]] >= 0) {
+                aggregates[i] = phase1[cols[k]];
+                break;
+            }
+        }
+    }
+
+    // Phase 3: leftovers
+    for (int i = 0; i < n; i++) {
+        if (aggregates[i] >= 0) continue;
+        aggregates[i] = num_aggregates;
+        for (int k = rows[i]; k < rows[i+1]; k++) {
+            if (strong(i, k) && aggregates[cols[k]] < 0) aggregates[cols[k]] = num_aggregates;
+        }
+        num_aggregates++;
+    }
+
+    return aggregates;
+}
+
+
+// * * * * * * * * * * * * * *  tentative_prolongator * * * * * * * * * * * * * * * //
+// Piecewise constant interpolation of the near null space (constants), columns normalized
+MATH::matrixCSR tentative_prolongator(const std::vector<int>& aggregates, int num_aggregates)
+{
+    int n = aggregates.size();
+    std::vector<int> sizes(num_aggregates, 0);
+    for (int a : aggregates) sizes[a]++;
+
+    MATH::matrixCOO triplets(n, num_aggregates);
+    triplets.reserve(n);
+    for (int i = 0; i < n; i++) {
+        triplets.add_value(i, aggregates[i], 1.0 / std::sqrt(static_cast<double>(sizes[aggregates[i]])));
+    }
+    return triplets.to_CSR();
+}
+
+}
+
+
+/*------------------------------------------------------------------------*\
+**  Class jacobi_preconditioner Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  setup * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::jacobi_preconditioner<matrix>::setup(const matrix& A)
+{
+    auto invert = [this](const auto& D) {
+        int n = D.size();
+        _inverseDiagonal.resize(n);
+        for (int i = 0; i < n; i++) {
+            _inverseDiagonal[i] = D[i] != 0.0 ? 1.0 / D[i] : 1.0;
+        }
+    };
+
+    if constexpr (std::is_base_of_v<linearOperator, matrix>) {
+        invert(A.get_diagonal());
+    }
+    else {
+        invert(as_CSR(A).diagonal());
+    }
+}
+
+
+// * * * * * * * * * * * * * *  apply * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::jacobi_preconditioner<matrix>::apply(const Vector& r, Vector& z) const
+{
+    assert(z.size() == r.size() && "jacobi_preconditioner: z must be sized like r");
+    MATH::parallel_for(MATH::partition_uniform(r.size()), [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            z[i] = _inverseDiagonal[i] * r[i];
+        }
+    });
+}
+
+// Explicity Template Instantiation
+template class MATH::jacobi_preconditioner<MATH::matrixCSR>;
+template class MATH::jacobi_preconditioner<MATH::matrixAutotuned>;
+template class MATH::jacobi_preconditioner<MATH::linearOperator>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class ic0_preconditioner Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  setup * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::ic0_preconditioner<matrix>::setup(const matrix& M)
+{
+    const matrixCSR& A = as_CSR(M);
+    const std::vector<int>& rows = A.get_row_indices();
+    const std::vector<int>& cols = A.get_column_indices();
+    const std::vector<double>& values = A.get_values();
+    int n = A.get_num_rows();
+
+    // Symbolic phase: lower triangle of A, including the diagonal
+    if (A.get_pattern() != _pattern) {
+        std::vector<int> row_indices(n + 1, 0);
+        std::vector<int> column_indices;
+        _sourceSlots.clear();
+        for (int i = 0; i < n; i++) {
+            for (int k = rows[i]; k < rows[i+1] && cols[k] <= i; k++) {
+                column_indices.push_back(cols[k]);
+                _sourceSlots.push_back(k);
+            }
+            assert(!column_indices.empty() && column_indices.back() == i && "IC(0) needs every diagonal entry");
+            row_indices[i+1] = column_indices.size();
+        }
+        _L = matrixCSR(std::make_shared<sparsityPattern>(n, n, std::move(row_indices), std::move(column_indices)));
+        _pattern = A.get_pattern();
+    }
+
+    // Numeric phase: row-by-row factorization on the fixed pattern
+    const std::vector<int>& l_rows = _L.get_row_indices();
+    const std::vector<int>& l_cols = _L.get_column_indices();
+    std::vector<double>& L = _L.get_values();
+    for (std::size_t k = 0; k < L.size(); k++) {
+        L[k] = values[_sourceSlots[k]];
+    }
+    for (int i = 0; i < n; i++) {
+        int diag = l_rows[i+1] - 1;
+        for (int k = l_rows[i]; k < diag; k++) {
+            int j = l_cols[k];
+            // L_ij = (a_ij - sum_m L_im L_jm) / L_jj over the common columns m < j
+            double sum = L[k];
+            int a = l_rows[i];
+            int b = l_rows[j];
+            int b_end = l_rows[j+1] - 1;
+            while (a < k && b < b_end) {
+                if (l_cols[a] == l_cols[b]) sum -= L[a++] * L[b++];
+                else if (l_cols[a] < l_cols[b]) a++;
+                else b++;
+            }
+            L[k] = sum / L[b_end];
+        }
+
+        double pivot = L[diag];
+        for (int k = l_rows[i]; k < diag; k++) {
+            pivot -= L[k] * L[k];
+        }
+        double a_ii = values[_sourceSlots[diag]];
+        if (pivot <= 1e-12 * std::abs(a_ii)) {
+            pivot = std::abs(a_ii) > 0.0 ? std::abs(a_ii) : 1.0;
+        }
+        L[diag] = std::sqrt(pivot);
+    }
+}
+
+
+// * * * * * * * * * * * * * *  apply * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::ic0_preconditioner<matrix>::apply(const Vector& r, Vector& z) const
+{
+    const std::vector<int>& rows = _L.get_row_indices();
+    const std::vector<int>& cols = _L.get_column_indices();
+    const std::vector<double>& L = _L.get_values();
+    int n = r.size();
+
+    // L y = r
+    z = r;
+    for (int i = 0; i < n; i++) {
+        int diag = rows[i+1] - 1;
+        double sum = z[i];
+        for (int k = rows[i]; k < diag; k++) sum -= L[k] * z[cols[k]];
+        z[i] = sum / L[diag];
+    }
+    // L^T z = y (column sweep over the rows of L)
+    for (int i = n-1; i >= 0; i--) {
+        int diag = rows[i+1] - 1;
+        z[i] /= L[diag];
+        for (int k = rows[i]; k < diag; k++) z[cols[k]] -= L[k] * z[i];
+    }
+}
+
+// Explicity Template Instantiation
+template class MATH::ic0_preconditioner<MATH::matrixCSR>;
+template class MATH::ic0_preconditioner<MATH::matrixAutotuned>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class ssor_preconditioner Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  apply * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::ssor_preconditioner<matrix>::apply(const Vector& r, Vector& z) const
+{
+    assert(_A != nullptr && "ssor_preconditioner: setup() must be called before apply()");
+    const std::vector<int>& rows = _A->get_row_indices();
+    const std::vector<int>& cols = _A->get_column_indices();
+    const std::vector<double>& values = _A->get_values();
+    const diagonalView D = _A->diagonal();
+    int n = r.size();
+
+    assert(z.size() == r.size() && "ssor_preconditioner: z must be sized like r");
+
+    // (D/w + L) y = r
+    for (int i = 0; i < n; i++) {
+        double sum = r[i];
+        for (int k = rows[i]; k < rows[i+1] && cols[k] < i; k++) sum -= values[k] * z[cols[k]];
+        z[i] = sum * _omega / D[i];
+    }
+    // (D/w + U) z = (D/w) y, scaled by (2-w)/w
+    for (int i = n-1; i >= 0; i--) {
+        double sum = D[i] / _omega * z[i];
+        for (int k = rows[i+1]-1; k >= rows[i] && cols[k] > i; k--) sum -= values[k] * z[cols[k]];
+        z[i] = sum * _omega / D[i];
+    }
+    double scale = (2.0 - _omega) / _omega;
+    for (int i = 0; i < n; i++) z[i] *= scale;
+}
+
+// Explicity Template Instantiation
+template class MATH::ssor_preconditioner<MATH::matrixCSR>;
+template class MATH::ssor_preconditioner<MATH::matrixAutotuned>;
+
+
+/*------------------------------------------------------------------------*\
+**  Class amg_preconditioner Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  setup * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::amg_preconditioner<matrix>::setup(const matrix& M)
+{
+    const matrixCSR& A = as_CSR(M);
+
+    // Same pattern as the existing hierarchy: only the values change
+    if (_levels.empty() || A.get_pattern() != _levels[0].A.get_pattern()) {
+        symbolic_setup(A);
+    }
+    numeric_setup(A);
+}
+
+
+// * * * * * * * * * * * * * *  symbolic_setup * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::amg_preconditioner<matrix>::symbolic_setup(const matrixCSR& fine)
+{
+    _levels.clear();
+    _levels.emplace_back();
+    _levels[0].A = fine;
+    _symbolicSetups++;
+
+    while (static_cast<int>(_levels.size()) < _maxLevels && _levels.back().A.get_num_rows() > _coarseSize)
+    {
+        level& L = _levels.back();
+        int num_aggregates;
+        std::vector<int> aggregates = aggregate(L.A, _theta, num_aggregates);
+        if (num_aggregates == 0 || num_aggregates == L.A.get_num_rows()) break;
+
+        // Patterns of P = (I - w D^-1 A) T, R = P^T and A_c = R A P (values follow in numeric_setup)
+        L.T = tentative_prolongator(aggregates, num_aggregates);
+        L.P = multiply(L.A, L.T);
+        L.T_slots.resize(L.A.get_num_rows());
+        for (int i = 0; i < L.A.get_num_rows(); i++) {
+            L.T_slots[i] = L.P.get_pattern()->find(i, aggregates[i]);
+        }
+        L.R = transpose(L.P, &L.R_sources);
+        L.AP = multiply(L.A, L.P);
+        matrixCSR coarse = multiply(L.R, L.AP);
+
+        _levels.emplace_back();
+        _levels.back().A = coarse;
+    }
+}
+
+
+// * * * * * * * * * * * * * *  numeric_setup * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::amg_preconditioner<matrix>::numeric_setup(const matrixCSR& fine)
+{
+    _levels[0].A = fine;
+
+    int num_levels = _levels.size();
+    for (int l = 0; l < num_levels; l++)
+    {
+        level& L = _levels[l];
+        int n = L.A.get_num_rows();
+
+        // Cycle workspace (only allocates when the level size changed)
+        for (Vector* v : {&L.rhs, &L.x, &L.residual, &L.correction, &L.smootherWork}) {
+            if (v->size() != static_cast<unsigned>(n)) *v = Vector(n);
+        }
+
+        // Smoother diagonal
+        const diagonalView D = L.A.diagonal();
+        L.inverseDiagonal.resize(n);
+        for (int i = 0; i < n; i++) {
+            L.inverseDiagonal[i] = D[i] != 0.0 ? 1.0 / D[i] : 0.0;
+        }
+        if (l == num_levels - 1) break;
+
+        // Prolongator smoothing weight 4/3 / rho(D^-1 A), rho bounded by Gershgorin
+        const std::vector<int>& rows = L.A.get_row_indices();
+        const std::vector<double>& values = L.A.get_values();
+        double rho = 0.0;
+        for (int i = 0; i < n; i++) {
+            double sum = 0.0;
+            for (int k = rows[i]; k < rows[i+1]; k++) sum += std::abs(values[k]);
+            rho = std::max(rho, sum * std::abs(L.inverseDiagonal[i]));
+        }
+        L.spectralRadius = rho;
+        double omega = rho > 0.0 ? (4.0/3.0) / rho : 0.0;
+
+        // P = T - w D^-1 (A T)
+        multiply_values(L.A, L.T, L.P);
+        std::vector<double>& p = L.P.get_values();
+        const std::vector<int>& p_rows = L.P.get_row_indices();
+        const std::vector<double>& t = L.T.get_values();
+        for (int i = 0; i < n; i++) {
+            for (int k = p_rows[i]; k < p_rows[i+1]; k++) {
+                p[k] *= -omega * L.inverseDiagonal[i];
+            }
+            p[L.T_slots[i]] += t[i];
+        }
+
+        // R = P^T and the Galerkin product
+        std::vector<double>& r = L.R.get_values();
+        for (std::size_t k = 0; k < r.size(); k++) {
+            r[k] = p[L.R_sources[k]];
+        }
+        multiply_values(L.A, L.P, L.AP);
+        multiply_values(L.R, L.AP, _levels[l+1].A);
+    }
+
+    factor_coarse();
+}
+
+
+// * * * * * * * * * * * * * *  factor_coarse * * * * * * * * * * * * * * * //
+// NOTE: pressure correction matrices are singular (constant null space), pivots that vanish
+//       relative to the largest entry are flagged and the corresponding unknown is set to zero
+template <class matrix>
+void MATH::amg_preconditioner<matrix>::factor_coarse()
+{
+    const matrixCSR& A = _levels.back().A;
+    int n = A.get_num_rows();
+
+    _coarseLU.assign(n*n, 0.0);
+    const std::vector<int>& rows = A.get_row_indices();
+    const std::vector<int>& cols = A.get_column_indices();
+    const std::vector<double>& values = A.get_values();
+    double scale = 0.0;
+    for (int i = 0; i < n; i++) {
+        for (int k = rows[i]; k < rows[i+1]; k++) {
+            _coarseLU[i*n + cols[k]] = values[k];
+            scale = std::max(scale, std::abs(values[k]));
+        }
+    }
+
+    _coarsePivots.resize(n);
+    _coarseSingular.assign(n, false);
+    for (int k = 0; k < n; k++) {
+        int pivot = k;
+        for (int i = k+1; i < n; i++) {
+            if (std::abs(_coarseLU[i*n+k]) > std::abs(_coarseLU[pivot*n+k])) pivot = i;
+        }
+        _coarsePivots[k] = pivot;
+        if (pivot != k) {
+            for (int j = 0; j < n; j++) std::swap(_coarseLU[k*n+j], _coarseLU[pivot*n+j]);
+        }
+        if (std::abs(_coarseLU[k*n+k]) <= 1e-12 * scale) {
+            _coarseSingular[k] = true;
+            continue;
+        }
+        for (int i = k+1; i < n; i++) {
+            double factor = _coarseLU[i*n+k] / _coarseLU[k*n+k];
+            _coarseLU[i*n+k] = factor;
+            for (int j = k+1; j < n; j++) _coarseLU[i*n+j] -= factor * _coarseLU[k*n+j];
+        }
+    }
+}
+
+
+// * * * * * * * * * * * * * *  solve_coarse * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::amg_preconditioner<matrix>::solve_coarse(const Vector& b, Vector& x) const
+{
+    int n = b.size();
+    x = b;
+
+    // Forward substitution with the row swaps of the factorization
+    for (int k = 0; k < n; k++) {
+        std::swap(x[k], x[_coarsePivots[k]]);
+        if (_coarseSingular[k]) continue;
+        for (int i = k+1; i < n; i++) x[i] -= _coarseLU[i*n+k] * x[k];
+    }
+    // Back substitution
+    for (int k = n-1; k >= 0; k--) {
+        if (_coarseSingular[k]) { x[k] = 0.0; continue; }
+        for (int j = k+1; j < n; j++) x[k] -= _coarseLU[k*n+j] * x[j];
+        x[k] /= _coarseLU[k*n+k];
+    }
+}
+
+
+// * * * * * * * * * * * * * *  smooth * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::amg_preconditioner<matrix>::smooth(int l, Vector& x, const Vector& b, bool pre) const
+{
+    const level& L = _levels[l];
+    int n = L.A.get_num_rows();
+
+    if (_smoother == amgSmoother::jacobi) {
+        Vector& r = L.residual;
+        for (int s = 0; s < _sweeps; s++) {
+            L.A.multiply(x, r);
+            r.xpay(b, -1.0);
+            for (int i = 0; i < n; i++) x[i] += _jacobiWeight * L.inverseDiagonal[i] * r[i];
+        }
+        return;
+    }
+
+    if (_smoother == amgSmoother::chebyshev) {
+        // Target the upper part [rho/30, 1.1 rho] of the spectrum of D^-1 A, the coarse grid takes the rest
+        //      (the polynomial is symmetric in A, so pre and post smoothing are the same)
+        double upper = 1.1 * L.spectralRadius;
+        double lower = L.spectralRadius / 30.0;
+        double theta = (upper + lower) / 2.0;
+        double delta = (upper - lower) / 2.0;
+        double sigma = theta / delta;
+        Vector& r = L.residual;
+        Vector& d = L.correction;
+        Vector& Ad = L.smootherWork;
+        for (int s = 0; s < _sweeps; s++) {
+            L.A.multiply(x, r);
+            r.xpay(b, -1.0);
+            for (int i = 0; i < n; i++) d[i] = L.inverseDiagonal[i] * r[i] / theta;
+            double rho = 1.0 / sigma;
+            for (int k = 0; k < _chebyshevDegree; k++) {
+                x.axpy(1.0, d);
+                if (k == _chebyshevDegree - 1) break;
+                // r -= A d, then the three term recurrence of the Chebyshev polynomials
+                L.A.multiply(d, Ad);
+                r.axpy(-1.0, Ad);
+                double rho_new = 1.0 / (2.0*sigma - rho);
+                for (int i = 0; i < n; i++) {
+                    d[i] = rho_new * rho * d[i] + 2.0 * rho_new / delta * L.inverseDiagonal[i] * r[i];
+                }
+                rho = rho_new;
+            }
+        }
+        return;
+    }
+
+    // Gauss-Seidel: forward before and backward after the coarse correction keeps the cycle symmetric
+    const std::vector<int>& rows = L.A.get_row_indices();
+    const std::vector<int>& cols = L.A.get_column_indices();
+    const std::vector<double>& values = L.A.get_values();
+    auto relax = [&](int i) {
+        double sigma = b[i];
+        for (int k = rows[i]; k < rows[i+1]; k++) {
+            if (cols[k] != i) sigma -= values[k] * x[cols[k]];
+        }
+        x[i] = sigma * L.inverseDiagonal[i];
+    };
+
+    if (_smoother == amgSmoother::multicolor_gauss_seidel) {
+        const std::vector<int>& color_offsets = L.A.get_pattern()->get_color_offsets();
+        const std::vector<int>& color_rows = L.A.get_pattern()->get_color_rows();
+        int num_colors = color_offsets.size() - 1;
+        auto relax_color = [&](int c) {
+            const int* color = &color_rows[color_offsets[c]];
+            MATH::parallel_for(MATH::partition_uniform(color_offsets[c+1] - color_offsets[c]), [&](int begin, int end) {
+                for (int r = begin; r < end; r++) relax(color[r]);
+            });
+        };
+        for (int s = 0; s < _sweeps; s++) {
+            if (pre) {
+                for (int c = 0; c < num_colors; c++) relax_color(c);
+            }
+            else {
+                for (int c = num_colors-1; c >= 0; c--) relax_color(c);
+            }
+        }
+        return;
+    }
+
+    for (int s = 0; s < _sweeps; s++) {
+        if (pre) {
+            for (int i = 0; i < n; i++) relax(i);
+        }
+        else {
+            for (int i = n-1; i >= 0; i--) relax(i);
+        }
+    }
+}
+
+
+// * * * * * * * * * * * * * *  cycle * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::amg_preconditioner<matrix>::cycle(int l, const Vector& b, Vector& x) const
+{
+    if (l == static_cast<int>(_levels.size()) - 1) {
+        solve_coarse(b, x);
+        return;
+    }
+
+    const level& L = _levels[l];
+    const level& C = _levels[l+1];
+    int n = b.size();
+    for (int i = 0; i < n; i++) x[i] = 0.0;
+    smooth(l, x, b, true);
+
+    // Coarse grid correction, the restricted residual and the correction live on the coarse level
+    L.A.multiply(x, L.residual);
+    L.residual.xpay(b, -1.0);
+    L.R.multiply(L.residual, C.rhs);
+    cycle(l+1, C.rhs, C.x);
+    L.P.multiply(C.x, L.correction);
+    x.axpy(1.0, L.correction);
+
+    smooth(l, x, b, false);
+}
+
+
+// * * * * * * * * * * * * * *  apply * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::amg_preconditioner<matrix>::apply(const Vector& r, Vector& z) const
+{
+    assert(!_levels.empty() && "AMG preconditioner used before setup");
+    assert(z.size() == r.size() && "amg_preconditioner: z must be sized like r");
+    cycle(0, r, z);
+}
+
+// Explicity Template Instantiation
+template class MATH::amg_preconditioner<MATH::matrixCSR>;
+template class MATH::amg_preconditioner<MATH::matrixAutotuned>;
+
+
+// * * * * * * * * * * * * * *  make_preconditioner * * * * * * * * * * * * * * * //
+template <class matrix>
+std::shared_ptr<MATH::preconditioner_base<matrix>> MATH::make_preconditioner(preconditionerType type)
+{
+    switch (type) {
+        case preconditionerType::jacobi: return std::make_shared<jacobi_preconditioner<matrix>>();
+        case preconditionerType::ic0:    return std::make_shared<ic0_preconditioner<matrix>>();
+        case preconditionerType::ssor:   return std::make_shared<ssor_preconditioner<matrix>>();
+        case preconditionerType::amg:    return std::make_shared<amg_preconditioner<matrix>>();
+        default:                         return nullptr;
+    }
+}
+
+// Explicity Template Instantiation
+template std::shared_ptr<MATH::preconditioner_base<MATH::matrixCSR>> MATH::make_preconditioner<MATH::matrixCSR>(preconditionerType);
+template std::shared_ptr<MATH::preconditioner_base<MATH::matrixAutotuned>> MATH::make_preconditioner<MATH::matrixAutotuned>(preconditionerType);
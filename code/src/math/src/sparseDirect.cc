@@ -0,0 +1,483 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      sparseDirect.cc
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     Implementation of the sparse direct (Cholesky / LU) solvers
+**
+\*------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <stdexcept>
+
+#include "sparseDirect.hh"
+
+
+// * * * * * * * * * * * * * *  approximate_minimum_degree * * * * * * * * * * * * * * * //
+std::vector<int> MATH::approximate_minimum_degree(const matrixCSR& A)
+{
+    int n = A.get_num_rows();
+    const std::vector<int>& rows = A.get_row_indices();
+    const std::vector<int>& cols = A.get_column_indices();
+
+    // Quotient graph: variables adjacent to every variable, elements (eliminated pivots) adjacent to
+    //      every variable and the variables of every element, starting from the graph of A + A^T
+    std::vector<std::vector<int>> variables(n);
+    std::vector<std::vector<int>> elements(n);
+    std::vector<std::vector<int>> members(n);
+    for (int i = 0; i < n; i++) {
+        for (int k = rows[i]; k < rows[i+1]; k++) {
+            if (cols[k] == i) continue;
+            variables[i].push_back(cols[k]);
+            variables[cols[k]].push_back(i);
+        }
+    }
+
+    // Degree buckets: doubly linked lists of the variables of every approximate degree (degrees stay below n)
+    std::vector<int> degree(n);
+    std::vector<int> head(n, -1);
+    std::vector<int> next(n, -1);
+    std::vector<int> previous(n, -1);
+    int minDegree = n;
+    auto insert = [&](int i) {
+        int d = degree[i];
+        previous[i] = -1;
+        next[i] = head[d];
+        if (head[d] != -1) previous[head[d]] = i;
+        head[d] = i;
+        minDegree = std::min(minDegree, d);
+    };
+    auto remove = [&](int i) {
+        if (previous[i] != -1) next[previous[i]] = next[i];
+        else head[degree[i]] = next[i];
+        if (next[i] != -1) previous[next[i]] = previous[i];
+    };
+    for (int i = 0; i < n; i++) {
+        std::sort(variables[i].begin(), variables[i].end());
+        variables[i].erase(std::unique(variables[i].begin(), variables[i].end()), variables[i].end());
+        degree[i] = variables[i].size();
+    }
+    // Inserted from the back so that every bucket starts with its lowest index
+    for (int i = n-1; i >= 0; i--) insert(i);
+
+    std::vector<char> eliminated(n, 0);
+    std::vector<char> absorbed(n, 0);
+    std::vector<int> mark(n, -1);
+    // |L_e \ L_p| of the elements touching the current pivot p (valid where stamp[e] == p)
+    std::vector<int> external(n, 0);
+    std::vector<int> stamp(n, -1);
+    std::vector<int> order;
+    order.reserve(n);
+
+    while (static_cast<int>(order.size()) < n)
+    {
+        // Pivot of minimum approximate degree
+        while (head[minDegree] == -1) minDegree++;
+        int p = head[minDegree];
+        remove(p);
+        order.push_back(p);
+        eliminated[p] = 1;
+
+        // New element L_p = A_p + the variables of the elements of p, which are absorbed into it
+        std::vector<int>& Lp = members[p];
+        mark[p] = p;
+        for (int i : variables[p]) {
+            if (!eliminated[i] && mark[i] != p) {
+                mark[i] = p;
+                Lp.push_back(i);
+            }
+        }
+        for (int e : elements[p]) {
+            if (absorbed[e]) continue;
+            for (int i : members[e]) {
+                if (!eliminated[i] && mark[i] != p) {
+                    mark[i] = p;
+                    Lp.push_back(i);
+                }
+            }
+            absorbed[e] = 1;
+            std::vector<int>().swap(members[e]);
+        }
+        std::vector<int>().swap(variables[p]);
+        std::vector<int>().swap(elements[p]);
+
+        // Variables of L_p: p replaces the absorbed elements, variables now coupled through p are dropped
+        for (int i : Lp) {
+            std::erase_if(elements[i], [&](int e) { return absorbed[e] != 0; });
+            elements[i].push_back(p);
+            std::erase_if(variables[i], [&](int j) { return eliminated[j] || mark[j] == p; });
+        }
+
+        // |L_e \ L_p| of the other elements, counting down the variables they share with L_p
+        for (int i : Lp) {
+            for (int e : elements[i]) {
+                if (e == p) continue;
+                if (stamp[e] != p) {
+                    stamp[e] = p;
+                    external[e] = members[e].size();
+                }
+                external[e]--;
+            }
+        }
+
+        // Approximate external degree d_i = |A_i| + |L_p \ i| + sum |L_e \ L_p|, elements inside L_p are absorbed
+        //      and dropped from the element list in the same pass
+        int remaining = n - order.size();
+        for (int i : Lp) {
+            int d = variables[i].size() + Lp.size() - 1;
+            std::vector<int>& Ei = elements[i];
+            std::size_t kept = 0;
+            for (int e : Ei) {
+                if (absorbed[e]) continue;
+                if (e != p) {
+                    if (external[e] == 0) {
+                        absorbed[e] = 1;
+                        std::vector<int>().swap(members[e]);
+                        continue;
+                    }
+                    d += external[e];
+                }
+                Ei[kept++] = e;
+            }
+            Ei.resize(kept);
+            d = std::min({d, remaining - 1, degree[i] + static_cast<int>(Lp.size()) - 1});
+
+            remove(i);
+            degree[i] = d;
+            insert(i);
+        }
+    }
+    return order;
+}
+
+
+/*------------------------------------------------------------------------*\
+**  Class sparse_direct Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  symbolic_factorization * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::sparse_direct<matrix>::symbolic_factorization(const matrixCSR& A)
+{
+    int n = A.get_num_rows();
+    const std::vector<int>& rows = A.get_row_indices();
+    const std::vector<int>& cols = A.get_column_indices();
+
+    // Fill-reducing ordering
+    _order = approximate_minimum_degree(A);
+    _inverseOrder.assign(n, 0);
+    for (int i = 0; i < n; i++) _inverseOrder[_order[i]] = i;
+
+    // Slots of the permuted rows: (i,j) with j <= i goes to the lower part of row i,
+    //      (i,j) with j > i to the upper part of row j (column j above the diagonal)
+    _lowerOffsets.assign(n + 1, 0);
+    _upperOffsets.assign(n + 1, 0);
+    for (int old = 0; old < n; old++) {
+        int i = _inverseOrder[old];
+        for (int k = rows[old]; k < rows[old+1]; k++) {
+            int j = _inverseOrder[cols[k]];
+            if (j <= i) _lowerOffsets[i + 1]++;
+            else _upperOffsets[j + 1]++;
+        }
+    }
+    for (int i = 0; i < n; i++) {
+        _lowerOffsets[i + 1] += _lowerOffsets[i];
+        _upperOffsets[i + 1] += _upperOffsets[i];
+    }
+    _lowerSlots.resize(_lowerOffsets[n]);
+    _lowerIndices.resize(_lowerOffsets[n]);
+    _upperSlots.resize(_upperOffsets[n]);
+    _upperIndices.resize(_upperOffsets[n]);
+    std::vector<int> nextLower(_lowerOffsets.begin(), _lowerOffsets.end() - 1);
+    std::vector<int> nextUpper(_upperOffsets.begin(), _upperOffsets.end() - 1);
+    for (int old = 0; old < n; old++) {
+        int i = _inverseOrder[old];
+        for (int k = rows[old]; k < rows[old+1]; k++) {
+            int j = _inverseOrder[cols[k]];
+            if (j <= i) {
+                _lowerSlots[nextLower[i]] = k;
+                _lowerIndices[nextLower[i]++] = j;
+            }
+            else {
+                _upperSlots[nextUpper[j]] = k;
+                _upperIndices[nextUpper[j]++] = i;
+            }
+        }
+    }
+
+    // Elimination tree of the symmetrized permuted matrix (Liu, with path compression)
+    std::vector<int> parent(n, -1);
+    std::vector<int> ancestor(n, -1);
+    auto for_each_lower = [&](int i, auto&& visit) {
+        for (int s = _lowerOffsets[i]; s < _lowerOffsets[i+1]; s++) {
+            if (_lowerIndices[s] < i) visit(_lowerIndices[s]);
+        }
+        for (int s = _upperOffsets[i]; s < _upperOffsets[i+1]; s++) visit(_upperIndices[s]);
+    };
+    for (int i = 0; i < n; i++) {
+        for_each_lower(i, [&](int k) {
+            int r = k;
+            while (ancestor[r] != -1 && ancestor[r] != i) {
+                int next = ancestor[r];
+                ancestor[r] = i;
+                r = next;
+            }
+            if (ancestor[r] == -1) {
+                ancestor[r] = i;
+                parent[r] = i;
+            }
+        });
+    }
+
+    // Row i of L is the union of the paths from its entries up the tree to i (row subtree)
+    _LRows.assign(n + 1, 0);
+    _LColumns.clear();
+    std::vector<int> mark(n, -1);
+    for (int i = 0; i < n; i++) {
+        mark[i] = i;
+        int start = _LColumns.size();
+        for_each_lower(i, [&](int k) {
+            for (int j = k; mark[j] != i; j = parent[j]) {
+                mark[j] = i;
+                _LColumns.push_back(j);
+            }
+        });
+        std::sort(_LColumns.begin() + start, _LColumns.end());
+        _LRows[i + 1] = _LColumns.size();
+    }
+
+    _pattern = A.get_pattern();
+    _patternNonzeros = A.get_pattern()->get_nnz();
+    _symbolicFactorizations++;
+}
+
+
+// * * * * * * * * * * * * * *  numeric_factorization * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::sparse_direct<matrix>::numeric_factorization(const matrixCSR& A)
+{
+    int n = A.get_num_rows();
+    const std::vector<double>& values = A.get_values();
+    bool lu = (_factorization == directFactorization::lu);
+
+    _L.assign(_LColumns.size(), 0.0);
+    if (lu) _Ut.assign(_LColumns.size(), 0.0);
+    _diagonal.assign(n, 0.0);
+    _zeroPivot.assign(n, false);
+    _rowL.assign(n, 0.0);
+    _rowU.assign(n, 0.0);
+
+    // Up-looking: row i of L (and column i of U) from the rows already factored, in ascending column order
+    //      Cholesky: L_ij = (a_ij - sum_k L_ik L_jk) / L_jj,     L_ii = sqrt(a_ii - sum_j L_ij^2)
+    //      LU:       L_ij = (a_ij - sum_k L_ik U_kj) / U_jj,     U_ji = a_ji - sum_k L_jk U_ki,   U_ii = a_ii - sum_j L_ij U_ji
+    for (int i = 0; i < n; i++)
+    {
+        double diagonal = 0.0;
+        for (int s = _lowerOffsets[i]; s < _lowerOffsets[i+1]; s++) {
+            int j = _lowerIndices[s];
+            if (j == i) diagonal += values[_lowerSlots[s]];
+            else _rowL[j] += values[_lowerSlots[s]];
+        }
+        if (lu) {
+            for (int s = _upperOffsets[i]; s < _upperOffsets[i+1]; s++) {
+                _rowU[_upperIndices[s]] += values[_upperSlots[s]];
+            }
+        }
+        // Zero pivots are judged against the diagonal of A
+        double pivotTolerance = 1.0e-10 * std::abs(diagonal);
+
+        for (int p = _LRows[i]; p < _LRows[i+1]; p++) {
+            int j = _LColumns[p];
+            if (lu) {
+                double l = _rowL[j];
+                double u = _rowU[j];
+                for (int q = _LRows[j]; q < _LRows[j+1]; q++) {
+                    int k = _LColumns[q];
+                    l -= _Ut[q] * _rowL[k];
+                    u -= _L[q] * _rowU[k];
+                }
+                l = _zeroPivot[j] ? 0.0 : l / _diagonal[j];
+                _rowL[j] = l;
+                _rowU[j] = u;
+                _L[p] = l;
+                _Ut[p] = u;
+                diagonal -= l * u;
+            }
+            else {
+                double l = _rowL[j];
+                for (int q = _LRows[j]; q < _LRows[j+1]; q++) {
+                    l -= _L[q] * _rowL[_LColumns[q]];
+                }
+                l = _zeroPivot[j] ? 0.0 : l / _diagonal[j];
+                _rowL[j] = l;
+                _L[p] = l;
+                diagonal -= l * l;
+            }
+        }
+        for (int p = _LRows[i]; p < _LRows[i+1]; p++) {
+            _rowL[_LColumns[p]] = 0.0;
+            _rowU[_LColumns[p]] = 0.0;
+        }
+
+        // Zero pivot: the unknown is pinned (its column of L is dropped)
+        if (std::abs(diagonal) <= pivotTolerance) {
+            _zeroPivot[i] = true;
+            _diagonal[i] = 1.0;
+        }
+        // A negative Cholesky pivot is no null space direction, A is indefinite
+        else if (!lu && diagonal < 0.0) {
+            throw std::runtime_error("Negative pivot in the Cholesky factorization: matrix is not SPD, use directFactorization::lu");
+        }
+        else {
+            _diagonal[i] = lu ? diagonal : std::sqrt(diagonal);
+        }
+    }
+
+    // Null vectors of the zero pivots: back substitution with the pinned unknown set to one
+    _nullVectors.clear();
+    for (int z = 0; z < n; z++) {
+        if (!_zeroPivot[z]) continue;
+        _y.assign(n, 0.0);
+        for (int i = z; i >= 0; i--) {
+            double x = (i == z) ? 1.0 : (_zeroPivot[i] ? 0.0 : _y[i] / _diagonal[i]);
+            _y[i] = x;
+            if (x == 0.0) continue;
+            for (int p = _LRows[i]; p < _LRows[i+1]; p++) {
+                _y[_LColumns[p]] -= (lu ? _Ut[p] : _L[p]) * x;
+            }
+        }
+        Vector v(n);
+        for (int i = 0; i < n; i++) v[_order[i]] = _y[i];
+        for (const Vector& w : _nullVectors) v.axpy(-(v * w), w);
+        v.scale(1.0 / v.getL2Norm());
+        _nullVectors.push_back(v);
+    }
+    _numericFactorizations++;
+}
+
+
+// * * * * * * * * * * * * * *  factor * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::sparse_direct<matrix>::factor(const matrixCSR& A)
+{
+    if (A.get_pattern() != _pattern || A.get_pattern()->get_nnz() != _patternNonzeros) {
+        symbolic_factorization(A);
+    }
+    numeric_factorization(A);
+}
+
+
+// * * * * * * * * * * * * * *  solve_factored * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::sparse_direct<matrix>::solve_factored(const Vector& b, Vector& x)
+{
+    int n = _order.size();
+    bool lu = (_factorization == directFactorization::lu);
+    _y.resize(n);
+    for (int i = 0; i < n; i++) _y[i] = b[_order[i]];
+
+    // Forward substitution with the rows of L (unit diagonal for LU)
+    for (int i = 0; i < n; i++) {
+        double s = _y[i];
+        for (int p = _LRows[i]; p < _LRows[i+1]; p++) s -= _L[p] * _y[_LColumns[p]];
+        _y[i] = (lu || _zeroPivot[i]) ? s : s / _diagonal[i];
+    }
+
+    // Backward substitution by columns (the rows of L^T or U^T), pinned unknowns are zero
+    for (int i = n - 1; i >= 0; i--) {
+        double xi = _zeroPivot[i] ? 0.0 : _y[i] / _diagonal[i];
+        _y[i] = xi;
+        for (int p = _LRows[i]; p < _LRows[i+1]; p++) {
+            _y[_LColumns[p]] -= (lu ? _Ut[p] : _L[p]) * xi;
+        }
+    }
+
+    for (int i = 0; i < n; i++) x[_order[i]] = _y[i];
+    for (const Vector& v : _nullVectors) x.axpy(-(x * v), v);
+}
+
+
+// * * * * * * * * * * * * * *  solve_refined * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::sparse_direct<matrix>::solve_refined(unsigned maxIterations, double tolerance)
+{
+    this->reserve(_correction, this->_x.size());
+    solve_factored(*this->_b, this->_x);
+    this->_iterations = 1;
+
+    // Iterative refinement with r = A x - b, stops once a correction does not reduce the residual
+    this->_resid = this->residual_norm();
+    while (this->_resid >= tolerance && this->_iterations < maxIterations)
+    {
+        solve_factored(this->_r, _correction);
+        this->_x -= _correction;
+        this->_iterations++;
+
+        double resid = this->residual_norm();
+        if (resid >= this->_resid) {
+            this->_x += _correction;
+            break;
+        }
+        this->_resid = resid;
+    }
+}
+
+
+// * * * * * * * * * * * * * *  solve * * * * * * * * * * * * * * * //
+template <class matrix>
+const MATH::Vector& MATH::sparse_direct<matrix>::solve(unsigned maxIterations, double tolerance)
+{
+    this->_iterations = 0;
+    this->check_inputs();
+
+    // check for trivial case
+    if (this->_b->getL2Norm() == 0.0) {
+        return this->trivial_solution();
+    }
+
+    factor(as_CSR(*this->_A));
+    solve_refined(maxIterations, tolerance);
+    return this->_x;
+}
+
+
+// * * * * * * * * * * * * * *  solve_multiple * * * * * * * * * * * * * * * //
+template <class matrix>
+void MATH::sparse_direct<matrix>::solve_multiple(const std::vector<Vector>& b, std::vector<Vector>& x, unsigned maxIterations, double tolerance)
+{
+    assert(b.size() == x.size() && "Need one guess per right-hand side");
+
+    this->_residuals.assign(b.size(), 0.0);
+    this->_multipleIterations.assign(b.size(), 0);
+    if (b.empty()) return;
+
+    // The right-hand sides are bound one after the other, the caller's binding is restored afterwards
+    const Vector* rhs = this->_b;
+    this->set_rhs(b[0]);
+    this->set_guess(x[0]);
+    this->check_inputs();
+    factor(as_CSR(*this->_A));
+    for (std::size_t k = 0; k < b.size(); k++) {
+        this->set_rhs(b[k]);
+        this->set_guess(x[k]);
+        if (b[k].getL2Norm() == 0.0) {
+            this->trivial_solution();
+            this->_resid = 0.0;
+            this->_iterations = 0;
+        }
+        else {
+            solve_refined(maxIterations, tolerance);
+        }
+        x[k] = this->_x;
+        this->_residuals[k] = this->_resid;
+        this->_multipleIterations[k] = this->_iterations;
+    }
+    this->_b = rhs;
+}
+
+// Explicity Template Instantiation
+template class MATH::sparse_direct<MATH::matrixCSR>;
+template class MATH::sparse_direct<MATH::matrixAutotuned>;
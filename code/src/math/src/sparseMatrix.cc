@@ -9,9 +9,18 @@
 \*------------------------------------------------------------------------*/
 
 #include "sparseMatrix.hh"
+#include "threadPool.hh"
+#include "cpuFeatures.hh"
 
 #include <cassert>
 #include <vector>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <stdexcept>
+#include <cmath>
+#include <atomic>
+#include <utility>
 
 
 /*------------------------------------------------------------------------*\
@@ -34,47 +43,192 @@ std::ostream& MATH::operator<<(std::ostream& os, const MATH::sparseMatrixBase& m
 }
 
 
+/*------------------------------------------------------------------------*\
+**  Class sparsityPattern Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  Constructor (from index arrays) * * * * * * * * * * * * * * * //
+MATH::sparsityPattern::sparsityPattern(int num_rows, int num_columns, std::vector<int> row_indices, std::vector<int> column_indices)
+:
+    _num_rows(num_rows),
+    _num_columns(num_columns),
+    _row_indices(std::move(row_indices)),
+    _column_indices(std::move(column_indices)),
+    _diagonal_positions(num_rows, -1)
+{
+    assert(static_cast<int>(_row_indices.size()) == _num_rows + 1 && _row_indices.back() == static_cast<int>(_column_indices.size()));
+
+    for (int i = 0; i < std::min(_num_rows, _num_columns); i++) {
+        _diagonal_positions[i] = find(i, i);
+    }
+}
+
+
+// * * * * * * * * * * * * * *  find * * * * * * * * * * * * * * * //
+int MATH::sparsityPattern::find(int row, int col) const {
+    assert(row < _num_rows && col < _num_columns);
+
+    // Columns are sorted within each row
+    auto begin = _column_indices.begin() + _row_indices[row];
+    auto end = _column_indices.begin() + _row_indices[row+1];
+    auto it = std::lower_bound(begin, end, col);
+    if (it != end && *it == col) {
+        return it - _column_indices.begin();
+    }
+    return -1;
+}
+
+
+// * * * * * * * * * * * * * *  insert * * * * * * * * * * * * * * * //
+int MATH::sparsityPattern::insert(int row, int col) {
+    // Sorted insertion position within the row
+    auto begin = _column_indices.begin() + _row_indices[row];
+    auto end = _column_indices.begin() + _row_indices[row + 1];
+    int index = std::lower_bound(begin, end, col) - _column_indices.begin();
+
+    _column_indices.insert(_column_indices.begin() + index, col);
+    for (int i = row + 1; i <= _num_rows; i++) {
+        _row_indices[i]++;
+    }
+
+    // Shift cached diagonal positions behind the new entry
+    for (int& position : _diagonal_positions) {
+        if (position >= index) position++;
+    }
+    if (row == col) _diagonal_positions[row] = index;
+    _row_partition_parts = 0;
+    _color_offsets.clear();
+
+    return index;
+}
+
+
+// * * * * * * * * * * * * * *  erase * * * * * * * * * * * * * * * //
+void MATH::sparsityPattern::erase(int row, int index) {
+    // Decrease number of non-zero entries in row
+    for (int i = row + 1; i <= _num_rows; i++) {
+        _row_indices[i]--;
+    }
+
+    // Remove column entry
+    if (row == _column_indices[index]) _diagonal_positions[row] = -1;
+    _column_indices.erase(_column_indices.begin() + index);
+
+    // Shift cached diagonal positions behind the removed entry
+    for (int& position : _diagonal_positions) {
+        if (position > index) position--;
+    }
+    _row_partition_parts = 0;
+    _color_offsets.clear();
+}
+
+
+// * * * * * * * * * * * * * *  get_row_partition * * * * * * * * * * * * * * * //
+const std::vector<int>& MATH::sparsityPattern::get_row_partition(int num_parts) const {
+    if (_row_partition_parts != num_parts) {
+        _row_partition = MATH::partition_by_nnz(_row_indices, num_parts);
+        _row_partition_parts = num_parts;
+    }
+    return _row_partition;
+}
+
+
+// * * * * * * * * * * * * * *  get_color_offsets / get_color_rows * * * * * * * * * * * * * * * //
+const std::vector<int>& MATH::sparsityPattern::get_color_offsets() const {
+    if (_color_offsets.empty()) build_coloring();
+    return _color_offsets;
+}
+
+const std::vector<int>& MATH::sparsityPattern::get_color_rows() const {
+    if (_color_offsets.empty()) build_coloring();
+    return _color_rows;
+}
+
+
+// * * * * * * * * * * * * * *  build_coloring * * * * * * * * * * * * * * * //
+void MATH::sparsityPattern::build_coloring() const {
+    // Transposed structure, a row also has to avoid the colors of the rows reading it
+    std::vector<int> transpose_indices(_num_rows + 1, 0);
+    for (int col : _column_indices) {
+        if (col < _num_rows) transpose_indices[col + 1]++;
+    }
+    for (int i = 0; i < _num_rows; i++) {
+        transpose_indices[i + 1] += transpose_indices[i];
+    }
+    std::vector<int> transpose_rows(transpose_indices.back());
+    std::vector<int> next(transpose_indices.begin(), transpose_indices.end() - 1);
+    for (int row = 0; row < _num_rows; row++) {
+        for (int index = _row_indices[row]; index < _row_indices[row + 1]; index++) {
+            if (_column_indices[index] < _num_rows) transpose_rows[next[_column_indices[index]]++] = row;
+        }
+    }
+
+    // Greedy coloring in row order, forbidden[c] == i marks color c as taken by a neighbor of row i
+    std::vector<int> color(_num_rows, -1);
+    std::vector<int> forbidden;
+    auto forbid = [&](int i, int j) {
+        if (j != i && color[j] >= 0) forbidden[color[j]] = i;
+    };
+    for (int i = 0; i < _num_rows; i++) {
+        for (int index = _row_indices[i]; index < _row_indices[i + 1]; index++) {
+            if (_column_indices[index] < _num_rows) forbid(i, _column_indices[index]);
+        }
+        for (int index = transpose_indices[i]; index < transpose_indices[i + 1]; index++) {
+            forbid(i, transpose_rows[index]);
+        }
+        std::size_t c = 0;
+        while (c < forbidden.size() && forbidden[c] == i) c++;
+        if (c == forbidden.size()) forbidden.push_back(-1);
+        color[i] = c;
+    }
+
+    // Group the rows by color (ascending row order within a color)
+    _color_offsets.assign(forbidden.size() + 1, 0);
+    for (int i = 0; i < _num_rows; i++) {
+        _color_offsets[color[i] + 1]++;
+    }
+    for (std::size_t c = 0; c < forbidden.size(); c++) {
+        _color_offsets[c + 1] += _color_offsets[c];
+    }
+    _color_rows.resize(_num_rows);
+    next.assign(_color_offsets.begin(), _color_offsets.end() - 1);
+    for (int i = 0; i < _num_rows; i++) {
+        _color_rows[next[color[i]]++] = i;
+    }
+}
+
+
 /*------------------------------------------------------------------------*\
 **  Class matrixCSR Implementation
 \*------------------------------------------------------------------------*/
 
-// * * * * * * * * * * * * * *  Constructors * * * * * * * * * * * * * * * //
-// MATH::matrixCSR::matrixCSR(int num_rows, int num_columns)
-// {
-    
-// }
+// * * * * * * * * * * * * * *  unique_pattern * * * * * * * * * * * * * * * //
+MATH::sparsityPattern& MATH::matrixCSR::unique_pattern() {
+    if (_pattern.use_count() > 1) {
+        _pattern = std::make_shared<sparsityPattern>(*_pattern);
+    }
+    return *_pattern;
+}
 
 
 // * * * * * * * * * * * * * *  get_value * * * * * * * * * * * * * * * //
 double MATH::matrixCSR::get_value(int row, int col) const {
     assert(row < _num_rows && col < _num_columns);
 
-    // Gets total number of entries in row
-    for (int i = _row_indices[row]; i < _row_indices[row+1]; i++) {
-        // Checks columns given in row index to see if they coicide with given column
-        if (_column_indices[i] == col) {
-            return _values[i];
-        }
-    }
+    int index = _pattern->find(row, col);
     // returns 0 if not match (sparse matrix)
-    return 0.0;
+    return index < 0 ? 0.0 : _values[index];
 }
 
 
 // * * * * * * * * * * * * * *  set_value * * * * * * * * * * * * * * * //
-// NOTE: Does not allow 0 to be stored
+// NOTE: Does not allow 0 to be stored, keeps columns sorted within each row
 void MATH::matrixCSR::set_value(int row, int col, double value) {
     assert(row < _num_rows && col < _num_columns);
     
     // First check if row/column already has NZ entry
-    bool rowColumnHasEntry = false;
-    unsigned index = 0;
-    for (unsigned i = _row_indices[row]; i < _row_indices[row + 1]; i++) {
-        if (_column_indices[i] == col) {
-            index = i;
-            rowColumnHasEntry = true;
-        }
-    }
+    int index = _pattern->find(row, col);
+    bool rowColumnHasEntry = (index >= 0);
 
     // make sure values exists
     if (value != 0.0) {
@@ -83,25 +237,14 @@ void MATH::matrixCSR::set_value(int row, int col, double value) {
             _values[index] = value;
         } 
         else {
-            _values.insert(_values.begin() + _row_indices[row + 1], value);
-            _column_indices.insert(_column_indices.begin() + _row_indices[row + 1], col);
-
-            for (unsigned i = row + 1; i <= _num_rows; i++) {
-                _row_indices[i]++;
-            }
+            index = unique_pattern().insert(row, col);
+            _values.insert(_values.begin() + index, value);
         }
     
     }
     else if (rowColumnHasEntry) {
-        // Decrease number of non-zero entries in row
-        for (unsigned i = row + 1; i <= _num_rows; i++) {
-            _row_indices[i]--;
-        }
-
-        // Remove column entry
+        unique_pattern().erase(row, index);
         _values.erase(_values.begin() + index);
-        _column_indices.erase(_column_indices.begin() + index);
-        
     }
 }
 
@@ -119,16 +262,817 @@ MATH::matrixCSR MATH::matrixCSR::operator*(const double &scaleFactor) const {
 // * * * * * * * * * * * * * *  vector multiplication with * operator * * * * * * * * * * * * * * * //
 // Note: const because it does not modify the given vector (rhs)
 MATH::Vector MATH::matrixCSR::operator*(const Vector& rhs) const {
-    assert(rhs.size() == _num_columns && "Vector size does not match the number of columns in the matrix.");
+    Vector result(_num_rows);
+    multiply(rhs, result);
+    return result;
+}
+
+
+// * * * * * * * * * * * * * *  multiply * * * * * * * * * * * * * * * //
+void MATH::matrixCSR::multiply(const Vector& rhs, Vector& result) const {
+    assert(static_cast<int>(rhs.size()) == _num_columns && "Vector size does not match the number of columns in the matrix.");
+    assert(static_cast<int>(result.size()) == _num_rows && "Result size does not match the number of rows in the matrix.");
 
+    const std::vector<int>& row_indices = _pattern->_row_indices;
+    const std::vector<int>& column_indices = _pattern->_column_indices;
+
+    // Each thread owns a block of rows holding about the same number of nonzeros
+    MATH::parallel_for(_pattern->get_row_partition(MATH::get_num_threads()), [&](int rowBegin, int rowEnd) {
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            double sum = 0.0;
+            for (int columnIndex = row_indices[row]; columnIndex < row_indices[row + 1]; ++columnIndex) {
+                sum += _values[columnIndex] * rhs[column_indices[columnIndex]];
+            }
+            result[row] = sum;
+        }
+    });
+}
+
+
+// * * * * * * * * * * * * * *  diagonal_solve * * * * * * * * * * * * * * * //
+MATH::Vector MATH::matrixCSR::diagonal_solve(const Vector& r) const {
     Vector result(_num_rows);
+    diagonal_solve(r, result);
+    return result;
+}
+
+void MATH::matrixCSR::diagonal_solve(const Vector& r, Vector& result) const {
+    assert(static_cast<int>(r.size()) == _num_rows);
+    assert(static_cast<int>(result.size()) == _num_rows && "Result size does not match the number of rows in the matrix.");
+
+    const diagonalView D = diagonal();
+    MATH::parallel_for(MATH::partition_uniform(_num_rows), [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            result[i] = r[i] / D[i];
+        }
+    });
+}
+
+
+/*------------------------------------------------------------------------*\
+**  Class matrixCOO Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  reserve * * * * * * * * * * * * * * * //
+void MATH::matrixCOO::reserve(int nnz) {
+    _rows.reserve(nnz);
+    _columns.reserve(nnz);
+    _values.reserve(nnz);
+}
+
 
-    for (unsigned row = 0; row < _num_rows; ++row) {
-        for (unsigned columnIndex = _row_indices[row]; columnIndex < _row_indices[row + 1]; ++columnIndex) {
-            auto column = _column_indices[columnIndex];
-            result[row] += _values[columnIndex] * rhs[column];
+// * * * * * * * * * * * * * *  add_value * * * * * * * * * * * * * * * //
+void MATH::matrixCOO::add_value(int row, int col, double value) {
+    assert(row < _num_rows && col < _num_columns);
+
+    _rows.push_back(row);
+    _columns.push_back(col);
+    _values.push_back(value);
+}
+
+
+// * * * * * * * * * * * * * *  clear * * * * * * * * * * * * * * * //
+void MATH::matrixCOO::clear() {
+    _rows.clear();
+    _columns.clear();
+    _values.clear();
+}
+
+
+// * * * * * * * * * * * * * *  to_CSR * * * * * * * * * * * * * * * //
+// NOTE: Two stable counting sorts (by column, then by row) order the entries in O(nnz + rows + columns).
+//       Explicit zeros are kept so the result can also serve as a fixed sparsity pattern.
+MATH::matrixCSR MATH::matrixCOO::to_CSR() const {
+    int nnz = _values.size();
+
+    // Counting sort by column
+    std::vector<int> offsets(_num_columns + 1, 0);
+    for (int k = 0; k < nnz; k++) {
+        offsets[_columns[k] + 1]++;
+    }
+    for (int j = 0; j < _num_columns; j++) {
+        offsets[j + 1] += offsets[j];
+    }
+    std::vector<int> byColumn(nnz);
+    for (int k = 0; k < nnz; k++) {
+        byColumn[offsets[_columns[k]]++] = k;
+    }
+
+    // Stable counting sort by row (columns stay ascending inside each row)
+    std::vector<int> row_indices(_num_rows + 1, 0);
+    for (int k = 0; k < nnz; k++) {
+        row_indices[_rows[k] + 1]++;
+    }
+    for (int i = 0; i < _num_rows; i++) {
+        row_indices[i + 1] += row_indices[i];
+    }
+    std::vector<int> position(row_indices.begin(), row_indices.end() - 1);
+    std::vector<int> sorted(nnz);
+    for (int k : byColumn) {
+        sorted[position[_rows[k]]++] = k;
+    }
+
+    // Merge duplicate entries while copying into the CSR arrays
+    MATH::matrixCSR result(_num_rows, _num_columns);
+    sparsityPattern& pattern = *result._pattern;
+    result._values.reserve(nnz);
+    pattern._column_indices.reserve(nnz);
+    for (int i = 0; i < _num_rows; i++) {
+        for (int index = row_indices[i]; index < row_indices[i + 1]; index++) {
+            int k = sorted[index];
+            if (index > row_indices[i] && pattern._column_indices.back() == _columns[k]) {
+                result._values.back() += _values[k];
+            }
+            else {
+                if (_columns[k] == i) pattern._diagonal_positions[i] = result._values.size();
+                result._values.push_back(_values[k]);
+                pattern._column_indices.push_back(_columns[k]);
+            }
         }
+        pattern._row_indices[i + 1] = result._values.size();
     }
 
     return result;
-}
\ No newline at end of file
+}
+
+
+
+/*------------------------------------------------------------------------*\
+**  Sparse matrix products
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  multiply * * * * * * * * * * * * * * * //
+// NOTE: Gustavson row-by-row product, a marker array collects the columns of each result row
+MATH::matrixCSR MATH::multiply(const matrixCSR& A, const matrixCSR& B) {
+    assert(A.get_num_columns() == B.get_num_rows());
+
+    const std::vector<int>& a_rows = A.get_row_indices();
+    const std::vector<int>& a_cols = A.get_column_indices();
+    const std::vector<int>& b_rows = B.get_row_indices();
+    const std::vector<int>& b_cols = B.get_column_indices();
+
+    std::vector<int> row_indices(A.get_num_rows() + 1, 0);
+    std::vector<int> column_indices;
+    column_indices.reserve(a_cols.size());
+    std::vector<int> marker(B.get_num_columns(), -1);
+    for (int i = 0; i < A.get_num_rows(); i++) {
+        int start = column_indices.size();
+        for (int a = a_rows[i]; a < a_rows[i+1]; a++) {
+            int k = a_cols[a];
+            for (int b = b_rows[k]; b < b_rows[k+1]; b++) {
+                int j = b_cols[b];
+                if (marker[j] != i) {
+                    marker[j] = i;
+                    column_indices.push_back(j);
+                }
+            }
+        }
+        std::sort(column_indices.begin() + start, column_indices.end());
+        row_indices[i+1] = column_indices.size();
+    }
+
+    MATH::matrixCSR C(std::make_shared<sparsityPattern>(A.get_num_rows(), B.get_num_columns(),
+                                                       std::move(row_indices), std::move(column_indices)));
+    multiply_values(A, B, C);
+    return C;
+}
+
+
+// * * * * * * * * * * * * * *  multiply_values * * * * * * * * * * * * * * * //
+void MATH::multiply_values(const matrixCSR& A, const matrixCSR& B, matrixCSR& C) {
+    const std::vector<int>& a_rows = A.get_row_indices();
+    const std::vector<int>& a_cols = A.get_column_indices();
+    const std::vector<double>& a_values = A.get_values();
+    const std::vector<int>& b_rows = B.get_row_indices();
+    const std::vector<int>& b_cols = B.get_column_indices();
+    const std::vector<double>& b_values = B.get_values();
+    const std::vector<int>& c_rows = C.get_row_indices();
+    const std::vector<int>& c_cols = C.get_column_indices();
+    std::vector<double>& c_values = C.get_values();
+
+    MATH::parallel_for(C.get_pattern()->get_row_partition(MATH::get_num_threads()), [&](int rowBegin, int rowEnd) {
+        // Column -> slot of the current result row
+        std::vector<int> slot(B.get_num_columns(), -1);
+        for (int i = rowBegin; i < rowEnd; i++) {
+            for (int c = c_rows[i]; c < c_rows[i+1]; c++) {
+                slot[c_cols[c]] = c;
+                c_values[c] = 0.0;
+            }
+            for (int a = a_rows[i]; a < a_rows[i+1]; a++) {
+                int k = a_cols[a];
+                for (int b = b_rows[k]; b < b_rows[k+1]; b++) {
+                    c_values[slot[b_cols[b]]] += a_values[a] * b_values[b];
+                }
+            }
+        }
+    });
+}
+
+
+// * * * * * * * * * * * * * *  transpose * * * * * * * * * * * * * * * //
+MATH::matrixCSR MATH::transpose(const matrixCSR& A, std::vector<int>* source_slots) {
+    const std::vector<int>& a_rows = A.get_row_indices();
+    const std::vector<int>& a_cols = A.get_column_indices();
+    const std::vector<double>& a_values = A.get_values();
+    int nnz = a_cols.size();
+
+    // Counting sort by column (rows are visited in order, so columns of A^T come out sorted)
+    std::vector<int> row_indices(A.get_num_columns() + 1, 0);
+    for (int k = 0; k < nnz; k++) {
+        row_indices[a_cols[k] + 1]++;
+    }
+    for (int j = 0; j < A.get_num_columns(); j++) {
+        row_indices[j+1] += row_indices[j];
+    }
+    std::vector<int> position(row_indices.begin(), row_indices.end() - 1);
+    std::vector<int> column_indices(nnz);
+    std::vector<int> sources(nnz);
+    for (int i = 0; i < A.get_num_rows(); i++) {
+        for (int k = a_rows[i]; k < a_rows[i+1]; k++) {
+            int slot = position[a_cols[k]]++;
+            column_indices[slot] = i;
+            sources[slot] = k;
+        }
+    }
+
+    MATH::matrixCSR T(std::make_shared<sparsityPattern>(A.get_num_columns(), A.get_num_rows(),
+                                                       std::move(row_indices), std::move(column_indices)));
+    std::vector<double>& t_values = T.get_values();
+    for (int k = 0; k < nnz; k++) {
+        t_values[k] = a_values[sources[k]];
+    }
+    if (source_slots != nullptr) {
+        *source_slots = std::move(sources);
+    }
+    return T;
+}
+
+
+/*------------------------------------------------------------------------*\
+**  Class matrixSELL Implementation
+\*------------------------------------------------------------------------*/
+
+namespace {
+
+// * * * * * * * * * * * * * *  SELL kernels * * * * * * * * * * * * * * * //
+// Each kernel computes the chunk products of chunks [chunkBegin, chunkEnd) into y (sorted row order)
+struct sellData
+{
+    int C;
+    const int* chunk_offsets;
+    const int* chunk_lengths;
+    const int* column_indices;
+    const double* values;
+};
+
+void sell_kernel_scalar(const sellData& A, const double* x, double* y, int chunkBegin, int chunkEnd)
+{
+    for (int chunk = chunkBegin; chunk < chunkEnd; chunk++) {
+        double* yc = y + chunk*A.C;
+        for (int lane = 0; lane < A.C; lane++) yc[lane] = 0.0;
+        int slot = A.chunk_offsets[chunk];
+        for (int j = 0; j < A.chunk_lengths[chunk]; j++) {
+            for (int lane = 0; lane < A.C; lane++, slot++) {
+                yc[lane] += A.values[slot] * x[A.column_indices[slot]];
+            }
+        }
+    }
+}
+
+#ifdef LUNA_X86
+// Requires C % 4 == 0
+LUNA_TARGET("avx2,fma")
+void sell_kernel_avx2(const sellData& A, const double* x, double* y, int chunkBegin, int chunkEnd)
+{
+    for (int chunk = chunkBegin; chunk < chunkEnd; chunk++) {
+        for (int lane = 0; lane < A.C; lane += 4) {
+            __m256d sum = _mm256_setzero_pd();
+            int slot = A.chunk_offsets[chunk] + lane;
+            for (int j = 0; j < A.chunk_lengths[chunk]; j++, slot += A.C) {
+                __m128i columns = _mm_loadu_si128(reinterpret_cast<const __m128i*>(A.column_indices + slot));
+                __m256d xv = _mm256_i32gather_pd(x, columns, 8);
+                sum = _mm256_fmadd_pd(_mm256_loadu_pd(A.values + slot), xv, sum);
+            }
+            _mm256_storeu_pd(y + chunk*A.C + lane, sum);
+        }
+    }
+}
+
+// Requires C % 8 == 0
+LUNA_TARGET("avx512f")
+void sell_kernel_avx512(const sellData& A, const double* x, double* y, int chunkBegin, int chunkEnd)
+{
+    for (int chunk = chunkBegin; chunk < chunkEnd; chunk++) {
+        for (int lane = 0; lane < A.C; lane += 8) {
+            __m512d sum = _mm512_setzero_pd();
+            int slot = A.chunk_offsets[chunk] + lane;
+            for (int j = 0; j < A.chunk_lengths[chunk]; j++, slot += A.C) {
+                __m256i columns = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(A.column_indices + slot));
+                __m512d xv = _mm512_i32gather_pd(columns, x, 8);
+                sum = _mm512_fmadd_pd(_mm512_loadu_pd(A.values + slot), xv, sum);
+            }
+            _mm512_storeu_pd(y + chunk*A.C + lane, sum);
+        }
+    }
+}
+#endif
+
+}
+
+
+// * * * * * * * * * * * * * *  Constructor (empty) * * * * * * * * * * * * * * * //
+MATH::matrixSELL::matrixSELL(int num_rows, int num_columns)
+:
+    matrixSELL(matrixCSR(num_rows, num_columns))
+{}
+
+
+// * * * * * * * * * * * * * *  Constructor (from CSR) * * * * * * * * * * * * * * * //
+MATH::matrixSELL::matrixSELL(const matrixCSR& A, int chunk_height, int sigma)
+:
+    sparseMatrixBase(A.get_num_rows(), A.get_num_columns()),
+    _chunk_height(chunk_height),
+    _sigma(std::max(1, sigma))
+{
+    assert(chunk_height > 0 && "Chunk height must be positive");
+
+    const std::vector<int>& row_indices = A.get_row_indices();
+    const std::vector<int>& column_indices = A.get_column_indices();
+    const std::vector<double>& values = A.get_values();
+
+    int C = _chunk_height;
+    int num_chunks = (_num_rows + C - 1) / C;
+    int num_padded = num_chunks * C;
+
+    // Sort rows by decreasing length inside each sigma window (stable to keep locality)
+    _permutation.resize(num_padded, -1);
+    std::iota(_permutation.begin(), _permutation.begin() + _num_rows, 0);
+    auto row_length = [&](int row) { return row_indices[row+1] - row_indices[row]; };
+    for (int begin = 0; begin < _num_rows; begin += _sigma) {
+        int end = std::min(_num_rows, begin + _sigma);
+        std::stable_sort(_permutation.begin() + begin, _permutation.begin() + end,
+                         [&](int a, int b) { return row_length(a) > row_length(b); });
+    }
+    _inverse_permutation.resize(_num_rows);
+    _row_lengths.resize(num_padded, 0);
+    for (int k = 0; k < _num_rows; k++) {
+        _inverse_permutation[_permutation[k]] = k;
+        _row_lengths[k] = row_length(_permutation[k]);
+    }
+
+    // Chunk sizes
+    _chunk_lengths.resize(num_chunks, 0);
+    _chunk_offsets.resize(num_chunks + 1, 0);
+    for (int chunk = 0; chunk < num_chunks; chunk++) {
+        for (int lane = 0; lane < C; lane++) {
+            _chunk_lengths[chunk] = std::max(_chunk_lengths[chunk], _row_lengths[chunk*C + lane]);
+        }
+        _chunk_offsets[chunk+1] = _chunk_offsets[chunk] + C*_chunk_lengths[chunk];
+    }
+
+    // Fill storage, padding points at column 0 with a zero value
+    int num_slots = _chunk_offsets[num_chunks];
+    _column_indices.assign(num_slots, 0);
+    _values.assign(num_slots, 0.0);
+    _csr_positions.assign(num_slots, -1);
+    for (int k = 0; k < _num_rows; k++) {
+        int chunk = k / C;
+        int lane = k % C;
+        int row = _permutation[k];
+        for (int j = 0; j < _row_lengths[k]; j++) {
+            int slot = _chunk_offsets[chunk] + j*C + lane;
+            int index = row_indices[row] + j;
+            _column_indices[slot] = column_indices[index];
+            _values[slot] = values[index];
+            _csr_positions[slot] = index;
+        }
+    }
+}
+
+
+// * * * * * * * * * * * * * *  get_value * * * * * * * * * * * * * * * //
+double MATH::matrixSELL::get_value(int row, int col) const {
+    assert(row < _num_rows && col < _num_columns);
+
+    int k = _inverse_permutation[row];
+    int slot = _chunk_offsets[k / _chunk_height] + k % _chunk_height;
+    for (int j = 0; j < _row_lengths[k]; j++, slot += _chunk_height) {
+        if (_column_indices[slot] == col) return _values[slot];
+    }
+    return 0.0;
+}
+
+
+// * * * * * * * * * * * * * *  set_value * * * * * * * * * * * * * * * //
+void MATH::matrixSELL::set_value(int row, int col, double value) {
+    assert(row < _num_rows && col < _num_columns);
+
+    int k = _inverse_permutation[row];
+    int slot = _chunk_offsets[k / _chunk_height] + k % _chunk_height;
+    for (int j = 0; j < _row_lengths[k]; j++, slot += _chunk_height) {
+        if (_column_indices[slot] == col) {
+            _values[slot] = value;
+            return;
+        }
+    }
+    if (value != 0.0) {
+        throw std::runtime_error("matrixSELL::set_value: entry is not part of the sliced structure");
+    }
+}
+
+
+// * * * * * * * * * * * * * *  update_values * * * * * * * * * * * * * * * //
+void MATH::matrixSELL::update_values(const matrixCSR& A) {
+    const std::vector<double>& values = A.get_values();
+    for (std::size_t slot = 0; slot < _values.size(); slot++) {
+        if (_csr_positions[slot] >= 0) _values[slot] = values[_csr_positions[slot]];
+    }
+}
+
+
+// * * * * * * * * * * * * * *  vector multiplication with * operator * * * * * * * * * * * * * * * //
+MATH::Vector MATH::matrixSELL::operator*(const Vector& rhs) const {
+    Vector result(_num_rows);
+    multiply(rhs, result);
+    return result;
+}
+
+
+// * * * * * * * * * * * * * *  multiply * * * * * * * * * * * * * * * //
+void MATH::matrixSELL::multiply(const Vector& rhs, Vector& result) const {
+    assert(static_cast<int>(rhs.size()) == _num_columns && "Vector size does not match the number of columns in the matrix.");
+    assert(static_cast<int>(result.size()) == _num_rows && "Result size does not match the number of rows in the matrix.");
+
+    int C = _chunk_height;
+    int num_chunks = get_num_chunks();
+    sellData data{C, _chunk_offsets.data(), _chunk_lengths.data(), _column_indices.data(), _values.data()};
+
+    // Pick the widest kernel the CPU supports for this chunk height
+    auto kernel = sell_kernel_scalar;
+#ifdef LUNA_X86
+    MATH::simdLevel level = MATH::get_simd_level();
+    if (level >= MATH::simdLevel::avx512 && C % 8 == 0) {
+        kernel = sell_kernel_avx512;
+    }
+    else if (level >= MATH::simdLevel::avx2 && C % 4 == 0) {
+        kernel = sell_kernel_avx2;
+    }
+#endif
+
+    // Products in sorted row order, then scattered back to the original rows
+    _sorted.resize(num_chunks * C);
+    const double* x = num_chunks > 0 ? &rhs[0] : nullptr;
+    MATH::parallel_for(MATH::partition_by_nnz(_chunk_offsets, MATH::get_num_threads()), [&](int chunkBegin, int chunkEnd) {
+        kernel(data, x, _sorted.data(), chunkBegin, chunkEnd);
+    });
+
+    for (int k = 0; k < _num_rows; k++) {
+        result[_permutation[k]] = _sorted[k];
+    }
+}
+
+
+/*------------------------------------------------------------------------*\
+**  Class matrixAutotuned Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  Constructor * * * * * * * * * * * * * * * //
+MATH::matrixAutotuned::matrixAutotuned(const matrixCSR& A)
+:
+    sparseMatrixBase(A.get_num_rows(), A.get_num_columns()),
+    _csr(A),
+    _sell(A),
+    _format(std::make_shared<format>(format::undecided))
+{}
+
+
+// * * * * * * * * * * * * * *  update * * * * * * * * * * * * * * * //
+void MATH::matrixAutotuned::update(const matrixCSR& A) {
+    if (A.get_pattern() == _csr.get_pattern()) {
+        // Same structure: refresh values only, keep the format decision
+        _csr = A;
+        _sell.update_values(A);
+    }
+    else {
+        *this = matrixAutotuned(A);
+    }
+}
+
+
+// * * * * * * * * * * * * * *  set_value * * * * * * * * * * * * * * * //
+void MATH::matrixAutotuned::set_value(int row, int col, double value) {
+    bool hasEntry = _csr.get_pattern()->find(row, col) >= 0;
+    _csr.set_value(row, col, value);
+
+    if (hasEntry && value != 0.0) {
+        _sell.set_value(row, col, value);
+    }
+    else if (hasEntry || value != 0.0) {
+        // Structure changed: rebuild the sliced copy and tune again
+        _sell = matrixSELL(_csr);
+        _format = std::make_shared<format>(format::undecided);
+    }
+}
+
+
+// * * * * * * * * * * * * * *  tune * * * * * * * * * * * * * * * //
+// NOTE: the best of a few repetitions is compared to filter out first-touch and scheduling noise
+void MATH::matrixAutotuned::tune(const Vector& rhs) const {
+    constexpr int repetitions = 3;
+    using clock = std::chrono::steady_clock;
+
+    auto best_time = [&](const sparseMatrixBase& A) {
+        double best = 1e300;
+        for (int r = 0; r < repetitions; r++) {
+            auto start = clock::now();
+            Vector y = A * rhs;
+            best = std::min(best, std::chrono::duration<double>(clock::now() - start).count());
+        }
+        return best;
+    };
+
+    double timeCSR = best_time(_csr);
+    double timeSELL = best_time(_sell);
+    *_format = (timeSELL < timeCSR) ? format::SELL : format::CSR;
+}
+
+
+// * * * * * * * * * * * * * *  vector multiplication with * operator * * * * * * * * * * * * * * * //
+MATH::Vector MATH::matrixAutotuned::operator*(const Vector& rhs) const {
+    if (*_format == format::undecided) {
+        tune(rhs);
+    }
+    return (*_format == format::SELL) ? _sell * rhs : _csr * rhs;
+}
+
+
+// * * * * * * * * * * * * * *  multiply * * * * * * * * * * * * * * * //
+void MATH::matrixAutotuned::multiply(const Vector& rhs, Vector& result) const {
+    if (*_format == format::undecided) {
+        tune(rhs);
+    }
+    if (*_format == format::SELL) {
+        _sell.multiply(rhs, result);
+    }
+    else {
+        _csr.multiply(rhs, result);
+    }
+}
+
+
+
+/*------------------------------------------------------------------------*\
+**  Class matrixCSRFloat Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  Constructor * * * * * * * * * * * * * * * //
+MATH::matrixCSRFloat::matrixCSRFloat(const matrixCSR& A)
+:
+    sparseMatrixBase(A.get_num_rows(), A.get_num_columns()),
+    _pattern(A.get_pattern()),
+    _values(A.get_values().begin(), A.get_values().end())
+{}
+
+
+// * * * * * * * * * * * * * *  update_values * * * * * * * * * * * * * * * //
+void MATH::matrixCSRFloat::update_values(const matrixCSR& A) {
+    if (A.get_pattern() != _pattern) {
+        *this = matrixCSRFloat(A);
+        return;
+    }
+    const std::vector<double>& values = A.get_values();
+    MATH::parallel_for(MATH::partition_uniform(values.size()), [&](int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+            _values[k] = static_cast<float>(values[k]);
+        }
+    });
+}
+
+
+// * * * * * * * * * * * * * *  get_value * * * * * * * * * * * * * * * //
+double MATH::matrixCSRFloat::get_value(int row, int col) const {
+    assert(row < _num_rows && col < _num_columns);
+
+    int index = _pattern->find(row, col);
+    return index < 0 ? 0.0 : _values[index];
+}
+
+
+// * * * * * * * * * * * * * *  set_value * * * * * * * * * * * * * * * //
+void MATH::matrixCSRFloat::set_value(int row, int col, double value) {
+    int index = _pattern->find(row, col);
+    if (index < 0) {
+        throw std::runtime_error("matrixCSRFloat::set_value: entry is not part of the sparsity pattern");
+    }
+    _values[index] = static_cast<float>(value);
+}
+
+
+// * * * * * * * * * * * * * *  vector multiplication with * operator * * * * * * * * * * * * * * * //
+MATH::Vector MATH::matrixCSRFloat::operator*(const Vector& rhs) const {
+    Vector result(_num_rows);
+    multiply(rhs, result);
+    return result;
+}
+
+
+// * * * * * * * * * * * * * *  multiply * * * * * * * * * * * * * * * //
+void MATH::matrixCSRFloat::multiply(const Vector& rhs, Vector& result) const {
+    assert(static_cast<int>(rhs.size()) == _num_columns && "Vector size does not match the number of columns in the matrix.");
+    assert(static_cast<int>(result.size()) == _num_rows && "Result size does not match the number of rows in the matrix.");
+
+    const std::vector<int>& row_indices = _pattern->get_row_indices();
+    const std::vector<int>& column_indices = _pattern->get_column_indices();
+
+    // Same row blocks as the double precision CSR product, values are widened to double before accumulating
+    MATH::parallel_for(_pattern->get_row_partition(MATH::get_num_threads()), [&](int rowBegin, int rowEnd) {
+        for (int row = rowBegin; row < rowEnd; ++row) {
+            double sum = 0.0;
+            for (int columnIndex = row_indices[row]; columnIndex < row_indices[row + 1]; ++columnIndex) {
+                sum += static_cast<double>(_values[columnIndex]) * rhs[column_indices[columnIndex]];
+            }
+            result[row] = sum;
+        }
+    });
+}
+
+
+
+/*------------------------------------------------------------------------*\
+**  Class matrixBSR Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  solve_block * * * * * * * * * * * * * * * //
+template <int B>
+bool MATH::solve_block(const double* D, double* x) {
+    double LU[B*B];
+    std::copy(D, D + B*B, LU);
+
+    for (int k = 0; k < B; k++) {
+        // Partial pivoting
+        int pivot = k;
+        for (int i = k+1; i < B; i++) {
+            if (std::abs(LU[i*B+k]) > std::abs(LU[pivot*B+k])) pivot = i;
+        }
+        if (std::abs(LU[pivot*B+k]) < 1e-12) return false;
+        if (pivot != k) {
+            for (int j = 0; j < B; j++) std::swap(LU[k*B+j], LU[pivot*B+j]);
+            std::swap(x[k], x[pivot]);
+        }
+
+        // Eliminate below the pivot
+        for (int i = k+1; i < B; i++) {
+            double factor = LU[i*B+k] / LU[k*B+k];
+            for (int j = k+1; j < B; j++) LU[i*B+j] -= factor * LU[k*B+j];
+            x[i] -= factor * x[k];
+        }
+    }
+
+    // Back substitution
+    for (int k = B-1; k >= 0; k--) {
+        for (int j = k+1; j < B; j++) x[k] -= LU[k*B+j] * x[j];
+        x[k] /= LU[k*B+k];
+    }
+    return true;
+}
+
+
+// * * * * * * * * * * * * * *  unique_pattern * * * * * * * * * * * * * * * //
+template <int B>
+MATH::sparsityPattern& MATH::matrixBSR<B>::unique_pattern() {
+    if (_pattern.use_count() > 1) {
+        _pattern = std::make_shared<sparsityPattern>(*_pattern);
+    }
+    return *_pattern;
+}
+
+
+// * * * * * * * * * * * * * *  get_block * * * * * * * * * * * * * * * //
+template <int B>
+const double* MATH::matrixBSR<B>::get_block(int I, int J) const {
+    int slot = _pattern->find(I, J);
+    return slot < 0 ? nullptr : _values.data() + slot*block_entries;
+}
+
+
+// * * * * * * * * * * * * * *  get_diagonal_block * * * * * * * * * * * * * * * //
+template <int B>
+const double* MATH::matrixBSR<B>::get_diagonal_block(int I) const {
+    int slot = _pattern->_diagonal_positions[I];
+    return slot < 0 ? nullptr : _values.data() + slot*block_entries;
+}
+
+
+// * * * * * * * * * * * * * *  insert_block * * * * * * * * * * * * * * * //
+template <int B>
+double* MATH::matrixBSR<B>::insert_block(int I, int J) {
+    assert(I < get_num_block_rows() && J < _pattern->get_num_columns());
+
+    int slot = _pattern->find(I, J);
+    if (slot < 0) {
+        slot = unique_pattern().insert(I, J);
+        _values.insert(_values.begin() + slot*block_entries, block_entries, 0.0);
+    }
+    return _values.data() + slot*block_entries;
+}
+
+
+// * * * * * * * * * * * * * *  get_value * * * * * * * * * * * * * * * //
+template <int B>
+double MATH::matrixBSR<B>::get_value(int row, int col) const {
+    assert(row < _num_rows && col < _num_columns);
+
+    const double* block = get_block(row/B, col/B);
+    return block == nullptr ? 0.0 : block[(row%B)*B + col%B];
+}
+
+
+// * * * * * * * * * * * * * *  set_value * * * * * * * * * * * * * * * //
+// NOTE: blocks are only inserted for nonzero values, zeros inside a stored block are kept
+template <int B>
+void MATH::matrixBSR<B>::set_value(int row, int col, double value) {
+    assert(row < _num_rows && col < _num_columns);
+
+    if (value == 0.0 && _pattern->find(row/B, col/B) < 0) return;
+    insert_block(row/B, col/B)[(row%B)*B + col%B] = value;
+}
+
+
+// * * * * * * * * * * * * * *  diagonal_solve * * * * * * * * * * * * * * * //
+template <int B>
+MATH::Vector MATH::matrixBSR<B>::diagonal_solve(const Vector& r) const {
+    Vector result(r.size());
+    diagonal_solve(r, result);
+    return result;
+}
+
+template <int B>
+void MATH::matrixBSR<B>::diagonal_solve(const Vector& r, Vector& result) const {
+    assert(static_cast<int>(r.size()) == _num_rows);
+    assert(static_cast<int>(result.size()) == _num_rows && "Result size does not match the number of rows in the matrix.");
+
+    // The blocks are solved in place
+    if (&result != &r) result = r;
+    int num_block_rows = get_num_block_rows();
+    // Exceptions must not leave the worker threads, failures are collected and thrown afterwards
+    std::atomic<bool> singular{false};
+    MATH::parallel_for(MATH::partition_uniform(num_block_rows), [&](int begin, int end) {
+        for (int I = begin; I < end; I++) {
+            const double* D = get_diagonal_block(I);
+            if (D == nullptr || !solve_block<B>(D, &result[I*B])) {
+                singular = true;
+            }
+        }
+    });
+    if (singular) {
+        throw std::runtime_error("Singular or missing diagonal block in matrix");
+    }
+}
+
+
+// * * * * * * * * * * * * * *  vector multiplication with * operator * * * * * * * * * * * * * * * //
+template <int B>
+MATH::Vector MATH::matrixBSR<B>::operator*(const Vector& rhs) const {
+    Vector result(_num_rows);
+    multiply(rhs, result);
+    return result;
+}
+
+
+// * * * * * * * * * * * * * *  multiply * * * * * * * * * * * * * * * //
+template <int B>
+void MATH::matrixBSR<B>::multiply(const Vector& rhs, Vector& result) const {
+    assert(static_cast<int>(rhs.size()) == _num_columns && "Vector size does not match the number of columns in the matrix.");
+    assert(static_cast<int>(result.size()) == _num_rows && "Result size does not match the number of rows in the matrix.");
+
+    const std::vector<int>& row_indices = _pattern->_row_indices;
+    const std::vector<int>& column_indices = _pattern->_column_indices;
+
+    // Block rows balanced by stored blocks
+    MATH::parallel_for(_pattern->get_row_partition(MATH::get_num_threads()), [&](int rowBegin, int rowEnd) {
+        for (int I = rowBegin; I < rowEnd; I++) {
+            double sum[B] = {};
+            for (int slot = row_indices[I]; slot < row_indices[I+1]; slot++) {
+                const double* block = _values.data() + slot*block_entries;
+                const double* x = &rhs[column_indices[slot]*B];
+                for (int i = 0; i < B; i++) {
+                    for (int j = 0; j < B; j++) {
+                        sum[i] += block[i*B + j] * x[j];
+                    }
+                }
+            }
+            for (int i = 0; i < B; i++) {
+                result[I*B + i] = sum[i];
+            }
+        }
+    });
+}
+
+
+// Explicity Template Instantiation
+template class MATH::matrixBSR<2>;
+template class MATH::matrixBSR<3>;
+template class MATH::matrixBSR<4>;
+template bool MATH::solve_block<2>(const double*, double*);
+template bool MATH::solve_block<3>(const double*, double*);
+template bool MATH::solve_block<4>(const double*, double*);
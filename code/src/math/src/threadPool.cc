@@ -0,0 +1,272 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      threadPool.cc
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     Implementation for the shared-memory parallel backend
+**
+\*------------------------------------------------------------------------*/
+
+#include "threadPool.hh"
+
+#include <cassert>
+#include <cstdlib>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+
+// Pool shared by all kernels, rebuilt when the thread count changes
+std::unique_ptr<MATH::threadPool> globalPool;
+std::mutex globalPoolMutex;
+
+// Set while a thread is executing a pool task (prevents nested dispatch)
+thread_local bool insideTask = false;
+
+// Summation mode of the reductions
+std::atomic<MATH::summationMode> globalSummationMode{MATH::summationMode::blocked};
+
+int default_num_threads()
+{
+    if (const char* env = std::getenv("LUNA_NUM_THREADS")) {
+        int num_threads = std::atoi(env);
+        if (num_threads > 0) return num_threads;
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+}
+
+
+// * * * * * * * * * * * * * *  set_num_threads * * * * * * * * * * * * * * * //
+void MATH::set_num_threads(int num_threads)
+{
+    assert(num_threads > 0 && "Number of threads must be positive");
+
+    std::lock_guard<std::mutex> lock(globalPoolMutex);
+    if (!globalPool || globalPool->get_num_threads() != num_threads) {
+        globalPool.reset();
+        globalPool = std::make_unique<threadPool>(num_threads);
+    }
+}
+
+
+// * * * * * * * * * * * * * *  get_num_threads * * * * * * * * * * * * * * * //
+int MATH::get_num_threads()
+{
+    return threadPool::instance().get_num_threads();
+}
+
+
+// * * * * * * * * * * * * * *  set_summation_mode * * * * * * * * * * * * * * * //
+void MATH::set_summation_mode(summationMode mode)
+{
+    globalSummationMode = mode;
+}
+
+
+// * * * * * * * * * * * * * *  get_summation_mode * * * * * * * * * * * * * * * //
+MATH::summationMode MATH::get_summation_mode()
+{
+    return globalSummationMode;
+}
+
+
+// * * * * * * * * * * * * * *  partition_uniform * * * * * * * * * * * * * * * //
+std::vector<int> MATH::partition_uniform(int n)
+{
+    int num_parts = std::max(1, std::min(get_num_threads(), n / parallelGrainSize));
+
+    // Interior bounds are rounded down to a multiple of 8 entries so that every chunk of a
+    //      (64-byte aligned) Vector starts on a cache line
+    std::vector<int> bounds(num_parts + 1);
+    for (int p = 0; p < num_parts; p++) {
+        bounds[p] = (static_cast<long long>(n) * p / num_parts) & ~7LL;
+    }
+    bounds[num_parts] = n;
+    return bounds;
+}
+
+
+// * * * * * * * * * * * * * *  partition_blocks * * * * * * * * * * * * * * * //
+std::vector<int> MATH::partition_blocks(int n)
+{
+    int num_blocks = std::max(1, (n + reductionBlockSize - 1) / reductionBlockSize);
+    std::vector<int> bounds(num_blocks + 1);
+    for (int k = 0; k < num_blocks; k++) {
+        bounds[k] = k * reductionBlockSize;
+    }
+    bounds[num_blocks] = n;
+    return bounds;
+}
+
+
+// * * * * * * * * * * * * * *  ordered_sum * * * * * * * * * * * * * * * //
+double MATH::ordered_sum(const double* values, int count, int stride)
+{
+    double sum = 0.0;
+    if (get_summation_mode() == summationMode::compensated) {
+        // Neumaier: the rounding error of every addition is carried separately
+        double error = 0.0;
+        for (int k = 0; k < count; k++) {
+            double value = values[k*stride];
+            double t = sum + value;
+            error += (std::abs(sum) >= std::abs(value)) ? (sum - t) + value : (value - t) + sum;
+            sum = t;
+        }
+        return sum + error;
+    }
+    for (int k = 0; k < count; k++) {
+        sum += values[k*stride];
+    }
+    return sum;
+}
+
+
+double MATH::ordered_sum(const compensatedSum* values, int count)
+{
+    // Neumaier on the block sums, the block errors are added to the correction
+    double sum = 0.0;
+    double error = 0.0;
+    for (int k = 0; k < count; k++) {
+        double value = values[k].sum;
+        double t = sum + value;
+        error += ((std::abs(sum) >= std::abs(value)) ? (sum - t) + value : (value - t) + sum) + values[k].error;
+        sum = t;
+    }
+    return sum + error;
+}
+
+
+// * * * * * * * * * * * * * *  partition_by_nnz * * * * * * * * * * * * * * * //
+// NOTE: chunk p starts at the first row whose offset reaches p*nnz/num_parts,
+//       so rows with many entries are not lumped together with a fixed row count
+std::vector<int> MATH::partition_by_nnz(const std::vector<int>& row_indices, int num_parts)
+{
+    int num_rows = row_indices.size() - 1;
+    int nnz = row_indices.back();
+    num_parts = std::max(1, std::min(num_parts, nnz / parallelGrainSize));
+
+    std::vector<int> bounds(num_parts + 1);
+    bounds[0] = 0;
+    bounds[num_parts] = num_rows;
+    for (int p = 1; p < num_parts; p++) {
+        long long target = static_cast<long long>(nnz) * p / num_parts;
+        int row = std::lower_bound(row_indices.begin(), row_indices.end() - 1, target) - row_indices.begin();
+        bounds[p] = std::max(bounds[p-1], row);
+    }
+    return bounds;
+}
+
+
+/*------------------------------------------------------------------------*\
+**  Class threadPool Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  Constructor * * * * * * * * * * * * * * * //
+MATH::threadPool::threadPool(int num_threads)
+{
+    for (int t = 1; t < num_threads; t++) {
+        _workers.emplace_back(&threadPool::worker_loop, this);
+    }
+}
+
+
+// * * * * * * * * * * * * * *  Destructor * * * * * * * * * * * * * * * //
+MATH::threadPool::~threadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _start.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+
+// * * * * * * * * * * * * * *  instance * * * * * * * * * * * * * * * //
+MATH::threadPool& MATH::threadPool::instance()
+{
+    std::lock_guard<std::mutex> lock(globalPoolMutex);
+    if (!globalPool) {
+        globalPool = std::make_unique<threadPool>(default_num_threads());
+    }
+    return *globalPool;
+}
+
+
+// * * * * * * * * * * * * * *  run * * * * * * * * * * * * * * * //
+void MATH::threadPool::run(int num_tasks, const std::function<void(int)>& task)
+{
+    // Serial path: nothing to distribute, or already inside a task
+    if (num_tasks <= 1 || _workers.empty() || insideTask) {
+        for (int t = 0; t < num_tasks; t++) {
+            task(t);
+        }
+        return;
+    }
+
+    // One run at a time: a second external caller waits until this run has finished
+    std::lock_guard<std::mutex> runLock(_runMutex);
+
+    {
+        // Workers still draining the previous run must leave before the task is replaced
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _active == 0; });
+        _task = &task;
+        _num_tasks = num_tasks;
+        _remaining = num_tasks;
+        _next_task = 0;
+        _generation++;
+    }
+    _start.notify_all();
+
+    // Calling thread takes part in the work
+    execute_tasks();
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this] { return _remaining.load() == 0; });
+    _task = nullptr;
+}
+
+
+// * * * * * * * * * * * * * *  execute_tasks * * * * * * * * * * * * * * * //
+void MATH::threadPool::execute_tasks()
+{
+    insideTask = true;
+    int t;
+    while ((t = _next_task.fetch_add(1)) < _num_tasks.load()) {
+        (*_task)(t);
+        if (_remaining.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done.notify_all();
+        }
+    }
+    insideTask = false;
+}
+
+
+// * * * * * * * * * * * * * *  worker_loop * * * * * * * * * * * * * * * //
+void MATH::threadPool::worker_loop()
+{
+    unsigned long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _start.wait(lock, [&] { return _stop || _generation != seen; });
+            if (_stop) return;
+            seen = _generation;
+            _active++;
+        }
+        execute_tasks();
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (--_active == 0) _done.notify_all();
+        }
+    }
+}
@@ -25,7 +25,7 @@
 
 // * * * * * * * * * * * * * * * orientation * * * * * * * * * * * * * * * //
                     //  origin          test point 1      test point 2
-int MATH::orientation(MATH::Vector p0, MATH::Vector p1, MATH::Vector q, MATH::Vector r)
+int MATH::orientation(const MATH::Vec<3>& p0, const MATH::Vec<3>& p1, const MATH::Vec<3>& q, const MATH::Vec<3>& r)
 {
     /*
     int val = (q[1] - p[1]) * (r[0] - q[0]) -
@@ -63,7 +63,7 @@ int MATH::orientation(MATH::Vector p0, MATH::Vector p1, MATH::Vector q, MATH::Ve
 }
 
 // Jarvis March Algorithm (modified for LUNA purposes): returns indices of points on convex hull
-std::vector<int> MATH::jarvis_march(std::vector<MATH::Vector> points) {
+std::vector<int> MATH::jarvis_march(const std::vector<MATH::Vec<3>>& points) {
     assert(points.size() >= 3 && "Jarvis march requires at least 3 points");
 
     for (const auto& point : points) {
@@ -90,7 +90,7 @@ std::vector<int> MATH::jarvis_march(std::vector<MATH::Vector> points) {
             // Check point orientation
             if (hull.size() == 1) {
                 // orientation relative to the vertical
-                orient = orientation(points[p]+MATH::Vector(std::vector<double>{0.0,1.0}), points[p], points[q], points[i]);
+                orient = orientation(points[p]+MATH::Vec<3>(std::vector<double>{0.0,1.0}), points[p], points[q], points[i]);
             }
             else {
                 orient = orientation(points[hull.rbegin()[1]], points[p], points[q], points[i]);
@@ -109,3 +109,100 @@ std::vector<int> MATH::jarvis_march(std::vector<MATH::Vector> points) {
 }
 
 
+
+
+/*------------------------------------------------------------------------*\
+**  Polygon Functions Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * * * polygon order * * * * * * * * * * * * * * * //
+void MATH::polygon_order(const double* coords, int count, int* order)
+{
+    assert(count >= 3 && "Polygon ordering requires at least 3 points");
+
+    int leftmost = 0;
+    for (int i = 1; i < count; i++) {
+        if (coords[2*i] < coords[2*leftmost]) leftmost = i;
+    }
+    const double* p = coords + 2*leftmost;
+
+    // Squared distance to the leftmost vertex (ties on the same ray, degenerate polygons only)
+    auto distance = [&](int i) {
+        double dx = coords[2*i] - p[0];
+        double dy = coords[2*i+1] - p[1];
+        return dx*dx + dy*dy;
+    };
+    // All other vertices lie in the closed right half plane of the leftmost one, so the orientation
+    //      predicate is a strict ordering of their directions (clockwise-most first)
+    auto before = [&](int a, int b) {
+        double orient = orient2d(p, coords + 2*a, coords + 2*b);
+        if (orient != 0.0) return orient > 0.0;
+        return distance(a) < distance(b);
+    };
+
+    // Insertion sort: elements have a handful of nodes
+    order[0] = leftmost;
+    int n = 1;
+    for (int i = 0; i < count; i++) {
+        if (i == leftmost) continue;
+        int j = n++;
+        while (j > 1 && before(i, order[j-1])) {
+            order[j] = order[j-1];
+            j--;
+        }
+        order[j] = i;
+    }
+}
+
+// * * * * * * * * * * * * * * * polygon area * * * * * * * * * * * * * * * //
+double MATH::polygon_area(const double* coords, const int* order, int count)
+{
+    // Shoelace formula relative to the first vertex (smaller products for elements far from the origin)
+    const double* o = coords + 2*order[0];
+    double twiceArea = 0.0;
+    for (int i = 1; i < count-1; i++) {
+        twiceArea += orient2d(o, coords + 2*order[i], coords + 2*order[i+1]);
+    }
+    return 0.5 * twiceArea;
+}
+
+// * * * * * * * * * * * * * * * polygon centroid * * * * * * * * * * * * * * * //
+double MATH::polygon_centroid(const double* coords, const int* order, int count, double* centroid)
+{
+    // Triangles: the centroid is the vertex average
+    if (count == 3) {
+        centroid[0] = (coords[0] + coords[2] + coords[4]) / 3.0;
+        centroid[1] = (coords[1] + coords[3] + coords[5]) / 3.0;
+        return polygon_area(coords, order, count);
+    }
+
+    // Fan of triangles about the first vertex: their signed areas weight their centroids
+    const double* o = coords + 2*order[0];
+    double twiceArea = 0.0;
+    double cx = 0.0;
+    double cy = 0.0;
+    for (int i = 1; i < count-1; i++) {
+        const double* a = coords + 2*order[i];
+        const double* b = coords + 2*order[i+1];
+        double w = orient2d(o, a, b);
+        twiceArea += w;
+        cx += w * (a[0] + b[0] - 2.0*o[0]);
+        cy += w * (a[1] + b[1] - 2.0*o[1]);
+    }
+
+    if (twiceArea == 0.0) {
+        cx = 0.0;
+        cy = 0.0;
+        for (int i = 0; i < count; i++) {
+            cx += coords[2*i];
+            cy += coords[2*i+1];
+        }
+        centroid[0] = cx / count;
+        centroid[1] = cy / count;
+        return 0.0;
+    }
+
+    centroid[0] = o[0] + cx / (3.0 * twiceArea);
+    centroid[1] = o[1] + cy / (3.0 * twiceArea);
+    return 0.5 * twiceArea;
+}
@@ -13,9 +13,35 @@
 
 #include "sparseMatrix.hh"
 #include "linearSolvers.hh"
+#include "sparseDirect.hh"
+#include "threadPool.hh"
 
 #include <vector>
 
+
+namespace {
+
+// 5-point Laplacian on an m x m grid (row = i*m + j) with a diagonal shift, and an upwind convection
+//      coupling to the j-1 neighbor (non-symmetric when convection is not zero)
+MATH::matrixCOO laplacian5(int m, double shift, double convection = 0.0)
+{
+    int n = m*m;
+    MATH::matrixCOO triplets(n, n);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) {
+            int row = i*m + j;
+            triplets.add_value(row, row, 4.0 + shift + convection);
+            if (i > 0)   triplets.add_value(row, row - m, -1.0);
+            if (i < m-1) triplets.add_value(row, row + m, -1.0);
+            if (j > 0)   triplets.add_value(row, row - 1, -1.0 - convection);
+            if (j < m-1) triplets.add_value(row, row + 1, -1.0);
+        }
+    }
+    return triplets;
+}
+
+}
+
 class solverTest 
 : 
 public 
@@ -101,3 +127,773 @@ TEST_F(solverTest, testConjugateGradient) {
     ASSERT_NEAR(sol[1], x[1] , tol);
     ASSERT_NEAR(sol[2], x[2] , tol);
 }
+
+// * * * * * * * * * * * * * * * * * * Test Block Solvers * * * * * * * * * * * * * * * * * * //
+class blockSolverTest 
+: 
+public 
+    ::testing::Test 
+{
+public:
+    // Constructor: block tridiagonal, diagonally dominant 2x2 blocks
+    blockSolverTest() : matrix(8,8), exact(8) {
+        for (int I = 0; I < 4; I++) {
+            double* D = matrix.insert_block(I,I);
+            D[0] = 6.0; D[1] = 1.0; D[2] = -2.0; D[3] = 5.0;
+            if (I > 0) {
+                double* L = matrix.insert_block(I,I-1);
+                L[0] = -1.0; L[3] = -1.0;
+            }
+            if (I < 3) {
+                double* U = matrix.insert_block(I,I+1);
+                U[0] = -1.0; U[1] = 0.5; U[3] = -1.0;
+            }
+        }
+        for (int i = 0; i < 8; i++) exact[i] = 1.0 + 0.5*i;
+        rhs = matrix * exact;
+    }
+protected:
+    double tol = 1.0e-8;
+    int iterations = 200;
+    MATH::matrixBSR<2> matrix;
+    MATH::Vector exact;
+    MATH::Vector rhs;
+};
+
+TEST_F(blockSolverTest, testBlockGaussSeidel) {
+    // Arrange
+    MATH::gauss_seidel<MATH::matrixBSR<2>> solver;
+    solver.set_matrix(matrix);
+    solver.set_rhs(rhs);
+    solver.set_guess(MATH::Vector(8, 0.0));
+
+    // Act
+    auto sol = solver.solve(iterations,tol);
+
+    // Assert
+    for (int i = 0; i < 8; i++) {
+        ASSERT_NEAR(sol[i], exact[i], 1e-6);
+    }
+}
+
+TEST_F(blockSolverTest, testBlockJacobi) {
+    // Arrange
+    MATH::jacobi<MATH::matrixBSR<2>> solver;
+    solver.set_matrix(matrix);
+    solver.set_rhs(rhs);
+    solver.set_guess(MATH::Vector(8, 0.0));
+
+    // Act
+    auto sol = solver.solve(iterations,tol);
+
+    // Assert
+    ASSERT_LT(solver.get_iterations(), iterations);
+    for (int i = 0; i < 8; i++) {
+        ASSERT_NEAR(sol[i], exact[i], 1e-6);
+    }
+}
+
+// * * * * * * * * * * * * * * * * * * Test AMG Preconditioned CG * * * * * * * * * * * * * * * * * * //
+TEST(test_preconditioners, testAMGConjugateGradient) {
+    // Arrange: 5-point Laplacian on a 40x40 grid with a Dirichlet shift
+    int m = 40;
+    int n = m*m;
+    MATH::matrixCSR A = laplacian5(m, 1e-3).to_CSR();
+    MATH::Vector b(n, 1.0);
+
+    MATH::conjugate_gradient<MATH::matrixCSR> plain;
+    plain.set_matrix(A);
+    plain.set_rhs(b);
+    plain.set_guess(MATH::Vector(n, 0.0));
+
+    auto amg = std::make_shared<MATH::amg_preconditioner<MATH::matrixCSR>>();
+    MATH::conjugate_gradient<MATH::matrixCSR> preconditioned;
+    preconditioned.set_matrix(A);
+    preconditioned.set_rhs(b);
+    preconditioned.set_guess(MATH::Vector(n, 0.0));
+    preconditioned.set_preconditioner(amg);
+
+    // Act
+    MATH::Vector x_plain = plain.solve(1000, 1e-8);
+    MATH::Vector x_amg = preconditioned.solve(1000, 1e-8);
+
+    // Assert: hierarchy was coarsened and CG needs far fewer iterations
+    ASSERT_GT(amg->get_num_levels(), 1);
+    ASSERT_LT(amg->get_level_size(amg->get_num_levels()-1), n/4);
+    ASSERT_LT(4*preconditioned.get_iterations(), plain.get_iterations());
+    ASSERT_LT((b - A*x_amg).getL2Norm(), 1e-6);
+
+    // Act: new values on the same pattern reuse the aggregation
+    preconditioned.set_matrix(A * 2.0);
+    preconditioned.set_guess(MATH::Vector(n, 0.0));
+    MATH::Vector x_scaled = preconditioned.solve(1000, 1e-8);
+
+    // Assert
+    ASSERT_EQ(amg->get_symbolic_setups(), 1);
+    ASSERT_NEAR(x_scaled[n/2], 0.5*x_amg[n/2], 1e-6);
+}
+
+// * * * * * * * * * * * * * * * * * * Test Preconditioned CG * * * * * * * * * * * * * * * * * * //
+TEST(test_preconditioners, testPreconditionerTypes) {
+    // Arrange: anisotropic SPD 5-point operator with variable edge coefficients on a 30x30 grid
+    int m = 30;
+    int n = m*m;
+    double ky = 0.1;
+    auto kx = [](int i, int j) { return 1.0 + 0.5*((i+j)%3); };  // edge (i,j)-(i,j+1)
+    MATH::matrixCOO triplets(n, n);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) {
+            int row = i*m + j;
+            triplets.add_value(row, row, 1e-3);
+            if (i < m-1) {
+                triplets.add_value(row, row, ky);
+                triplets.add_value(row + m, row + m, ky);
+                triplets.add_value(row, row + m, -ky);
+                triplets.add_value(row + m, row, -ky);
+            }
+            if (j < m-1) {
+                triplets.add_value(row, row, kx(i,j));
+                triplets.add_value(row + 1, row + 1, kx(i,j));
+                triplets.add_value(row, row + 1, -kx(i,j));
+                triplets.add_value(row + 1, row, -kx(i,j));
+            }
+        }
+    }
+    MATH::matrixCSR A = triplets.to_CSR();
+    MATH::Vector b(n);
+    for (int i = 0; i < n; i++) b[i] = 1.0 + (i%7) - 0.5*(i%3);
+
+    auto solve = [&](MATH::preconditionerType type) {
+        MATH::conjugate_gradient<MATH::matrixCSR> solver;
+        solver.set_matrix(A);
+        solver.set_rhs(b);
+        solver.set_guess(MATH::Vector(n, 0.0));
+        solver.set_preconditioner(MATH::make_preconditioner<MATH::matrixCSR>(type));
+        MATH::Vector x = solver.solve(2000, 1e-8);
+        EXPECT_LT((b - A*x).getL2Norm(), 1e-6);
+        return solver.get_iterations();
+    };
+
+    // Act
+    int none = solve(MATH::preconditionerType::none);
+    int jacobi = solve(MATH::preconditionerType::jacobi);
+    int ic0 = solve(MATH::preconditionerType::ic0);
+    int ssor = solve(MATH::preconditionerType::ssor);
+
+    // Assert
+    ASSERT_EQ(MATH::make_preconditioner<MATH::matrixCSR>(MATH::preconditionerType::none), nullptr);
+    ASSERT_LE(jacobi, none);
+    ASSERT_LT(2*ic0, none);
+    ASSERT_LT(2*ssor, none);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Non-Symmetric Krylov Solvers * * * * * * * * * * * * * * * * * * //
+TEST(test_krylov_solvers, testBiCGSTABAndGMRES) {
+    // Arrange: upwind convection-diffusion on a 20x20 grid (non-symmetric, diagonally dominant)
+    int m = 20;
+    int n = m*m;
+    MATH::matrixCSR A = laplacian5(m, 0.0, 4.0).to_CSR();
+    MATH::Vector b(n);
+    for (int i = 0; i < n; i++) b[i] = 1.0 + (i%5) - 0.3*(i%4);
+
+    auto solve = [&](MATH::linearSolverType type, MATH::preconditionerType preconditioner) {
+        std::unique_ptr<MATH::linear_solver_base<MATH::matrixCSR>> solver = MATH::make_linear_solver<MATH::matrixCSR>(type);
+        solver->set_matrix(A);
+        solver->set_rhs(b);
+        solver->set_guess(MATH::Vector(n, 0.0));
+        solver->set_preconditioner(MATH::make_preconditioner<MATH::matrixCSR>(preconditioner));
+        MATH::Vector x = solver->solve(1000, 1e-10);
+        EXPECT_LT((b - A*x).getL2Norm(), 1e-8);
+        return solver->get_iterations();
+    };
+
+    // Act
+    int bicgstab = solve(MATH::linearSolverType::bicgstab, MATH::preconditionerType::none);
+    int bicgstab_ssor = solve(MATH::linearSolverType::bicgstab, MATH::preconditionerType::ssor);
+    int gmres = solve(MATH::linearSolverType::gmres, MATH::preconditionerType::none);
+    int gmres_ssor = solve(MATH::linearSolverType::gmres, MATH::preconditionerType::ssor);
+
+    MATH::gmres<MATH::matrixCSR> gmres5(5);
+    gmres5.set_matrix(A);
+    gmres5.set_rhs(b);
+    gmres5.set_guess(MATH::Vector(n, 0.0));
+    MATH::Vector x5 = gmres5.solve(5000, 1e-10);
+
+    // Assert
+    ASSERT_LT(bicgstab_ssor, bicgstab);
+    ASSERT_LT(gmres_ssor, gmres);
+    ASSERT_EQ(gmres5.get_restart(), 5);
+    ASSERT_LT((b - A*x5).getL2Norm(), 1e-8);
+    ASSERT_GT(gmres5.get_iterations(), gmres);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Multiple Right-Hand Sides * * * * * * * * * * * * * * * * * * //
+TEST(test_multiple_rhs, testGaussSeidelSolveMultiple) {
+    // Arrange: diagonally dominant tridiagonal matrix and three right-hand sides, the second one trivial
+    int n = 50;
+    MATH::matrixCOO triplets(n, n);
+    for (int i = 0; i < n; i++) {
+        triplets.add_value(i, i, 3.0 + i%4);
+        if (i > 0) triplets.add_value(i, i-1, -1.0);
+        if (i < n-1) triplets.add_value(i, i+1, -1.5);
+    }
+    MATH::matrixCSR A = triplets.to_CSR();
+    std::vector<MATH::Vector> rhs(3, MATH::Vector(n, 0.0));
+    for (int i = 0; i < n; i++) {
+        rhs[0][i] = 1.0 + i%3;
+        rhs[2][i] = 0.5*i - 3.0;
+    }
+    std::vector<MATH::Vector> guesses(3, MATH::Vector(n, 0.0));
+    guesses[2] = MATH::Vector(n, 1.0);
+
+    std::vector<MATH::Vector> expected;
+    std::vector<int> expected_iterations;
+    for (int k = 0; k < 3; k++) {
+        MATH::gauss_seidel<MATH::matrixCSR> single;
+        single.set_matrix(A);
+        single.set_rhs(rhs[k]);
+        single.set_guess(guesses[k]);
+        expected.push_back(single.solve(200, 1e-10));
+        expected_iterations.push_back(single.get_iterations());
+    }
+
+    // Act
+    MATH::gauss_seidel<MATH::matrixCSR> solver;
+    solver.set_matrix(A);
+    std::vector<MATH::Vector> x = guesses;
+    solver.solve_multiple(rhs, x, 200, 1e-10);
+
+    // Assert: same iterates as one solve per right-hand side
+    ASSERT_EQ(x.size(), 3);
+    for (int k = 0; k < 3; k++) {
+        ASSERT_TRUE(x[k] == expected[k]);
+        ASSERT_EQ(solver.get_iterations(k), expected_iterations[k]);
+    }
+    ASSERT_LT(solver.get_residual(0), 1e-10);
+    ASSERT_LT((rhs[2] - A*x[2]).getL2Norm(), 1e-9);
+
+    // Act: one solve per right-hand side (base implementation) with a rhs bound beforehand
+    MATH::Vector b(n, 1.0);
+    MATH::bicgstab<MATH::matrixCSR> krylov;
+    krylov.set_matrix(A);
+    krylov.set_rhs(b);
+    std::vector<MATH::Vector> y = guesses;
+    krylov.solve_multiple(rhs, y, 200, 1e-10);
+
+    // Assert: the caller's rhs is bound again, not the last right-hand side of the block
+    ASSERT_EQ(&krylov.get_rhs(), &b);
+    ASSERT_LT((rhs[0] - A*y[0]).getL2Norm(), 1e-8);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Multicolor Gauss-Seidel * * * * * * * * * * * * * * * * * * //
+TEST(test_multicolor, testMulticolorGaussSeidel) {
+    // Arrange: 5-point Laplacian with a shift, large enough to be split over threads
+    int m = 100;
+    int n = m*m;
+    MATH::matrixCSR A = laplacian5(m, 0.5).to_CSR();
+    MATH::Vector b(n);
+    for (int i = 0; i < n; i++) b[i] = 1.0 + (i%7) - 0.5*(i%3);
+
+    auto solve = [&](MATH::linearSolverType type) {
+        std::unique_ptr<MATH::linear_solver_base<MATH::matrixCSR>> solver = MATH::make_linear_solver<MATH::matrixCSR>(type);
+        solver->set_matrix(A);
+        solver->set_rhs(b);
+        solver->set_guess(MATH::Vector(n, 0.0));
+        MATH::Vector x = solver->solve(1000, 1e-8);
+        return std::make_pair(x, solver->get_iterations());
+    };
+
+    // Act
+    MATH::set_num_threads(1);
+    auto [x_gs, gs] = solve(MATH::linearSolverType::gauss_seidel);
+    auto [x_serial, mc_serial] = solve(MATH::linearSolverType::multicolor_gauss_seidel);
+    MATH::set_num_threads(4);
+    auto [x_parallel, mc_parallel] = solve(MATH::linearSolverType::multicolor_gauss_seidel);
+    MATH::set_num_threads(1);
+
+    // Assert: same result for any thread count, GS-like convergence
+    ASSERT_LT((b - A*x_serial).getL2Norm(), 1e-8);
+    ASSERT_TRUE(x_serial == x_parallel);
+    ASSERT_EQ(mc_serial, mc_parallel);
+    ASSERT_LT(mc_serial, 2*gs);
+
+    // Act: as AMG smoother
+    auto amg = std::make_shared<MATH::amg_preconditioner<MATH::matrixCSR>>();
+    amg->set_smoother(MATH::amgSmoother::multicolor_gauss_seidel);
+    MATH::conjugate_gradient<MATH::matrixCSR> pcg;
+    pcg.set_matrix(A);
+    pcg.set_rhs(b);
+    pcg.set_guess(MATH::Vector(n, 0.0));
+    pcg.set_preconditioner(amg);
+    MATH::Vector x_amg = pcg.solve(1000, 1e-8);
+
+    // Assert
+    ASSERT_LT((b - A*x_amg).getL2Norm(), 1e-8);
+    ASSERT_LT(pcg.get_iterations(), 20);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test SOR / SSOR * * * * * * * * * * * * * * * * * * //
+TEST(test_sor, testSORAndSSOR) {
+    // Arrange: 5-point Laplacian with a small shift on a 30x30 grid
+    int m = 30;
+    int n = m*m;
+    MATH::matrixCSR A = laplacian5(m, 1e-2).to_CSR();
+    MATH::Vector b(n);
+    for (int i = 0; i < n; i++) b[i] = 1.0 + (i%5) - 0.5*(i%3);
+
+    auto solve = [&](MATH::sor<MATH::matrixCSR>& solver) {
+        solver.set_matrix(A);
+        solver.set_rhs(b);
+        solver.set_guess(MATH::Vector(n, 0.0));
+        MATH::Vector x = solver.solve(5000, 1e-8);
+        // Reported residual is the true residual
+        EXPECT_LT((b - A*x).getL2Norm(), 1e-8);
+        EXPECT_NEAR(solver.get_residual(), (b - A*x).getL2Norm(), 1e-12);
+        return solver.get_iterations();
+    };
+
+    MATH::gauss_seidel<MATH::matrixCSR> gs;
+    gs.set_matrix(A);
+    gs.set_rhs(b);
+    gs.set_guess(MATH::Vector(n, 0.0));
+    gs.solve(5000, 1e-8);
+
+    // Act
+    MATH::sor<MATH::matrixCSR> sor1;
+    MATH::sor<MATH::matrixCSR> sor17(1.7);
+    MATH::ssor<MATH::matrixCSR> ssor17(1.7);
+    int iterations_sor1 = solve(sor1);
+    int iterations_sor17 = solve(sor17);
+    int iterations_ssor17 = solve(ssor17);
+
+    // Assert: w = 1 behaves as Gauss-Seidel (the in-sweep residual lags the true one by a few sweeps),
+    //         over-relaxation converges much faster
+    ASSERT_GE(iterations_sor1, gs.get_iterations());
+    ASSERT_LT(iterations_sor1, 1.1*gs.get_iterations());
+    ASSERT_LT(3*iterations_sor17, iterations_sor1);
+    ASSERT_LT(3*iterations_ssor17, iterations_sor1);
+
+    // Stopped at maxIterations: the reported residual is still the true one
+    for (MATH::sor<MATH::matrixCSR>* solver : {&sor17, static_cast<MATH::sor<MATH::matrixCSR>*>(&ssor17)}) {
+        solver->set_guess(MATH::Vector(n, 0.0));
+        MATH::Vector x = solver->solve(5, 1e-8);
+        ASSERT_EQ(solver->get_iterations(), 5);
+        EXPECT_GT(solver->get_residual(), 1e-8);
+        EXPECT_NEAR(solver->get_residual(), (b - A*x).getL2Norm(), 1e-12);
+    }
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Persistent Solver * * * * * * * * * * * * * * * * * * //
+TEST(test_persistent_solver, testReferencedMatrixAndWorkspace) {
+    // Arrange: tridiagonal SPD matrix, solver set up once
+    int n = 40;
+    MATH::matrixCOO triplets(n, n);
+    for (int i = 0; i < n; i++) {
+        triplets.add_value(i, i, 3.0);
+        if (i > 0) triplets.add_value(i, i-1, -1.0);
+        if (i < n-1) triplets.add_value(i, i+1, -1.0);
+    }
+    MATH::matrixCSR A = triplets.to_CSR();
+    MATH::Vector b(n);
+    for (int i = 0; i < n; i++) b[i] = 1.0 + (i%4);
+
+    MATH::conjugate_gradient<MATH::matrixCSR> solver;
+    solver.set_matrix(A);
+    solver.set_rhs(b);
+
+    // Act
+    solver.set_guess(MATH::Vector(n, 0.0));
+    const MATH::Vector& x = solver.solve(100, 1e-12);
+    MATH::Vector x_first = x;
+
+    // New values in the referenced matrix and rhs, no new set_matrix/set_rhs
+    A = A * 2.0;
+    for (int i = 0; i < n; i++) b[i] *= 4.0;
+    solver.set_guess(MATH::Vector(n, 0.0));
+    const MATH::Vector& x_second = solver.solve(100, 1e-12);
+
+    // Assert: the solver followed the updates and returns the same (persistent) solution storage
+    ASSERT_EQ(&x, &x_second);
+    ASSERT_EQ(&solver.get_matrix(), &A);
+    for (int i = 0; i < n; i++) {
+        ASSERT_NEAR(x_second[i], 2.0*x_first[i], 1e-9);
+    }
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Mixed Precision Refinement * * * * * * * * * * * * * * * * * * //
+TEST(test_mixed_precision, testRefinementReachesDoubleTolerance) {
+    // Arrange: 2D Laplacian with entries that are not exact in float
+    int m = 30;
+    int n = m*m;
+    MATH::matrixCOO triplets(n, n);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) {
+            int row = i*m + j;
+            triplets.add_value(row, row, 4.1 + 0.01*(row%7));
+            if (i > 0)   triplets.add_value(row, row-m, -1.0/3.0);
+            if (i < m-1) triplets.add_value(row, row+m, -1.0/3.0);
+            if (j > 0)   triplets.add_value(row, row-1, -1.0);
+            if (j < m-1) triplets.add_value(row, row+1, -1.0);
+        }
+    }
+    MATH::matrixCSR A = triplets.to_CSR();
+    MATH::Vector b(n);
+    for (int i = 0; i < n; i++) b[i] = std::sin(0.1*i);
+    double tol = 1e-11;
+
+    MATH::conjugate_gradient<MATH::matrixCSR> reference;
+    reference.set_matrix(A);
+    reference.set_rhs(b);
+    reference.set_guess(MATH::Vector(n, 0.0));
+    MATH::Vector x_ref = reference.solve(1000, tol);
+
+    // Act
+    MATH::mixed_precision_refinement<MATH::matrixCSR> solver;
+    solver.set_matrix(A);
+    solver.set_rhs(b);
+    solver.set_preconditioner(std::make_shared<MATH::jacobi_preconditioner<MATH::matrixCSR>>());
+    solver.set_guess(MATH::Vector(n, 0.0));
+    const MATH::Vector& x = solver.solve(1000, tol);
+
+    // Assert: float products, but the double precision residual meets the tolerance
+    MATH::Vector y(n);
+    solver.get_float_matrix().multiply(b, y);
+    MATH::Vector y_ref = A * b;
+    for (int i = 0; i < n; i++) {
+        ASSERT_NEAR(y[i], y_ref[i], 1e-6);
+    }
+    MATH::Vector r = A * x - b;
+    EXPECT_LT(r.getL2Norm(), tol);
+    EXPECT_LT(solver.get_residual(), tol);
+    EXPECT_GT(solver.get_refinements(), 1);
+    for (int i = 0; i < n; i++) {
+        ASSERT_NEAR(x[i], x_ref[i], 1e-10);
+    }
+
+    // The factory builds it as well
+    auto made = MATH::make_linear_solver<MATH::matrixCSR>(MATH::linearSolverType::mixed_precision);
+    ASSERT_NE(dynamic_cast<MATH::mixed_precision_refinement<MATH::matrixCSR>*>(made.get()), nullptr);
+}
+
+
+// Matrix-free 1D convection-diffusion stencil: (A x)_i = (2+c) x_i - (1+c) x_{i-1} - x_{i+1}
+class stencilOperator
+:
+    public MATH::linearOperator
+{
+public:
+    stencilOperator(int n, double c) : MATH::linearOperator(n, n), _c(c) {};
+
+    void multiply(const MATH::Vector& x, MATH::Vector& y) const override {
+        for (int i = 0; i < _num_rows; i++) {
+            y[i] = (2.0 + _c)*x[i];
+            if (i > 0)             y[i] -= (1.0 + _c)*x[i-1];
+            if (i < _num_rows - 1) y[i] -= x[i+1];
+        }
+    };
+    MATH::Vector get_diagonal() const override { return MATH::Vector(_num_rows, 2.0 + _c); };
+
+private:
+    double _c;
+};
+
+TEST(test_linear_operator, testMatrixFreeMatchesAssembled) {
+    // Arrange: the same operator, matrix-free and assembled
+    int n = 200;
+    static_assert(MATH::solverOperator<MATH::linearOperator> && MATH::solverOperator<MATH::matrixCSR>);
+    for (double c : {0.0, 0.5}) {
+        stencilOperator op(n, c);
+        MATH::matrixCOO triplets(n, n);
+        for (int i = 0; i < n; i++) {
+            triplets.add_value(i, i, 2.0 + c);
+            if (i > 0)     triplets.add_value(i, i-1, -(1.0 + c));
+            if (i < n - 1) triplets.add_value(i, i+1, -1.0);
+        }
+        MATH::matrixCSR A = triplets.to_CSR();
+        MATH::Vector b(n);
+        for (int i = 0; i < n; i++) b[i] = std::cos(0.05*i);
+
+        // Act: CG on the symmetric case, BiCGSTAB on the convective one, both Jacobi preconditioned
+        std::unique_ptr<MATH::linear_solver_base<MATH::linearOperator>> matrixFree;
+        std::unique_ptr<MATH::linear_solver_base<MATH::matrixCSR>> assembled;
+        if (c == 0.0) {
+            matrixFree = std::make_unique<MATH::conjugate_gradient<MATH::linearOperator>>();
+            assembled = std::make_unique<MATH::conjugate_gradient<MATH::matrixCSR>>();
+        }
+        else {
+            matrixFree = std::make_unique<MATH::bicgstab<MATH::linearOperator>>();
+            assembled = std::make_unique<MATH::bicgstab<MATH::matrixCSR>>();
+        }
+        matrixFree->set_matrix(op);
+        matrixFree->set_rhs(b);
+        matrixFree->set_guess(MATH::Vector(n, 0.0));
+        matrixFree->set_preconditioner(std::make_shared<MATH::jacobi_preconditioner<MATH::linearOperator>>());
+        assembled->set_matrix(A);
+        assembled->set_rhs(b);
+        assembled->set_guess(MATH::Vector(n, 0.0));
+        assembled->set_preconditioner(std::make_shared<MATH::jacobi_preconditioner<MATH::matrixCSR>>());
+        const MATH::Vector& x = matrixFree->solve(2000, 1e-10);
+        const MATH::Vector& x_ref = assembled->solve(2000, 1e-10);
+
+        // Assert: same products, same iterates
+        MATH::Vector y = op * b;
+        MATH::Vector y_ref = A * b;
+        for (int i = 0; i < n; i++) {
+            ASSERT_DOUBLE_EQ(y[i], y_ref[i]);
+        }
+        EXPECT_LT((A * x - b).getL2Norm(), 1e-9);
+        EXPECT_EQ(matrixFree->get_iterations(), assembled->get_iterations());
+        for (int i = 0; i < n; i++) {
+            ASSERT_NEAR(x[i], x_ref[i], 1e-9);
+        }
+    }
+}
+
+
+TEST(test_deflated_cg, testRecyclingReducesIterations) {
+    // Arrange: sequence of slowly changing 2D diffusion systems (like the pressure correction across outer iterations)
+    int m = 40;
+    int n = m*m;
+    auto diffusion = [&](double drift) {
+        MATH::matrixCOO triplets(n, n);
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < m; j++) {
+                int row = i*m + j;
+                double kx = 1.0 + drift*std::sin(0.2*i);
+                triplets.add_value(row, row, 2.0*kx + 2.0 + (i == 0 ? 1.0 : 0.0));
+                if (i > 0)   triplets.add_value(row, row-m, -1.0);
+                if (i < m-1) triplets.add_value(row, row+m, -1.0);
+                if (j > 0)   triplets.add_value(row, row-1, -kx);
+                if (j < m-1) triplets.add_value(row, row+1, -kx);
+            }
+        }
+        return triplets.to_CSR();
+    };
+    MATH::Vector b(n);
+    for (int i = 0; i < n; i++) b[i] = 1.0 + 0.1*std::cos(0.3*i);
+    double tol = 1e-8;
+
+    MATH::deflated_conjugate_gradient<MATH::matrixCSR> deflated;
+    deflated.set_refresh_interval(3);
+    deflated.set_preconditioner(std::make_shared<MATH::jacobi_preconditioner<MATH::matrixCSR>>());
+    deflated.set_rhs(b);
+
+    int firstIterations = 0;
+    for (int solve = 0; solve < 6; solve++) {
+        MATH::matrixCSR A = diffusion(0.01*solve);
+        MATH::conjugate_gradient<MATH::matrixCSR> reference;
+        reference.set_matrix(A);
+        reference.set_rhs(b);
+        reference.set_preconditioner(std::make_shared<MATH::jacobi_preconditioner<MATH::matrixCSR>>());
+        reference.set_guess(MATH::Vector(n, 0.0));
+        MATH::Vector x_ref = reference.solve(5000, tol);
+
+        // Act
+        deflated.set_matrix(A);
+        deflated.set_guess(MATH::Vector(n, 0.0));
+        MATH::Vector x = deflated.solve(5000, tol);
+
+        // Assert: same solution, the first solve is plain CG and later ones recycle
+        EXPECT_LT((A * x - b).getL2Norm(), tol);
+        for (int i = 0; i < n; i++) {
+            ASSERT_NEAR(x[i], x_ref[i], 1e-6);
+        }
+        if (solve == 0) {
+            EXPECT_EQ(deflated.get_iterations(), reference.get_iterations());
+            firstIterations = deflated.get_iterations();
+        }
+        else {
+            EXPECT_LT(deflated.get_iterations(), 0.85*firstIterations);
+        }
+        EXPECT_EQ(deflated.get_deflation_vectors().size(), 4u);
+
+        // W is built by the first solve and refreshed every third solve only
+        EXPECT_EQ(deflated.get_refreshes(), 1 + solve/3);
+    }
+
+    // The factory builds it as well
+    auto made = MATH::make_linear_solver<MATH::matrixCSR>(MATH::linearSolverType::deflated_conjugate_gradient);
+    ASSERT_NE(dynamic_cast<MATH::deflated_conjugate_gradient<MATH::matrixCSR>*>(made.get()), nullptr);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Chebyshev * * * * * * * * * * * * * * * * * * //
+TEST(test_chebyshev, testCachedEstimatesAndSmoother) {
+    // Arrange: 5-point Laplacian with a small shift on a 30x30 grid, solved for a few right-hand sides
+    int m = 30;
+    int n = m*m;
+    MATH::matrixCSR A = laplacian5(m, 1e-1).to_CSR();
+    double tol = 1e-8;
+
+    MATH::chebyshev<MATH::matrixCSR> chebyshev;
+    chebyshev.set_matrix(A);
+    chebyshev.set_preconditioner(std::make_shared<MATH::jacobi_preconditioner<MATH::matrixCSR>>());
+
+    for (int solve = 0; solve < 3; solve++) {
+        MATH::Vector b(n);
+        for (int i = 0; i < n; i++) b[i] = 1.0 + (i%5) - 0.5*(i%3) + 0.1*solve*std::sin(0.1*i);
+
+        // Act
+        chebyshev.set_rhs(b);
+        chebyshev.set_guess(MATH::Vector(n, 0.0));
+        MATH::Vector x = chebyshev.solve(5000, tol);
+
+        // Assert: converged, the spectrum of D^-1 A (inside (0, 2)) is estimated once and kept
+        EXPECT_LT((b - A*x).getL2Norm(), tol);
+        EXPECT_EQ(chebyshev.get_estimates(), 1);
+        EXPECT_GT(chebyshev.get_min_eigenvalue(), 0.0);
+        EXPECT_LT(chebyshev.get_min_eigenvalue(), 0.2);
+        EXPECT_GT(chebyshev.get_max_eigenvalue(), 1.8);
+        EXPECT_LT(chebyshev.get_max_eigenvalue(), 2.2);
+        EXPECT_LT(chebyshev.get_iterations(), 300);
+    }
+
+    // Act: as AMG smoother
+    MATH::Vector b(n);
+    for (int i = 0; i < n; i++) b[i] = 1.0 + (i%5) - 0.5*(i%3);
+    auto amg = std::make_shared<MATH::amg_preconditioner<MATH::matrixCSR>>();
+    amg->set_smoother(MATH::amgSmoother::chebyshev);
+    MATH::conjugate_gradient<MATH::matrixCSR> pcg;
+    pcg.set_matrix(A);
+    pcg.set_rhs(b);
+    pcg.set_guess(MATH::Vector(n, 0.0));
+    pcg.set_preconditioner(amg);
+    MATH::Vector x_amg = pcg.solve(1000, tol);
+
+    // Assert
+    ASSERT_LT((b - A*x_amg).getL2Norm(), tol);
+    ASSERT_LT(pcg.get_iterations(), 20);
+
+    // The factory builds it as well
+    auto made = MATH::make_linear_solver<MATH::matrixCSR>(MATH::linearSolverType::chebyshev);
+    ASSERT_NE(dynamic_cast<MATH::chebyshev<MATH::matrixCSR>*>(made.get()), nullptr);
+}
+
+TEST(test_chebyshev, testFailedEstimate) {
+    // Arrange: negative definite matrix, no preconditioner
+    int m = 10;
+    int n = m*m;
+    MATH::matrixCSR A = laplacian5(m, 1e-1).to_CSR() * -1.0;
+    MATH::Vector b(n, 1.0);
+
+    MATH::chebyshev<MATH::matrixCSR> chebyshev;
+    chebyshev.set_matrix(A);
+    chebyshev.set_rhs(b);
+
+    // Act + Assert: without an iteration budget the guess is returned with its residual
+    chebyshev.set_guess(MATH::Vector(n, 0.0));
+    chebyshev.solve(0, 1e-8);
+    EXPECT_EQ(chebyshev.get_iterations(), 0);
+    EXPECT_DOUBLE_EQ(chebyshev.get_residual(), b.getL2Norm());
+    EXPECT_EQ(chebyshev.get_estimates(), 0);
+
+    // Act + Assert: the eigenvalue estimate reports the indefinite spectrum instead of returning silently
+    chebyshev.set_guess(MATH::Vector(n, 0.0));
+    EXPECT_THROW(chebyshev.solve(100, 1e-8), std::runtime_error);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test sparse direct * * * * * * * * * * * * * * * * * * //
+TEST(test_sparse_direct, testCholeskyAndLU) {
+    // Arrange: 2D diffusion on a 30x30 grid, pure Neumann (singular) or with a convective part (non-symmetric)
+    int m = 30;
+    int n = m*m;
+    auto assemble = [&](double shift, double convection) {
+        MATH::matrixCOO triplets(n, n);
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < m; j++) {
+                int row = i*m + j;
+                // Diffusivity evaluated at the face centers keeps the diffusive part symmetric
+                auto k = [](double x, double y) { return 1.0 + 0.5*std::sin(0.3*x + 0.2*y); };
+                double diagonal = shift;
+                auto couple = [&](int column, double a) { triplets.add_value(row, column, -a); diagonal += a; };
+                if (i > 0)   couple(row - m, k(i - 0.5, j));
+                if (i < m-1) couple(row + m, k(i + 0.5, j));
+                if (j > 0)   couple(row - 1, k(i, j - 0.5) + convection);
+                if (j < m-1) couple(row + 1, k(i, j + 0.5));
+                triplets.add_value(row, row, diagonal);
+            }
+        }
+        return triplets.to_CSR();
+    };
+    MATH::Vector b(n);
+    for (int i = 0; i < n; i++) b[i] = std::cos(0.1*i);
+    double tol = 1e-10;
+
+    // Act: SPD system, then new values on the same pattern
+    MATH::matrixCSR A = assemble(0.1, 0.0);
+    MATH::sparse_direct<MATH::matrixCSR> cholesky(MATH::directFactorization::cholesky);
+    cholesky.set_matrix(A);
+    cholesky.set_rhs(b);
+    MATH::Vector x = cholesky.solve(10, tol);
+
+    // Assert: solved without refinement, the ordering keeps the fill well below the band of the natural ordering
+    EXPECT_LT((b - A*x).getL2Norm(), tol);
+    EXPECT_EQ(cholesky.get_iterations(), 1);
+    EXPECT_EQ(cholesky.get_zero_pivots(), 0);
+    EXPECT_LT(cholesky.get_factor_nonzeros(), n*m/2);
+    std::vector<int> ordering = cholesky.get_ordering();
+    std::sort(ordering.begin(), ordering.end());
+    for (int i = 0; i < n; i++) ASSERT_EQ(ordering[i], i);
+
+    A.get_values() = assemble(0.2, 0.0).get_values();
+    x = cholesky.solve(10, tol);
+    EXPECT_LT((b - A*x).getL2Norm(), tol);
+    EXPECT_EQ(cholesky.get_symbolic_factorizations(), 1);
+    EXPECT_EQ(cholesky.get_numeric_factorizations(), 2);
+
+    // Act: pure Neumann system with a consistent rhs (zero mean)
+    MATH::matrixCSR neumann = assemble(0.0, 0.0);
+    MATH::Vector bNeumann = b;
+    double mean = 0.0;
+    for (int i = 0; i < n; i++) mean += b[i] / n;
+    for (int i = 0; i < n; i++) bNeumann[i] -= mean;
+    MATH::sparse_direct<MATH::matrixCSR> singular;
+    singular.set_matrix(neumann);
+    singular.set_rhs(bNeumann);
+    MATH::Vector xNeumann = singular.solve(10, 1e-8);
+    MATH::conjugate_gradient<MATH::matrixCSR> cg;
+    cg.set_matrix(neumann);
+    cg.set_rhs(bNeumann);
+    cg.set_guess(MATH::Vector(n, 0.0));
+    MATH::Vector xCG = cg.solve(5000, 1e-10);
+
+    // Assert: one pinned unknown, same (zero mean) solution as CG from a zero guess
+    EXPECT_EQ(singular.get_zero_pivots(), 1);
+    EXPECT_LT((bNeumann - neumann*xNeumann).getL2Norm(), 1e-8);
+    for (int i = 0; i < n; i++) {
+        ASSERT_NEAR(xNeumann[i], xCG[i], 1e-6);
+    }
+
+    // Act: non-symmetric system, several right-hand sides sharing the factorization
+    MATH::matrixCSR convective = assemble(0.1, 2.0);
+    auto lu = MATH::make_linear_solver<MATH::matrixCSR>(MATH::linearSolverType::direct_lu);
+    lu->set_matrix(convective);
+    std::vector<MATH::Vector> rhs = {b, 2.0*b, MATH::Vector(n, 1.0)};
+    std::vector<MATH::Vector> solutions(3, MATH::Vector(n, 0.0));
+    lu->set_rhs(b);
+    lu->solve_multiple(rhs, solutions, 10, tol);
+
+    // Assert: the rhs bound before solve_multiple is bound again afterwards
+    auto* direct = dynamic_cast<MATH::sparse_direct<MATH::matrixCSR>*>(lu.get());
+    ASSERT_NE(direct, nullptr);
+    EXPECT_EQ(direct->get_numeric_factorizations(), 1);
+    EXPECT_EQ(&lu->get_rhs(), &b);
+    for (int k = 0; k < 3; k++) {
+        EXPECT_LT((rhs[k] - convective*solutions[k]).getL2Norm(), tol);
+        EXPECT_LT(lu->get_residual(k), tol);
+    }
+
+    // Act + Assert: symmetric indefinite system, Cholesky reports the negative pivot instead of pinning it
+    MATH::matrixCSR indefinite = assemble(-1.0, 0.0);
+    MATH::sparse_direct<MATH::matrixCSR> notSPD(MATH::directFactorization::cholesky);
+    notSPD.set_matrix(indefinite);
+    notSPD.set_rhs(b);
+    EXPECT_THROW(notSPD.solve(10, tol), std::runtime_error);
+}
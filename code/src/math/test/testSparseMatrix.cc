@@ -11,8 +11,36 @@
 #include <gtest/gtest.h>
 
 #include "sparseMatrix.hh"
+#include "cpuFeatures.hh"
+#include "matrixMarket.hh"
 
 #include <vector>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+
+namespace {
+
+// 5-point Laplacian on an m x m grid (row = i*m + j)
+MATH::matrixCOO laplacian5(int m)
+{
+    int n = m*m;
+    MATH::matrixCOO triplets(n, n);
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) {
+            int row = i*m + j;
+            triplets.add_value(row, row, 4.0);
+            if (i > 0)   triplets.add_value(row, row - m, -1.0);
+            if (i < m-1) triplets.add_value(row, row + m, -1.0);
+            if (j > 0)   triplets.add_value(row, row - 1, -1.0);
+            if (j < m-1) triplets.add_value(row, row + 1, -1.0);
+        }
+    }
+    return triplets;
+}
+
+}
 
 
 TEST(test_sparse_matrix, Rows_Columns) {
@@ -91,4 +119,315 @@ TEST(MatrixTest, VectorMultiplication) {
     ASSERT_DOUBLE_EQ(result[0], 2.0);
     ASSERT_DOUBLE_EQ(result[1], 8.0);
     ASSERT_DOUBLE_EQ(result[2], -36.0);
-}
\ No newline at end of file
+}
+
+// * * * * * * * * * * * * * * * * * * Test COO Assembly Builder * * * * * * * * * * * * * * * * * * //
+TEST(MatrixTest, COOToCSR) {
+    // Arrange: entries out of order, with duplicates
+    MATH::matrixCOO triplets(3, 4);
+    triplets.reserve(7);
+    triplets.add_value(2, 2, 4.0);
+    triplets.add_value(0, 3, 1.0);
+    triplets.add_value(1, 1, 2.0);
+    triplets.add_value(0, 0, 5.0);
+    triplets.add_value(2, 1, -3.0);
+    triplets.add_value(1, 1, 3.0);
+    triplets.add_value(0, 3, -0.5);
+
+    // Act
+    MATH::matrixCSR matrix = triplets.to_CSR();
+
+    // Assert
+    ASSERT_EQ(triplets.get_num_entries(), 7);
+    ASSERT_EQ(matrix.get_num_rows(), 3);
+    ASSERT_EQ(matrix.get_num_columns(), 4);
+    ASSERT_DOUBLE_EQ(matrix.get_value(0, 0), 5.0);
+    ASSERT_DOUBLE_EQ(matrix.get_value(0, 3), 0.5);
+    ASSERT_DOUBLE_EQ(matrix.get_value(1, 1), 5.0);
+    ASSERT_DOUBLE_EQ(matrix.get_value(2, 1), -3.0);
+    ASSERT_DOUBLE_EQ(matrix.get_value(2, 2), 4.0);
+    ASSERT_DOUBLE_EQ(matrix.get_value(1, 0), 0.0);
+}
+
+TEST(MatrixTest, COOMatchesSetValue) {
+    // Arrange
+    MATH::matrixCSR expected(3, 3);
+    MATH::matrixCOO triplets(3, 3);
+    double values[3][3] = { {4.0, -1.0, 0.0}, {-1.0, 4.0, -1.0}, {0.0, -1.0, 4.0} };
+    for (int i = 2; i >= 0; i--) {
+        for (int j = 0; j < 3; j++) {
+            expected.set_value(i, j, values[i][j]);
+            if (values[i][j] != 0.0) triplets.add_value(i, j, values[i][j]);
+        }
+    }
+
+    // Act
+    MATH::matrixCSR matrix = triplets.to_CSR();
+    std::vector<double> v = {1.0, 2.0, 3.0};
+    auto result = matrix * v;
+    auto reference = expected * v;
+
+    // Assert
+    for (int i = 0; i < 3; i++) {
+        ASSERT_DOUBLE_EQ(result[i], reference[i]);
+    }
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Shared Sparsity Pattern * * * * * * * * * * * * * * * * * * //
+TEST(MatrixTest, SharedPattern) {
+    // Arrange
+    MATH::matrixCOO triplets(2, 2);
+    triplets.add_value(0, 0, 0.0);
+    triplets.add_value(0, 1, 0.0);
+    triplets.add_value(1, 1, 0.0);
+    auto pattern = triplets.to_CSR().get_pattern();
+
+    // Act: two matrices on the same pattern, values written in place
+    MATH::matrixCSR A(pattern);
+    MATH::matrixCSR B(pattern);
+    A.get_values()[pattern->find(0, 1)] = 3.0;
+    B.get_values()[pattern->find(1, 1)] = 2.0;
+
+    // Assert
+    ASSERT_EQ(pattern->get_nnz(), 3);
+    ASSERT_EQ(A.get_pattern(), B.get_pattern());
+    ASSERT_EQ(pattern->find(1, 0), -1);
+    ASSERT_DOUBLE_EQ(A.get_value(0, 1), 3.0);
+    ASSERT_DOUBLE_EQ(A.get_value(1, 1), 0.0);
+    ASSERT_DOUBLE_EQ(B.get_value(1, 1), 2.0);
+
+    // Act: structural change copies the pattern instead of modifying the shared one
+    A.set_value(1, 0, 1.0);
+
+    // Assert
+    ASSERT_NE(A.get_pattern(), B.get_pattern());
+    ASSERT_EQ(pattern->get_nnz(), 3);
+    ASSERT_DOUBLE_EQ(A.get_value(1, 0), 1.0);
+    ASSERT_DOUBLE_EQ(B.get_value(1, 0), 0.0);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Diagonal Access * * * * * * * * * * * * * * * * * * //
+TEST(MatrixTest, DiagonalAccess) {
+    // Arrange: insert out of order so columns must be kept sorted
+    MATH::matrixCSR A(3, 3);
+    A.set_value(0, 2, 5.0);
+    A.set_value(0, 0, 1.0);
+    A.set_value(2, 2, 3.0);
+    A.set_value(1, 0, 4.0);
+
+    // Assert: column indices within each row are sorted
+    const std::vector<int>& rows = A.get_row_indices();
+    const std::vector<int>& cols = A.get_column_indices();
+    for (int i = 0; i < 3; i++) {
+        for (int k = rows[i]+1; k < rows[i+1]; k++) {
+            ASSERT_LT(cols[k-1], cols[k]);
+        }
+    }
+
+    // Assert: diagonal reads zero where no entry is stored
+    MATH::diagonalView D = A.diagonal();
+    ASSERT_EQ(D.size(), 3);
+    ASSERT_DOUBLE_EQ(D[0], 1.0);
+    ASSERT_DOUBLE_EQ(D[1], 0.0);
+    ASSERT_DOUBLE_EQ(D[2], 3.0);
+    ASSERT_DOUBLE_EQ(A.get_value(0, 2), 5.0);
+    ASSERT_DOUBLE_EQ(A.get_value(1, 0), 4.0);
+
+    // Act: inserting and erasing entries keeps the diagonal positions valid
+    A.set_value(1, 1, 2.0);
+    A.set_value(0, 0, 0.0);
+    A.set_value(0, 1, 7.0);
+
+    // Assert
+    ASSERT_DOUBLE_EQ(A.get_diagonal(0), 0.0);
+    ASSERT_DOUBLE_EQ(A.get_diagonal(1), 2.0);
+    ASSERT_DOUBLE_EQ(A.get_diagonal(2), 3.0);
+    ASSERT_DOUBLE_EQ(A.get_value(0, 1), 7.0);
+    ASSERT_EQ(A.get_pattern()->get_diagonal_positions()[0], -1);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test SELL Format * * * * * * * * * * * * * * * * * * //
+TEST(MatrixTest, SELLMatchesCSR) {
+    // Arrange: irregular row lengths, chunk height that does not divide the row count
+    int n = 37;
+    MATH::matrixCOO triplets(n, n);
+    MATH::Vector x(n);
+    for (int i = 0; i < n; i++) {
+        triplets.add_value(i, i, 4.0 + i);
+        for (int k = 1; k <= i%5; k++) {
+            triplets.add_value(i, (i + 3*k) % n, -0.5*k);
+        }
+        x[i] = 1.0 - 0.1*i;
+    }
+    MATH::matrixCSR A = triplets.to_CSR();
+    MATH::Vector reference = A * x;
+
+    for (MATH::simdLevel level : {MATH::simdLevel::scalar, MATH::simdLevel::avx2, MATH::simdLevel::avx512}) {
+        MATH::set_simd_level(level);
+        for (int C : {1, 4, 8}) {
+            // Act
+            MATH::matrixSELL S(A, C, 16);
+            MATH::Vector result = S * x;
+
+            // Assert
+            for (int i = 0; i < n; i++) {
+                ASSERT_NEAR(result[i], reference[i], 1e-12);
+                ASSERT_DOUBLE_EQ(S.get_value(i, i), A.get_value(i, i));
+            }
+        }
+    }
+    MATH::set_simd_level(MATH::get_supported_simd_level());
+
+    // Act: refresh values in place
+    MATH::matrixSELL S(A);
+    MATH::matrixCSR B = A * 2.0;
+    S.update_values(B);
+
+    // Assert
+    ASSERT_DOUBLE_EQ(S.get_value(5, 5), 18.0);
+    ASSERT_EQ(S.get_num_slots() % S.get_chunk_height(), 0);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Autotuned Format * * * * * * * * * * * * * * * * * * //
+TEST(MatrixTest, AutotunedFormat) {
+    // Arrange
+    MATH::matrixCOO triplets(3, 3);
+    triplets.add_value(0, 0, 2.0);
+    triplets.add_value(1, 1, 3.0);
+    triplets.add_value(2, 2, 4.0);
+    triplets.add_value(0, 2, 1.0);
+    MATH::matrixCSR A = triplets.to_CSR();
+    MATH::Vector x(std::vector<double>{1.0, 2.0, 3.0});
+
+    // Act: first product picks a format, copies share the decision
+    MATH::matrixAutotuned T(A);
+    MATH::matrixAutotuned copy = T;
+    MATH::Vector y = copy * x;
+
+    // Assert
+    ASSERT_NE(T.get_format(), MATH::matrixAutotuned::format::undecided);
+    ASSERT_DOUBLE_EQ(y[0], 5.0);
+    ASSERT_DOUBLE_EQ(y[1], 6.0);
+    ASSERT_DOUBLE_EQ(y[2], 12.0);
+
+    // Act: new values on the same pattern keep the decision
+    MATH::matrixAutotuned::format chosen = T.get_format();
+    T.update(A * 2.0);
+
+    // Assert
+    ASSERT_EQ(T.get_format(), chosen);
+    ASSERT_DOUBLE_EQ((T * x)[2], 24.0);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Block CSR * * * * * * * * * * * * * * * * * * //
+TEST(MatrixTest, BSRMatchesCSR) {
+    // Arrange: same 6x6 matrix stored as 3x3 blocks and scalar CSR
+    MATH::matrixBSR<3> block(6, 6);
+    MATH::matrixCSR scalar(6, 6);
+    for (int i = 0; i < 6; i++) {
+        for (int j = 0; j < 6; j++) {
+            if (i/3 == 1 && j/3 == 0) continue;     // block (1,0) not stored
+            double value = 1.0 + i - 0.5*j;
+            block.set_value(i, j, value);
+            scalar.set_value(i, j, value);
+        }
+    }
+    MATH::Vector x(std::vector<double>{1.0, -2.0, 0.5, 3.0, 0.0, 1.5});
+
+    // Act
+    MATH::Vector result = block * x;
+    MATH::Vector reference = scalar * x;
+
+    // Assert
+    ASSERT_EQ(block.get_pattern()->get_nnz(), 3);
+    ASSERT_EQ(block.get_block(1, 0), nullptr);
+    ASSERT_DOUBLE_EQ(block.get_value(4, 2), 0.0);
+    ASSERT_DOUBLE_EQ(block.get_value(2, 5), scalar.get_value(2, 5));
+    ASSERT_DOUBLE_EQ(block.get_diagonal_block(1)[0], scalar.get_value(3, 3));
+    for (int i = 0; i < 6; i++) {
+        ASSERT_NEAR(result[i], reference[i], 1e-12);
+    }
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Multicoloring * * * * * * * * * * * * * * * * * * //
+TEST(MatrixTest, Multicoloring) {
+    // Arrange: 5-point stencil with a one-sided extra coupling (non-symmetric pattern)
+    int m = 12;
+    int n = m*m;
+    MATH::matrixCOO triplets = laplacian5(m);
+    triplets.add_value(n-1, 0, -1.0);
+    MATH::matrixCSR A = triplets.to_CSR();
+
+    // Act
+    const std::vector<int>& offsets = A.get_pattern()->get_color_offsets();
+    const std::vector<int>& rows = A.get_pattern()->get_color_rows();
+
+    // Assert: every row colored once, no coupling inside a color
+    std::vector<int> color(n, -1);
+    for (std::size_t c = 0; c + 1 < offsets.size(); c++) {
+        for (int r = offsets[c]; r < offsets[c+1]; r++) {
+            ASSERT_EQ(color[rows[r]], -1);
+            color[rows[r]] = c;
+        }
+    }
+    ASSERT_EQ(offsets.back(), n);
+    ASSERT_LE(offsets.size() - 1, 3);
+    for (int i = 0; i < n; i++) {
+        for (int index = A.get_row_indices()[i]; index < A.get_row_indices()[i+1]; index++) {
+            int j = A.get_column_indices()[index];
+            if (j != i) {
+                ASSERT_NE(color[i], color[j]);
+            }
+        }
+    }
+}
+
+
+TEST(MatrixTest, MatrixMarketRoundTrip) {
+    // Arrange: entries that need all 17 digits
+    MATH::matrixCOO triplets(3, 4);
+    triplets.add_value(0, 0, 1.0/3.0);
+    triplets.add_value(0, 3, -2.5e-12);
+    triplets.add_value(2, 1, 7.0);
+    triplets.add_value(1, 1, 0.0);
+    MATH::matrixCSR A = triplets.to_CSR();
+    MATH::Vector v(std::vector<double>{0.1, -1.0/7.0, 3.0e200});
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+
+    // Act
+    MATH::write_matrix_market(dir / "luna_test_A.mtx", A);
+    MATH::write_matrix_market(dir / "luna_test_v.mtx", v);
+    MATH::matrixCSR B = MATH::read_matrix_market_matrix(dir / "luna_test_A.mtx");
+    MATH::Vector w = MATH::read_matrix_market_vector(dir / "luna_test_v.mtx");
+
+    // Assert: same structure (explicit zeros kept) and bitwise equal values
+    EXPECT_EQ(B.get_num_rows(), 3);
+    EXPECT_EQ(B.get_num_columns(), 4);
+    EXPECT_EQ(B.get_row_indices(), A.get_row_indices());
+    EXPECT_EQ(B.get_column_indices(), A.get_column_indices());
+    EXPECT_EQ(B.get_values(), A.get_values());
+    EXPECT_TRUE(w == v);
+
+    // Symmetric files store one triangle
+    {
+        std::ofstream out(dir / "luna_test_S.mtx");
+        out << "%%MatrixMarket matrix coordinate real symmetric\n% comment\n2 2 2\n1 1 4.0\n2 1 -1.0\n";
+    }
+    MATH::matrixCSR S = MATH::read_matrix_market_matrix(dir / "luna_test_S.mtx");
+    EXPECT_DOUBLE_EQ(S.get_value(0, 1), -1.0);
+    EXPECT_DOUBLE_EQ(S.get_value(1, 0), -1.0);
+    EXPECT_DOUBLE_EQ(S.get_value(0, 0), 4.0);
+
+    EXPECT_THROW(MATH::read_matrix_market_matrix(dir / "luna_test_missing.mtx"), std::runtime_error);
+    EXPECT_THROW(MATH::read_matrix_market_matrix(dir / "luna_test_v.mtx"), std::runtime_error);
+
+    for (const char* name : {"luna_test_A.mtx", "luna_test_v.mtx", "luna_test_S.mtx"}) {
+        std::filesystem::remove(dir / name);
+    }
+}
@@ -0,0 +1,250 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      testThreadPool.cc
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     Unit tests for the parallel kernel backend
+**
+\*------------------------------------------------------------------------*/
+
+
+#include <gtest/gtest.h>
+
+#include "threadPool.hh"
+#include "sparseMatrix.hh"
+#include "Vector.hh"
+#include "cpuFeatures.hh"
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+
+// * * * * * * * * * * * * * * * * * * Test Partition by Nonzeros * * * * * * * * * * * * * * * * * * //
+TEST(ThreadPoolTest, PartitionByNnz) {
+    // Arrange: first row is dense, remaining rows hold one entry
+    int num_rows = 3*MATH::parallelGrainSize;
+    std::vector<int> row_indices(num_rows + 1, 0);
+    row_indices[1] = 2*MATH::parallelGrainSize;
+    for (int i = 1; i < num_rows; i++) {
+        row_indices[i+1] = row_indices[i] + 1;
+    }
+
+    // Act
+    std::vector<int> bounds = MATH::partition_by_nnz(row_indices, 4);
+
+    // Assert: bounds cover all rows, the dense row forms its own chunks
+    ASSERT_EQ(bounds.front(), 0);
+    ASSERT_EQ(bounds.back(), num_rows);
+    for (int p = 1; p < bounds.size(); p++) {
+        ASSERT_LE(bounds[p-1], bounds[p]);
+    }
+    ASSERT_EQ(bounds[1], 1);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Parallel Kernels * * * * * * * * * * * * * * * * * * //
+TEST(ThreadPoolTest, KernelsMatchSerial) {
+    // Arrange: tridiagonal matrix large enough to be split over threads
+    int n = 8*MATH::parallelGrainSize;
+    MATH::matrixCOO triplets(n, n);
+    MATH::Vector x(n);
+    for (int i = 0; i < n; i++) {
+        triplets.add_value(i, i, 2.0 + i%7);
+        if (i > 0) triplets.add_value(i, i-1, -1.0);
+        if (i < n-1) triplets.add_value(i, i+1, -0.5);
+        x[i] = 1.0 + (i%13)*0.25;
+    }
+    MATH::matrixCSR A = triplets.to_CSR();
+
+    // Act
+    MATH::set_num_threads(1);
+    MATH::Vector y_serial = A * x;
+    double dot_serial = x * y_serial;
+    MATH::Vector z_serial = y_serial;
+    z_serial.axpy(0.5, x);
+
+    MATH::set_num_threads(4);
+    MATH::Vector y_parallel = A * x;
+    double dot_parallel = x * y_parallel;
+    MATH::Vector z_parallel = y_parallel;
+    z_parallel.axpy(0.5, x);
+
+    // Assert
+    ASSERT_EQ(MATH::get_num_threads(), 4);
+    ASSERT_TRUE(y_serial == y_parallel);
+    ASSERT_TRUE(z_serial == z_parallel);
+    ASSERT_NEAR(dot_serial, dot_parallel, 1e-9*std::abs(dot_serial));
+    ASSERT_NEAR(y_serial.getL2Norm(), y_parallel.getL2Norm(), 1e-9*y_serial.getL2Norm());
+
+    MATH::set_num_threads(1);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Fused Vector Updates * * * * * * * * * * * * * * * * * * //
+TEST(ThreadPoolTest, FusedVectorUpdates) {
+    // Arrange
+    int n = 3*MATH::parallelGrainSize + 17;
+    MATH::Vector x(n), y(n);
+    for (int i = 0; i < n; i++) {
+        x[i] = 0.25*(i%11) - 1.0;
+        y[i] = 1.0 + (i%5)*0.125;
+    }
+    double a = 0.7;
+    double b = 0.3;
+    MATH::set_num_threads(4);
+
+    // Act
+    MATH::Vector expression = x*a + y*b;
+    MATH::Vector difference = x - y*b;
+    MATH::Vector fused = y;
+    fused.axpby(a, x, b);
+    MATH::Vector scaled = x;
+    scaled.scale(a);
+    MATH::Vector compound = x;
+    compound += y;
+    compound -= x;
+    compound /= 2.0;
+
+    // Assert: in-place and temporary-reusing forms give the same values as the plain expressions
+    MATH::Vector y_b = y*b;
+    for (int i = 0; i < n; i++) {
+        ASSERT_EQ(expression[i], a*x[i] + b*y[i]);
+        ASSERT_EQ(difference[i], x[i] - y_b[i]);
+        ASSERT_NEAR(fused[i], expression[i], 1e-15);  // axpby may use an FMA
+        ASSERT_EQ(scaled[i], a*x[i]);
+        ASSERT_EQ(compound[i], ((x[i] + y[i]) - x[i]) / 2.0);
+    }
+
+    MATH::set_num_threads(1);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test SIMD Vector Kernels * * * * * * * * * * * * * * * * * * //
+TEST(ThreadPoolTest, SimdVectorKernels) {
+    // Arrange: odd length so every kernel also runs its remainder path
+    int n = 2*MATH::parallelGrainSize + 13;
+    MATH::Vector x(n), y(n);
+    for (int i = 0; i < n; i++) {
+        x[i] = std::sin(0.01*i);
+        y[i] = 1.0/(1.0 + i%7);
+    }
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(&x[0]) % MATH::vectorAlignment, 0u);
+    MATH::set_num_threads(2);
+
+    MATH::set_simd_level(MATH::simdLevel::scalar);
+    double dot_ref = x*y;
+    double norm_ref = x.getL2Norm();
+    MATH::Vector sum_ref = x + y;
+    MATH::Vector axpby_ref = y;
+    axpby_ref.axpby(0.3, x, -1.7);
+
+    for (MATH::simdLevel level : {MATH::simdLevel::avx2, MATH::simdLevel::avx512}) {
+        // Act
+        MATH::set_simd_level(level);
+        MATH::Vector sum = x + y;
+        MATH::Vector axpby = y;
+        axpby.axpby(0.3, x, -1.7);
+        MATH::Vector scaled = x;
+        scaled.scale(-2.5);
+        MATH::Vector difference = x - y;
+        difference.axpy(1.0, y);
+
+        // Assert: add/subtract/scale are exact, FMA and lane-wise summation only change the last bits
+        EXPECT_NEAR(x*y, dot_ref, 1e-12*std::abs(dot_ref));
+        EXPECT_NEAR(x.getL2Norm(), norm_ref, 1e-12*norm_ref);
+        for (int i = 0; i < n; i++) {
+            ASSERT_EQ(sum[i], sum_ref[i]);
+            ASSERT_EQ(scaled[i], -2.5*x[i]);
+            ASSERT_NEAR(axpby[i], axpby_ref[i], 1e-15);
+            ASSERT_NEAR(difference[i], x[i], 1e-15);
+        }
+    }
+
+    MATH::set_simd_level(MATH::get_supported_simd_level());
+    MATH::set_num_threads(1);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Deterministic Reductions * * * * * * * * * * * * * * * * * * //
+TEST(ThreadPoolTest, DeterministicReductions) {
+    // Arrange: vectors spanning many reduction blocks, with a short last block
+    int n = 37*MATH::reductionBlockSize + 123;
+    MATH::Vector x(n), y(n);
+    for (int i = 0; i < n; i++) {
+        x[i] = std::sin(0.01*i) * std::pow(10.0, i%9 - 4);
+        y[i] = 1.0/(1.0 + i%7);
+    }
+    std::vector<int> blocks = MATH::partition_blocks(n);
+    ASSERT_EQ(blocks.size(), 39u);
+    ASSERT_EQ(blocks[1], MATH::reductionBlockSize);
+    ASSERT_EQ(blocks.back(), n);
+
+    for (MATH::summationMode mode : {MATH::summationMode::blocked, MATH::summationMode::compensated}) {
+        MATH::set_summation_mode(mode);
+        MATH::set_num_threads(1);
+        double dot_serial = x*y;
+        double norm_serial = x.getL2Norm();
+
+        for (int threads : {2, 3, 4, 7}) {
+            // Act
+            MATH::set_num_threads(threads);
+
+            // Assert: bitwise identical for any thread count
+            ASSERT_EQ(x*y, dot_serial);
+            ASSERT_EQ(x.getL2Norm(), norm_serial);
+        }
+    }
+
+    // Arrange: large terms that cancel, every block holds ones that plain summation rounds away
+    MATH::Vector z(n);
+    MATH::Vector ones(n, 1.0);
+    int count = 0;
+    for (int i = 0; i + 2 < n; i += 3) {
+        z[i] = 1.0e16;
+        z[i+1] = 1.0;
+        z[i+2] = -1.0e16;
+        count++;
+    }
+
+    // Act
+    MATH::set_summation_mode(MATH::summationMode::compensated);
+    double compensated = z*ones;
+    MATH::set_num_threads(1);
+
+    // Assert
+    ASSERT_EQ(compensated, count);
+    ASSERT_EQ(z*ones, compensated);
+
+    MATH::set_summation_mode(MATH::summationMode::blocked);
+}
+
+
+// * * * * * * * * * * * * * * * * * * Test Concurrent Callers * * * * * * * * * * * * * * * * * * //
+TEST(ThreadPoolTest, ConcurrentCallers) {
+    // Arrange: one pool shared by two external threads, each with its own task counters
+    MATH::threadPool pool(4);
+    int num_tasks = 64;
+    int runs = 200;
+    std::vector<std::atomic<int>> first(num_tasks);
+    std::vector<std::atomic<int>> second(num_tasks);
+
+    // Act
+    auto caller = [&](std::vector<std::atomic<int>>& counters) {
+        for (int r = 0; r < runs; r++) {
+            pool.run(num_tasks, [&](int t) { counters[t]++; });
+        }
+    };
+    std::thread a(caller, std::ref(first));
+    std::thread b(caller, std::ref(second));
+    a.join();
+    b.join();
+
+    // Assert: every task of every run executed exactly once, for its own caller
+    for (int t = 0; t < num_tasks; t++) {
+        ASSERT_EQ(first[t].load(), runs);
+        ASSERT_EQ(second[t].load(), runs);
+    }
+}
@@ -0,0 +1,43 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      testVec.cc
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     Unit tests for the fixed-size Vec class
+**
+\*------------------------------------------------------------------------*/
+
+
+#include <gtest/gtest.h>
+
+#include "Vec.hh"
+
+#include <vector>
+#include <type_traits>
+
+TEST(VecTest, OperatorsMatchVector) {
+    MATH::Vec<3> a(std::vector<double>{1.0, 2.0});
+    MATH::Vec<3> b(std::vector<double>{3.0, -1.0});
+
+    // Runtime size follows the mesh dimension, storage does not
+    ASSERT_EQ(a.size(), 2u);
+    ASSERT_EQ(MATH::Vec<3>(3).size(), 3u);
+    static_assert(sizeof(MATH::Vec<3>) <= 4*sizeof(double), "Vec must be stored inline");
+    static_assert(std::is_trivially_copyable_v<MATH::Vec<3>>, "Vec must be trivially copyable");
+
+    MATH::Vec<3> c = 2.0 * a + b - a / 2.0;
+    EXPECT_DOUBLE_EQ(c[0], 4.5);
+    EXPECT_DOUBLE_EQ(c[1], 2.0);
+    EXPECT_EQ(c.size(), 2u);
+    EXPECT_DOUBLE_EQ(a * b, 1.0);
+    EXPECT_DOUBLE_EQ(MATH::Vec<3>(std::vector<double>{3.0, 4.0}).getL2Norm(), 5.0);
+
+    c.axpy(-1.0, a).scale(2.0);
+    EXPECT_TRUE(c == MATH::Vec<3>(std::vector<double>{7.0, 0.0}));
+
+    MATH::Vec<2> d(2, 1.0);
+    d += d;
+    d *= 0.5;
+    EXPECT_EQ(d.get_vector(), std::vector<double>({1.0, 1.0}));
+}
@@ -12,7 +12,7 @@
 #include <gtest/gtest.h>
 
 #include "topology.hh"
-#include "Vector.hh"
+#include "Vec.hh"
 
 #include <vector>
 
@@ -26,48 +26,48 @@ public:
     topologyTest() {};
 protected:
     // Define some points
-    MATH::Vector p0 = MATH::Vector(std::vector<double>{0.0, 0.0});
-    MATH::Vector p1 = MATH::Vector(std::vector<double>{0.0, 4.0});
-    MATH::Vector p2 = MATH::Vector(std::vector<double>{4.0, 0.0});
-    MATH::Vector p3 = MATH::Vector(std::vector<double>{4.0, 4.0});
-    MATH::Vector p4 = MATH::Vector(std::vector<double>{1.0, 2.0});
-    MATH::Vector p5 = MATH::Vector(std::vector<double>{3.0, 2.0});
-    MATH::Vector p6 = MATH::Vector(std::vector<double>{2.0, 1.0});
-    MATH::Vector p7 = MATH::Vector(std::vector<double>{2.0, 3.0});
+    MATH::Vec<3> p0 = MATH::Vec<3>(std::vector<double>{0.0, 0.0});
+    MATH::Vec<3> p1 = MATH::Vec<3>(std::vector<double>{0.0, 4.0});
+    MATH::Vec<3> p2 = MATH::Vec<3>(std::vector<double>{4.0, 0.0});
+    MATH::Vec<3> p3 = MATH::Vec<3>(std::vector<double>{4.0, 4.0});
+    MATH::Vec<3> p4 = MATH::Vec<3>(std::vector<double>{1.0, 2.0});
+    MATH::Vec<3> p5 = MATH::Vec<3>(std::vector<double>{3.0, 2.0});
+    MATH::Vec<3> p6 = MATH::Vec<3>(std::vector<double>{2.0, 1.0});
+    MATH::Vec<3> p7 = MATH::Vec<3>(std::vector<double>{2.0, 3.0});
 
     // First Test: only hull points in order
-    std::vector<MATH::Vector> test1 = {p0, p1, p2, p3};
+    std::vector<MATH::Vec<3>> test1 = {p0, p1, p2, p3};
     std::vector<int> result1 = {0, 2, 3, 1};
 
     // Second Test: only hull points out of order
-    std::vector<MATH::Vector> test2 = {p0, p3, p1, p2};
+    std::vector<MATH::Vec<3>> test2 = {p0, p3, p1, p2};
     std::vector<int> result2 = {0, 3, 1, 2};
 
     // Third Test: All points in order
-    std::vector<MATH::Vector> test3 = {p0, p1, p2, p3, p4, p5, p6, p7};
+    std::vector<MATH::Vec<3>> test3 = {p0, p1, p2, p3, p4, p5, p6, p7};
     std::vector<int> result3 = {0, 2, 3, 1};
 
     // Fourth Test: All points out of order
-    std::vector<MATH::Vector> test4 = {p3, p7, p5, p0, p6, p4, p2, p1};
+    std::vector<MATH::Vec<3>> test4 = {p3, p7, p5, p0, p6, p4, p2, p1};
     std::vector<int> result4 = {3, 6, 0, 7};
 
     // Fifth Test: different square
-    MATH::Vector n1 = MATH::Vector(std::vector<double>{0.0, 0.0});
-    MATH::Vector n2 = MATH::Vector(std::vector<double>{0.5, 0.0});
-    MATH::Vector n3 = MATH::Vector(std::vector<double>{0.0, 0.5});
-    MATH::Vector n4 = MATH::Vector(std::vector<double>{0.5, 0.5});
+    MATH::Vec<3> n1 = MATH::Vec<3>(std::vector<double>{0.0, 0.0});
+    MATH::Vec<3> n2 = MATH::Vec<3>(std::vector<double>{0.5, 0.0});
+    MATH::Vec<3> n3 = MATH::Vec<3>(std::vector<double>{0.0, 0.5});
+    MATH::Vec<3> n4 = MATH::Vec<3>(std::vector<double>{0.5, 0.5});
 
-    std::vector<MATH::Vector> test5 = {n1, n2, n3, n4};
+    std::vector<MATH::Vec<3>> test5 = {n1, n2, n3, n4};
     std::vector<int> result5 = {0, 1, 3, 2};
 
     // Sixth test: scattered points
-    MATH::Vector m1 = MATH::Vector(std::vector<double>{-0.5, -4.0 });
-    MATH::Vector m2 = MATH::Vector(std::vector<double>{-0.735145, -3.96353});
-    MATH::Vector m3 = MATH::Vector(std::vector<double>{-0.673918, -3.65004});
-    MATH::Vector m4 = MATH::Vector(std::vector<double>{-0.456313, -3.67706 });
-    MATH::Vector m5 = MATH::Vector(std::vector<double>{-0.51, -3.9});
+    MATH::Vec<3> m1 = MATH::Vec<3>(std::vector<double>{-0.5, -4.0 });
+    MATH::Vec<3> m2 = MATH::Vec<3>(std::vector<double>{-0.735145, -3.96353});
+    MATH::Vec<3> m3 = MATH::Vec<3>(std::vector<double>{-0.673918, -3.65004});
+    MATH::Vec<3> m4 = MATH::Vec<3>(std::vector<double>{-0.456313, -3.67706 });
+    MATH::Vec<3> m5 = MATH::Vec<3>(std::vector<double>{-0.51, -3.9});
 
-    std::vector<MATH::Vector> test6 = {m1, m2, m3, m4, m5};
+    std::vector<MATH::Vec<3>> test6 = {m1, m2, m3, m4, m5};
     std::vector<int> result6 = {1, 0, 3, 2};
 
 };
@@ -157,3 +157,49 @@ TEST_F(topologyTest, testScatteredPoints) {
     }
 }
 
+
+// * * * * * * * * * * * * * * * * * * Polygon order matches Jarvis march * * * * * * * * * * * * * * * * * * //
+TEST_F(topologyTest, testPolygonOrder) {
+    // Arrange
+    std::vector<std::vector<MATH::Vec<3>>> polygons = {test1, test2, test5, {m1, m2, m3, m4}};
+
+    for (const std::vector<MATH::Vec<3>>& polygon : polygons) {
+        std::vector<double> coords;
+        for (const MATH::Vec<3>& p : polygon) {
+            coords.push_back(p[0]);
+            coords.push_back(p[1]);
+        }
+
+        // Act
+        std::vector<int> order(polygon.size());
+        MATH::polygon_order(coords.data(), polygon.size(), order.data());
+
+        // Assert
+        EXPECT_EQ(order, MATH::jarvis_march(polygon));
+    }
+}
+
+// * * * * * * * * * * * * * * * * * * Shoelace area and centroid * * * * * * * * * * * * * * * * * * //
+TEST_F(topologyTest, testPolygonAreaCentroid) {
+    // Arrange: pentagon (0,0) (4,0) (5,3) (2,5) (0,3), nodes shuffled
+    std::vector<double> coords = {5.0,3.0, 0.0,3.0, 4.0,0.0, 0.0,0.0, 2.0,5.0};
+    int order[5];
+
+    // Act
+    MATH::polygon_order(coords.data(), 5, order);
+    double centroid[2];
+    double area = MATH::polygon_centroid(coords.data(), order, 5, centroid);
+
+    // Assert: counter-clockwise from the first leftmost node
+    std::vector<int> expected = {1, 3, 2, 0, 4};
+    for (int i = 0; i < 5; i++) EXPECT_EQ(order[i], expected[i]);
+    EXPECT_DOUBLE_EQ(area, 18.5);
+    EXPECT_DOUBLE_EQ(MATH::polygon_area(coords.data(), order, 5), 18.5);
+    EXPECT_DOUBLE_EQ(centroid[0], 253.0/111.0);
+    EXPECT_DOUBLE_EQ(centroid[1], 236.0/111.0);
+
+    // Orientation predicate
+    EXPECT_GT(MATH::orient2d(&coords[6], &coords[4], &coords[0]), 0.0);
+    EXPECT_LT(MATH::orient2d(&coords[6], &coords[0], &coords[4]), 0.0);
+    EXPECT_EQ(MATH::orient2d(&coords[6], &coords[4], &coords[4]), 0.0);
+}
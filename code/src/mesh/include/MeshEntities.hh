@@ -19,7 +19,7 @@
 #include <unordered_map>
 #include <algorithm>
 
-#include "Vector.hh"
+#include "Vec.hh"
 #include "topology.hh"
 
 // Define type enum for element/cell types
@@ -130,7 +130,7 @@ public:
         // Construct with double vector
         node(int, std::vector<double>);
         // Construct with Vector class
-        node(int, MATH::Vector);
+        node(int, MATH::Vec<3>);
 
     
     // Public member data
@@ -143,7 +143,7 @@ public:
 
     // get methods
         int get_id() const { return _id; };
-        MATH::Vector get_coordinates() const { return _coordinates; };
+        const MATH::Vec<3>& get_coordinates() const { return _coordinates; };
         std::vector<std::shared_ptr<element>> get_elements() { return return_shared(&_elements); };
         std::vector<std::shared_ptr<face>> get_faces() { return return_shared(&_faces); };
         std::vector<double> get_distanceWeights() const { return _distanceWeights; };
@@ -154,14 +154,15 @@ public:
         void set_faces(std::vector<std::weak_ptr<face>> faces) { _faces = faces; };
         void add_face(std::weak_ptr<face> face) { _faces.push_back(face); };
         void set_boundary(bool onBoundary) { _onBoundary = onBoundary; };
+        void set_id(int id) { _id = id; };
 
     // Operator Overloading
         // Calculate the difference in position between two nodes
-        MATH::Vector operator-(const node&);
+        MATH::Vec<3> operator-(const node&);
         // Calculate distance between two nodes
         double operator*(const node&) const;
         // Calculate cross product of two nodes
-        MATH::Vector operator/(const node&) const;
+        MATH::Vec<3> operator/(const node&) const;
         // Calculate dot product of two nodes (& consistent with openFOAM)
         double operator&(const node&) const;
     
@@ -171,7 +172,7 @@ private:
         // Node ID
         int _id;
         // Node coordinates
-        MATH::Vector _coordinates;
+        MATH::Vec<3> _coordinates;
         // Elements
         std::vector<std::weak_ptr<element>> _elements{};
         // Faces 
@@ -203,19 +204,19 @@ public:
     // Member Functions
         // initialize mesh entity
         virtual void initialize();
+        // Order the nodes once (counter-clockwise for 2D entities), used by the volume, centroid and sub-elements
+        void orderNodes();
         // Calculate mesh volume
         void calculateVolume();
         // Calculate centroid
         void calculateCentroid();
-        // General method to calculate area of triangle
-        double triArea(std::vector<node>);
-        // Return diagonals of a quad element
-        std::vector<std::vector<node>> returnQuadDiags(std::vector<node>);
         // Hashing function for quick subelement comparisons
         void hash();
+        // Re-read node IDs from the node vector and rehash (after the nodes are renumbered)
+        void updateNodeIDs();
 
     // Set Methods
-        void set_nodes(std::vector<std::weak_ptr<node>> nodes) { _nodes = nodes; };
+        void set_nodes(std::vector<std::weak_ptr<node>> nodes) { _nodes = nodes; _nodeOrder.clear(); };
         void set_id(int id) { _id = id; };
 
     // Get Methods
@@ -224,7 +225,9 @@ public:
         const std::vector<std::shared_ptr<node>> get_nodes() { return return_shared(&_nodes); };
         const double& get_volume() const { return _volume; };
         const std::vector<int>& get_nodeIDs() const { return _nodeIDs; };
-        const MATH::Vector& get_centroid() const { return _centroid; };
+        // Local node indexes in traversal order (counter-clockwise from the leftmost node in 2D)
+        const std::vector<int>& get_nodeOrder() const { return _nodeOrder; };
+        const MATH::Vec<3>& get_centroid() const { return _centroid; };
         const std::string& get_seed() const { return seed; };
 
     // Operator Overloading
@@ -240,9 +243,11 @@ protected:
         // node vector
         std::vector<std::weak_ptr<node>> _nodes;
         // cell centroid
-        MATH::Vector _centroid;
+        MATH::Vec<3> _centroid;
         // vector of node-ids
         std::vector<int> _nodeIDs;
+        // Traversal order of the nodes (indexes into _nodes)
+        std::vector<int> _nodeOrder;
         // Cell "volume"
         double _volume;                 // 1D: width,       2D: area,   3D: volume
         // hash object for element comparisons
@@ -289,7 +294,7 @@ public:
         // Get neighbor element
         const std::shared_ptr<element> get_neighbor() { return return_shared(&_neighbor); };
         // Get face normal
-        const MATH::Vector& get_normal() const { return _normal; };
+        const MATH::Vec<3>& get_normal() const { return _normal; };
         // Get both elements
         std::vector<std::shared_ptr<element>> get_elements();
         // Get element that is not the given element
@@ -306,7 +311,7 @@ private:
         // Neighbor element
         std::weak_ptr<element> _neighbor;
         // Face normal (outward pointwing w.r.t owner)
-        MATH::Vector _normal;
+        MATH::Vec<3> _normal;
         // If face is a boundary face (default to no boundary)
         bool _boundaryFace = false;
         int _boundaryID;
@@ -357,7 +362,7 @@ public:
 
     // get methods ( [const type& get() const {}] returns a const reference, i.e. reference to data to avoid copying data)
         const std::vector<std::shared_ptr<face>> get_faces() { return return_shared(&_faces); };
-        const std::vector<MATH::Vector>& get_normals() const { return _normals; };
+        const std::vector<MATH::Vec<3>>& get_normals() const { return _normals; };
         const std::vector<double>& get_distanceWeights() const { return _distanceWeights; };
 
     // Operator Overloading
@@ -376,7 +381,7 @@ protected:
         // distance weight to sub-elements, indexed by faces
         std::vector<double> _distanceWeights;
         // Outward facing normals
-        std::vector<MATH::Vector> _normals;
+        std::vector<MATH::Vec<3>> _normals;
         
 };
 
@@ -403,6 +408,8 @@ public:
         void map_global2local(int global, int local) { _global2local[global] = local; };
         bool add_face(std::weak_ptr<face> face);
         bool onBoundary(int) const;
+        // Rebuild global face index map and face seeds (after the faces or nodes are renumbered)
+        void updateFaceIDs();
 
     // get methods
         // Get pointers to boundary faces
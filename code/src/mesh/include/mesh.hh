@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "MeshEntities.hh"
+#include "renumbering.hh"
 
 namespace MESH {
 
@@ -39,6 +40,9 @@ public:
         int get_boundaryIdx(int) const;
         // calculate face normal deltas
         void calculateFaceNormalDeltas();
+        // Renumber cells for cache locality, then faces (by their cells) and nodes (by first use)
+        //      NOTE: call before constructing a solver on the mesh, IDs and boundary maps are rewritten
+        void renumber(renumberingEnum ordering);
 
     // get methods
         const int& get_dimension() const { return _dimension; };
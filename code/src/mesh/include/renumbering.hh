@@ -0,0 +1,43 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      renumbering.hh
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     header for cell orderings used to renumber meshes for cache locality
+**
+\*------------------------------------------------------------------------*/
+
+#ifndef _RENUMBERING_HH_
+#define _RENUMBERING_HH_
+
+#include <vector>
+
+#include "Vec.hh"
+
+namespace MESH
+{
+
+// Cell orderings available to mesh::renumber
+enum class renumberingEnum {
+    NONE,       // keep the file order
+    RCM,        // Reverse Cuthill-McKee on the cell adjacency graph (minimizes matrix bandwidth)
+    HILBERT,    // Hilbert space-filling curve through the cell centroids
+    MORTON      // Morton (Z-order) space-filling curve through the cell centroids
+};
+
+/*------------------------------------------------------------------------*\
+**  Ordering functions
+\*------------------------------------------------------------------------*/
+// All orderings return the old index of every new position: order[new] = old
+
+// Reverse Cuthill-McKee ordering of a graph given by its adjacency lists
+//      (every connected component starts from a pseudo-peripheral vertex)
+std::vector<int> reverseCuthillMcKee(const std::vector<std::vector<int>>& adjacency);
+
+// Space-filling curve (HILBERT or MORTON) ordering of points in 2D or 3D
+std::vector<int> spaceFillingCurveOrder(const std::vector<MATH::Vec<3>>& points, int dimension, renumberingEnum curve);
+
+}
+
+#endif // _RENUMBERING_HH_
@@ -18,6 +18,25 @@
 #include "MeshEntities.hh"
 
 
+namespace {
+
+// Largest number of nodes of an element (hexahedron)
+constexpr int maxElementNodes = 8;
+
+// Copy the x,y coordinates of the nodes into a flat array
+void gather_planar_coordinates(const std::vector<std::weak_ptr<MESH::node>>& nodes, double* coords)
+{
+    assert(nodes.size() <= maxElementNodes && "Too many nodes in element");
+    for (int i=0 ; i<nodes.size() ; i++) {
+        const MATH::Vec<3>& x = nodes[i].lock()->get_coordinates();
+        coords[2*i] = x[0];
+        coords[2*i+1] = x[1];
+    }
+}
+
+}
+
+
 /*------------------------------------------------------------------------*\
 **  Class mesh_entity Implementation
 \*------------------------------------------------------------------------*/
@@ -84,75 +103,46 @@ MESH::mesh_entity::mesh_entity(int id, elementTypeEnum elementType, std::vector<
 void MESH::mesh_entity::initialize() {
 
     // Calculate volume and centroid
+    orderNodes();
     calculateVolume();
     calculateCentroid();
 }
 
 
-// * * * * * * * * * * * * * *  returnQuadDiags * * * * * * * * * * * * * * * //
-// return the diaganals of a quadrilateral element
-std::vector<std::vector<MESH::node>> MESH::mesh_entity::returnQuadDiags(std::vector<node> nodes)
+// * * * * * * * * * * * * * *  orderNodes * * * * * * * * * * * * * * * //
+// Node traversal order, computed once when the nodes are set
+void MESH::mesh_entity::orderNodes()
 {
-    assert(nodes.size() == 4 && "Expected 4 nodes in vector to get quadrilateral diagonals");
-    
-    // Put node coordinates in vector
-    std::vector<MATH::Vector> coords;
-    for (int i=0 ; i<nodes.size() ; i++) {
-        coords.push_back(nodes[i].get_coordinates());
-    }
-
-    // Get node order using Jarvis March
-    std::vector<int> order = MATH::jarvis_march(coords);
-
-    std::ostringstream error_msg;
-    error_msg << "Error obtaining convex hull of quadrilateral on element" << _id;
-    assert(order.size() == 4 && error_msg.str().c_str());
-
-    std::vector<std::vector<node>> diags = { {nodes[order[0]],nodes[order[2]]} , {nodes[order[1]],nodes[order[3]]} };
-
-    return diags;
-}
+    _nodeOrder.resize(_nodes.size());
 
-// * * * * * * * * * * * * * *  triArea * * * * * * * * * * * * * * * //
-double MESH::mesh_entity::triArea(std::vector<node> nodes)
-{
-    double s, a, b, c;
-    a = nodes[0]*nodes[1];
-    b = nodes[1]*nodes[2];
-    c = nodes[2]*nodes[0];
-    s = 0.5*(a+b+c);
-    // Heron's formula
-    return std::sqrt(s*(s-a)*(s-b)*(s-c));
+    // 2D elements: counter-clockwise order from orientation predicates
+    if ( type2dimension[_elementType] == 2 ) {
+        double coords[2*maxElementNodes];
+        gather_planar_coordinates(_nodes, coords);
+        MATH::polygon_order(coords, _nodes.size(), _nodeOrder.data());
+    }
+    // Lines keep their node order (3D elements are not yet supported)
+    else {
+        for (int i=0 ; i<_nodes.size() ; i++) _nodeOrder[i] = i;
+    }
 }
 
-// * * * * * * * * * * * * * *  2D Area * * * * * * * * * * * * * * * //
-
 // * * * * * * * * * * * * * *  calculateVolume * * * * * * * * * * * * * * * //
 void MESH::mesh_entity::calculateVolume() 
 {
-    std::vector<std::shared_ptr<node>> nodes = return_shared(&_nodes);
-
     // LINE Volume = Length
     if ( type2dimension[_elementType] == 1 ) {
         // Overloaded * operator on two pointers
-        _volume = *nodes[0]* *nodes[1];
+        _volume = *_nodes[0].lock() * *_nodes[1].lock();
     }
 
-    // Generalized approach for 2D elements
+    // Generalized approach for 2D elements: shoelace formula over the ordered nodes
     else if ( type2dimension[_elementType] == 2 ) {
-        // Use Jarvis March to get convex hull
-        std::vector<MATH::Vector> coords;
-        for (int i=0 ; i<_nodes.size() ; i++) {
-            coords.push_back(nodes[i]->get_coordinates());
-        }
-        std::vector<int> order = MATH::jarvis_march(coords);
-
-        // Use element order to calculate area
-        _volume = 0.0;
-        for (int i=0 ; i<order.size()-2 ; i++) {
-            _volume += triArea( {*nodes[order[0]],*nodes[order[i+1]],*nodes[order[i+2]]} );
-        }
+        if (_nodeOrder.size() != _nodes.size()) orderNodes();
 
+        double coords[2*maxElementNodes];
+        gather_planar_coordinates(_nodes, coords);
+        _volume = std::abs(MATH::polygon_area(coords, _nodeOrder.data(), _nodes.size()));
     }
 
     else if ( type2dimension[_elementType] == 3 ) {
@@ -164,14 +154,30 @@ void MESH::mesh_entity::calculateVolume()
 // * * * * * * * * * * * * * * Calculate Cell Centroid * * * * * * * * * * * * * * * //
 void MESH::mesh_entity::calculateCentroid() 
 {
-    // Lock nodes
-    std::vector<std::shared_ptr<node>> nodes = return_shared(&_nodes);
+    unsigned dimension = _nodes[0].lock()->get_coordinates().size();
+
+    // 2D elements: area centroid (equal to the node average for triangles and parallelograms)
+    if ( type2dimension[_elementType] == 2 ) {
+        if (_nodeOrder.size() != _nodes.size()) orderNodes();
+
+        double coords[2*maxElementNodes];
+        double center[2];
+        gather_planar_coordinates(_nodes, coords);
+        MATH::polygon_centroid(coords, _nodeOrder.data(), _nodes.size(), center);
+
+        // The plane keeps the z of its nodes
+        _centroid = MATH::Vec<3>(dimension, 0.0);
+        _centroid[0] = center[0];
+        _centroid[1] = center[1];
+        if (dimension == 3) _centroid[2] = _nodes[0].lock()->get_coordinates()[2];
+        return;
+    }
 
-    MATH::Vector center(nodes[0]->get_coordinates().size(),0.0);
+    MATH::Vec<3> center(dimension,0.0);
     double c = _nodes.size();
     // Just add all the nodes index wise and divide by number of nodes
     for (int i=0 ; i<_nodes.size() ; i++) {
-        center = center + nodes[i]->get_coordinates();
+        center += _nodes[i].lock()->get_coordinates();
     }
     center = center * (1.0/c);
 
@@ -194,6 +200,18 @@ void MESH::mesh_entity::hash()
     seed = oss.str();
 }
 
+// * * * * * * * * * * * * * * Update Node IDs * * * * * * * * * * * * * * * //
+void MESH::mesh_entity::updateNodeIDs()
+{
+    std::vector<std::shared_ptr<node>> nodes = return_shared(&_nodes);
+    assert(nodes.size() == _nodeIDs.size() && "Node vector must be defined to update node IDs");
+
+    for (int i=0 ; i<nodes.size() ; i++) {
+        _nodeIDs[i] = nodes[i]->get_id();
+    }
+    hash();
+}
+
 // * * * * * * * * * * * * * * * * Overload == Operator to Check Hash Values * * * * * * * * * * * * * * * //
 int MESH::mesh_entity::operator==(const MESH::mesh_entity& subElement) const {
 
@@ -227,7 +245,8 @@ MESH::face::face(int id, elementTypeEnum elementType, std::vector<std::weak_ptr<
     mesh_entity(id, elementType, nodes),
     _boundaryFace(boundaryFace)
 {
-    initialize();
+    // Geometry is computed by the base constructor, only the hash is left
+    hash();
 }
 
 // ONLY NODE IDs ARE PROVIDED, NEEDS TO BE INITILIAZED LATER
@@ -245,6 +264,7 @@ MESH::face::face(int id, elementTypeEnum elementType, std::vector<int> nodeIDs,
 void MESH::face::initialize() {
 
     // Calculate volume and centroid
+    orderNodes();
     calculateVolume();
     calculateCentroid();
 
@@ -272,7 +292,7 @@ void MESH::face::set_owner(std::weak_ptr<element> owner)
 { 
     // Make sure face exists in element
     std::shared_ptr<element> e = owner.lock();
-    assert( *e == *this && "ERROR: Face does not exist in element");
+    assert( (*e == *this) >= 0 && "ERROR: Face does not exist in element");
     _owner = owner; 
 
     // Calculate normal
@@ -284,7 +304,7 @@ void MESH::face::set_neighbor(std::weak_ptr<element> neighbor)
 { 
     // Make sure face exists in element
     std::shared_ptr<element> e = neighbor.lock();
-    assert( *e == *this && "ERROR: Face does not exist in element");
+    assert( (*e == *this) >= 0 && "ERROR: Face does not exist in element");
     _neighbor = neighbor; 
 }
 
@@ -361,6 +381,9 @@ void MESH::element::initializeInterior() {
     // Make sure faces are initialized
     assert(_nodes.size() != 0 && "element::initialize: nodes not initialized! Nodes must be set before element initialization!");
 
+    // Order nodes once, for the centroid, volume and faces (the node constructor already did)
+    if (_nodeOrder.size() != _nodes.size()) orderNodes();
+
     // Calculate cell centroid 
     calculateCentroid();
 
@@ -403,7 +426,6 @@ bool MESH::element::add_face(std::weak_ptr<face> face)
 std::vector<MESH::face> MESH::element::determineSubElements()
 {
     std::vector<MESH::face> faces;
-    std::vector<std::shared_ptr<node>> nodes = return_shared(&_nodes);
 
     // Smart pointer to this enabled by std::make_shared_from_this
     std::shared_ptr<element> selfPtr;
@@ -422,14 +444,12 @@ std::vector<MESH::face> MESH::element::determineSubElements()
     // 2D ELEMENT IMPLEMENTATION
     else if ( type2dimension[_elementType] == 2 ) {
 
-        // First, get order of nodes from Jarvis March
-        std::vector<MATH::Vector> coords;
-        for (int i=0 ; i<_nodes.size() ; i++) {
-            coords.push_back(nodes[i]->get_coordinates());
-        }
-        std::vector<int> order = MATH::jarvis_march(coords);
+        // Node order is known from initialization
+        if (_nodeOrder.size() != _nodes.size()) orderNodes();
+        const std::vector<int>& order = _nodeOrder;
 
-        // Now that we have our order, define our sub_elements
+        // Define our sub_elements from consecutive nodes
+        faces.reserve(_nodes.size());
         for (int e=0; e<_nodes.size() ; e++) {
             // get list of nodes that make up element
             std::vector<std::weak_ptr<node>> nodes{ _nodes[order[e]] , _nodes[order[(e+1) % _nodes.size()]]}; 
@@ -515,8 +535,8 @@ void MESH::element::calculateFaceDistanceWeights()
         {
             std::shared_ptr<element> nb = get_neighbor(i);
 
-            MATH::Vector v1 = MATH::Vector(_centroid - faces[i]->get_centroid());
-            MATH::Vector v2 = MATH::Vector(nb->get_centroid() - faces[i]->get_centroid());
+            MATH::Vec<3> v1 = MATH::Vec<3>(_centroid - faces[i]->get_centroid());
+            MATH::Vec<3> v2 = MATH::Vec<3>(nb->get_centroid() - faces[i]->get_centroid());
             double d1 = v1.getL2Norm();
             double d2 = v2.getL2Norm();
             
@@ -540,19 +560,23 @@ std::shared_ptr<MESH::element> MESH::element::get_neighbor(unsigned int faceIdx)
 // * * * * * * * * * * * * * * Check face exists in element * * * * * * * * * * * * * * * //
 int MESH::element::operator==(const MESH::face& nface)
 {
-    std::vector<std::shared_ptr<face>> faces;
-    // Ensure faces vector isn't empty
+    // Faces not assigned yet: compare with the edges of the ordered nodes, built without an owner
+    //      (determineSubElements sets this element as their owner, which checks this operator again)
     if (_faces.size() == 0)
     {
-        std::vector<face> temp = determineSubElements();
-        faces = return_shared(&temp);
-    }
-    else
-    {
-        faces = return_shared(&_faces);
+        if ( type2dimension[_elementType] != 2 ) return -1;
+        if (_nodeOrder.size() != _nodes.size()) orderNodes();
+
+        for (int e=0 ; e<_nodes.size() ; e++) {
+            std::vector<std::weak_ptr<node>> nodes{ _nodes[_nodeOrder[e]] , _nodes[_nodeOrder[(e+1) % _nodes.size()]]};
+            face edge(-1, elementTypeEnum::LINE, nodes);
+            if (edge.get_seed() == nface.get_seed()) return e;
+        }
+        return -1;
     }
-    
-    for (int i=0 ; i<this->_faces.size() ; i++) {
+
+    std::vector<std::shared_ptr<face>> faces = return_shared(&_faces);
+    for (int i=0 ; i<faces.size() ; i++) {
         if (faces[i]->get_seed() == nface.get_seed()) return i;
     }
     return -1;
@@ -562,22 +586,7 @@ int MESH::element::operator==(const MESH::face& nface)
 // * * * * * * * * * * * * * * Check face exists in element * * * * * * * * * * * * * * * //
 int MESH::element::operator==(const std::shared_ptr<MESH::face>& nface)
 {
-    std::vector<std::shared_ptr<face>> faces;
-    // Ensure faces vector isn't empty
-    if (_faces.size() == 0)
-    {
-        std::vector<face> temp = determineSubElements();
-        faces = return_shared(&temp);
-    }
-    else
-    {
-        faces = return_shared(&_faces);
-    }
-    
-    for (int i=0 ; i<this->_faces.size() ; i++) {
-        if (faces[i]->get_seed() == nface->get_seed()) return i;
-    }
-    return -1;
+    return *this == *nface;
 }
 
 
@@ -608,7 +617,7 @@ MESH::node::node(int id, std::vector<double> coordinates)
     _coordinates(coordinates)
 {}
 
-MESH::node::node(int id, MATH::Vector coordinates) 
+MESH::node::node(int id, MATH::Vec<3> coordinates) 
 : 
     _id(id), 
     _coordinates(coordinates)
@@ -625,7 +634,7 @@ void MESH::node::calculateElementDistanceWeights()
 
     std::vector<double> distances;
     double total = 0.0;
-    MATH::Vector dist;
+    MATH::Vec<3> dist;
 
     for (int i=0 ; i<_elements.size() ; i++) {
         dist = (elements)[i]->get_centroid() - _coordinates;
@@ -641,8 +650,8 @@ void MESH::node::calculateElementDistanceWeights()
 
 // * * * * * * * * * * * * * *  operator- * * * * * * * * * * * * * * * //
 // Overloaded - operator: return the vector distance between two nodes
-MATH::Vector MESH::node::operator-(const node& obj) {
-    MATH::Vector diff = _coordinates - obj._coordinates;
+MATH::Vec<3> MESH::node::operator-(const node& obj) {
+    MATH::Vec<3> diff = _coordinates - obj._coordinates;
     return diff;
 }
 
@@ -658,15 +667,20 @@ double MESH::node::operator*(const node &obj) const {
 
 // * * * * * * * * * * * * * *  operator/ * * * * * * * * * * * * * * * //
 // Overloaded / operator: return the cross product of two nodes
-MATH::Vector MESH::node::operator/(const node &obj) const {
+MATH::Vec<3> MESH::node::operator/(const node &obj) const {
     assert(     (_coordinates.size() == 3 || _coordinates.size() == 2)
-            && (obj._coordinates.size() == 3 || _coordinates.size() == 2) 
+            && (obj._coordinates.size() == 3 || obj._coordinates.size() == 2) 
             && "Coordinates must be dimension 2 or 3 to take cross product");
 
-    MATH::Vector cross(_coordinates.size());
-    cross[0] = _coordinates[1] * obj._coordinates[2] - _coordinates[2] * obj._coordinates[1];
-    cross[1] = _coordinates[2] * obj._coordinates[0] - _coordinates[0] * obj._coordinates[2];
+    // The cross product is always 3D, missing z components of 2D nodes are 0
+    MATH::Vec<3> cross(3);
     cross[2] = _coordinates[0] * obj._coordinates[1] - _coordinates[1] * obj._coordinates[0];
+    if (_coordinates.size() == 2 && obj._coordinates.size() == 2) return cross;
+
+    double z1 = _coordinates.size() == 3 ? _coordinates[2] : 0.0;
+    double z2 = obj._coordinates.size() == 3 ? obj._coordinates[2] : 0.0;
+    cross[0] = _coordinates[1] * z2 - z1 * obj._coordinates[1];
+    cross[1] = z1 * obj._coordinates[0] - _coordinates[0] * z2;
     return cross;
 }
 
@@ -721,4 +735,17 @@ bool MESH::Boundary::add_face(std::weak_ptr<face> face)
 bool MESH::Boundary::onBoundary(int globalID) const
 {
     return _global2local.find(globalID) != _global2local.end();
+}
+
+// * * * * * * * * * * * * * *  Update global face indexes * * * * * * * * * * * * * * * //
+void MESH::Boundary::updateFaceIDs()
+{
+    std::vector<std::shared_ptr<face>> faces = return_shared(&_faces);
+
+    _global2local.clear();
+    _faceSeeds.clear();
+    for (int i=0 ; i<faces.size() ; i++) {
+        _global2local[faces[i]->get_id()] = i;
+        _faceSeeds.push_back(faces[i]->get_seed());
+    }
 }
\ No newline at end of file
@@ -8,6 +8,10 @@
 **
 \*------------------------------------------------------------------------*/
 
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
 #include "MeshEntities.hh"
 #include "mesh.hh"
 
@@ -85,7 +89,7 @@ void MESH::mesh::calculateFaceNormalDeltas() {
     _faceNormalDeltas.clear();
 
     // Initialize some variables
-    MATH::Vector delta(_dimension);
+    MATH::Vec<3> delta(_dimension);
     std::shared_ptr<element> elem;
     std::shared_ptr<element> elem2;
 
@@ -106,6 +110,94 @@ void MESH::mesh::calculateFaceNormalDeltas() {
             delta = elem2->get_centroid() - elem->get_centroid();
         }
         // = | vector between elements  dot  face unit normal |
-        _faceNormalDeltas.push_back( abs(delta * elem->get_normals()[*elem==*f]) );
+        _faceNormalDeltas.push_back( std::abs(delta * elem->get_normals()[*elem==*f]) );
+    }
+}
+
+// * * * * * * * * * * * * * *  Renumber mesh entities * * * * * * * * * * * * * * * //
+void MESH::mesh::renumber(renumberingEnum ordering)
+{
+    if (ordering == renumberingEnum::NONE) return;
+
+    // Cell order (order[new] = old)
+    std::vector<int> order;
+    if (ordering == renumberingEnum::RCM) {
+        std::vector<std::vector<int>> adjacency(_elements.size());
+        for (const std::shared_ptr<face>& f : _faces) {
+            if (f->is_boundaryFace()) continue;
+            std::vector<std::shared_ptr<element>> elems = f->get_elements();
+            adjacency[elems[0]->get_id()].push_back(elems[1]->get_id());
+            adjacency[elems[1]->get_id()].push_back(elems[0]->get_id());
+        }
+        order = reverseCuthillMcKee(adjacency);
+    }
+    else {
+        std::vector<MATH::Vec<3>> centroids;
+        centroids.reserve(_elements.size());
+        for (const std::shared_ptr<element>& e : _elements) {
+            centroids.push_back(e->get_centroid());
+        }
+        order = spaceFillingCurveOrder(centroids, _dimension, ordering);
+    }
+
+    // Cells
+    std::vector<std::shared_ptr<element>> elements(_elements.size());
+    for (int c=0 ; c<order.size() ; c++) {
+        elements[c] = _elements[order[c]];
+        elements[c]->set_id(c);
+    }
+    _elements = std::move(elements);
+
+    // Faces follow their lowest numbered cell (interior before boundary faces), then the other cell
+    std::vector<std::pair<int,int>> faceCells(_faces.size());
+    for (int f=0 ; f<_faces.size() ; f++) {
+        std::vector<std::shared_ptr<element>> elems = _faces[f]->get_elements();
+        int first = elems[0]->get_id();
+        int second = _faces[f]->is_boundaryFace() ? static_cast<int>(_elements.size()) : elems[1]->get_id();
+        faceCells[f] = { std::min(first, second), std::max(first, second) };
     }
-}
\ No newline at end of file
+    std::vector<int> faceOrder(_faces.size());
+    std::iota(faceOrder.begin(), faceOrder.end(), 0);
+    std::stable_sort(faceOrder.begin(), faceOrder.end(), [&](int a, int b) { return faceCells[a] < faceCells[b]; });
+
+    std::vector<std::shared_ptr<face>> faces(_faces.size());
+    std::vector<double> faceNormalDeltas(_faceNormalDeltas.size());
+    for (int f=0 ; f<faceOrder.size() ; f++) {
+        faces[f] = _faces[faceOrder[f]];
+        faces[f]->set_id(f);
+        if (!_faceNormalDeltas.empty()) faceNormalDeltas[f] = _faceNormalDeltas[faceOrder[f]];
+    }
+    _faces = std::move(faces);
+    _faceNormalDeltas = std::move(faceNormalDeltas);
+
+    // Nodes in order of first use by the renumbered cells
+    std::vector<std::shared_ptr<node>> nodes;
+    nodes.reserve(_nodes.size());
+    std::vector<bool> numbered(_nodes.size(), false);
+    for (const std::shared_ptr<element>& e : _elements) {
+        for (const std::shared_ptr<node>& n : e->get_nodes()) {
+            if (numbered[n->get_id()]) continue;
+            numbered[n->get_id()] = true;
+            nodes.push_back(n);
+        }
+    }
+    // (nodes not used by any cell keep their relative order at the end)
+    for (const std::shared_ptr<node>& n : _nodes) {
+        if (!numbered[n->get_id()]) nodes.push_back(n);
+    }
+    for (int n=0 ; n<nodes.size() ; n++) {
+        nodes[n]->set_id(n);
+    }
+    _nodes = std::move(nodes);
+
+    // Node IDs and hashes of every entity, then the boundary face maps
+    for (const std::shared_ptr<element>& e : _elements) {
+        e->updateNodeIDs();
+    }
+    for (const std::shared_ptr<face>& f : _faces) {
+        f->updateNodeIDs();
+    }
+    for (const std::shared_ptr<Boundary>& b : _boundaries) {
+        b->updateFaceIDs();
+    }
+}
@@ -0,0 +1,178 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      renumbering.cc
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     Implementation of the cell orderings used to renumber meshes
+**
+\*------------------------------------------------------------------------*/
+
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <cassert>
+
+#include "renumbering.hh"
+
+namespace {
+
+// * * * * * * * * * * * * * *  Breadth first levels * * * * * * * * * * * * * * * //
+// Level structure of the component containing start: returns its depth and the vertices of the last level
+//      (level must be -1 for every vertex of the component, it is reset before returning)
+int bfsLastLevel(const std::vector<std::vector<int>>& adjacency, int start, std::vector<int>& level, std::vector<int>& lastLevel)
+{
+    std::vector<int> queue = {start};
+    level[start] = 0;
+    for (std::size_t head=0 ; head<queue.size() ; head++) {
+        for (int neighbor : adjacency[queue[head]]) {
+            if (level[neighbor] < 0) {
+                level[neighbor] = level[queue[head]] + 1;
+                queue.push_back(neighbor);
+            }
+        }
+    }
+
+    int depth = level[queue.back()];
+    lastLevel.clear();
+    for (int v : queue) {
+        if (level[v] == depth) lastLevel.push_back(v);
+        level[v] = -1;
+    }
+    return depth;
+}
+
+
+// * * * * * * * * * * * * * *  Hilbert transform * * * * * * * * * * * * * * * //
+// Hilbert transform of quantized coordinates to their "transposed" index (J. Skilling, AIP Conf. Proc. 707, 2004)
+void hilbertTranspose(uint32_t* X, int bits, int dimension)
+{
+    uint32_t M = 1u << (bits - 1);
+
+    // Inverse undo
+    for (uint32_t Q = M ; Q > 1 ; Q >>= 1) {
+        uint32_t P = Q - 1;
+        for (int i=0 ; i<dimension ; i++) {
+            if (X[i] & Q) {
+                X[0] ^= P;
+            }
+            else {
+                uint32_t t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+            }
+        }
+    }
+
+    // Gray encode
+    for (int i=1 ; i<dimension ; i++) X[i] ^= X[i-1];
+    uint32_t t = 0;
+    for (uint32_t Q = M ; Q > 1 ; Q >>= 1) {
+        if (X[dimension-1] & Q) t ^= Q - 1;
+    }
+    for (int i=0 ; i<dimension ; i++) X[i] ^= t;
+}
+
+}
+
+// * * * * * * * * * * * * * *  Reverse Cuthill-McKee * * * * * * * * * * * * * * * //
+std::vector<int> MESH::reverseCuthillMcKee(const std::vector<std::vector<int>>& adjacency)
+{
+    int n = adjacency.size();
+    std::vector<int> order;
+    order.reserve(n);
+
+    // Vertices by increasing degree, to start every component at a low degree vertex
+    std::vector<int> byDegree(n);
+    std::iota(byDegree.begin(), byDegree.end(), 0);
+    std::stable_sort(byDegree.begin(), byDegree.end(), [&](int a, int b) { return adjacency[a].size() < adjacency[b].size(); });
+
+    std::vector<bool> visited(n, false);
+    std::vector<int> level(n, -1);
+    std::vector<int> lastLevel;
+    std::vector<int> neighbors;
+    for (int candidate : byDegree) {
+        if (visited[candidate]) continue;
+
+        // Pseudo-peripheral start: move to the lowest degree vertex of the last level while the depth grows
+        int start = candidate;
+        int depth = bfsLastLevel(adjacency, start, level, lastLevel);
+        while (true) {
+            int next = *std::min_element(lastLevel.begin(), lastLevel.end(), [&](int a, int b) { return adjacency[a].size() < adjacency[b].size(); });
+            int nextDepth = bfsLastLevel(adjacency, next, level, lastLevel);
+            if (nextDepth <= depth) break;
+            start = next;
+            depth = nextDepth;
+        }
+
+        // Cuthill-McKee: breadth first, unvisited neighbors by increasing degree
+        std::size_t head = order.size();
+        order.push_back(start);
+        visited[start] = true;
+        for ( ; head<order.size() ; head++) {
+            neighbors.clear();
+            for (int neighbor : adjacency[order[head]]) {
+                if (!visited[neighbor]) {
+                    visited[neighbor] = true;
+                    neighbors.push_back(neighbor);
+                }
+            }
+            std::stable_sort(neighbors.begin(), neighbors.end(), [&](int a, int b) { return adjacency[a].size() < adjacency[b].size(); });
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+
+    // Reversing the order keeps the bandwidth and reduces fill in factorizations
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+
+// * * * * * * * * * * * * * *  Space filling curves * * * * * * * * * * * * * * * //
+std::vector<int> MESH::spaceFillingCurveOrder(const std::vector<MATH::Vec<3>>& points, int dimension, renumberingEnum curve)
+{
+    assert((dimension == 2 || dimension == 3) && "Space filling curves are defined in 2D and 3D");
+    assert((curve == renumberingEnum::HILBERT || curve == renumberingEnum::MORTON) && "Not a space filling curve");
+
+    int n = points.size();
+    if (n == 0) return {};
+
+    // Quantize to a cube around the points (same scale in every direction), keys fit in 64 bits
+    int bits = (dimension == 2) ? 31 : 21;
+    double lower[3] = {0.0, 0.0, 0.0};
+    double extent = 0.0;
+    for (int d=0 ; d<dimension ; d++) {
+        double lo = points[0][d];
+        double hi = points[0][d];
+        for (const MATH::Vec<3>& p : points) {
+            lo = std::min(lo, p[d]);
+            hi = std::max(hi, p[d]);
+        }
+        lower[d] = lo;
+        extent = std::max(extent, hi - lo);
+    }
+    double scale = (extent > 0.0) ? ((1u << bits) - 1) / extent : 0.0;
+
+    std::vector<uint64_t> keys(n);
+    uint32_t X[3];
+    for (int i=0 ; i<n ; i++) {
+        for (int d=0 ; d<dimension ; d++) {
+            X[d] = static_cast<uint32_t>((points[i][d] - lower[d]) * scale);
+        }
+        if (curve == renumberingEnum::HILBERT) hilbertTranspose(X, bits, dimension);
+
+        // Interleave bits, most significant first
+        uint64_t key = 0;
+        for (int b=bits-1 ; b>=0 ; b--) {
+            for (int d=0 ; d<dimension ; d++) {
+                key = (key << 1) | ((X[d] >> b) & 1u);
+            }
+        }
+        keys[i] = key;
+    }
+
+    std::vector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return keys[a] < keys[b]; });
+    return order;
+}
@@ -14,7 +14,7 @@
 
 #include "gtest/gtest.h"
 
-#include "Vector.hh"
+#include "Vec.hh"
 #include "MeshEntities.hh"
 #include "mesh.hh"
 
@@ -25,10 +25,10 @@ public:
     // Constructor: Make a simple square which is divided into two triangles
     meshEntities_test() 
     :
-        pn1(std::make_shared<MESH::node>(MESH::node(1, MATH::Vector(std::vector<double>{0.0,0.0})))),
-        pn2(std::make_shared<MESH::node>(MESH::node(2, MATH::Vector(std::vector<double>{1.0,0.0})))),
-        pn3(std::make_shared<MESH::node>(MESH::node(3, MATH::Vector(std::vector<double>{0.0,1.0})))),
-        pn4(std::make_shared<MESH::node>(MESH::node(4, MATH::Vector(std::vector<double>{1.0,1.0})))),
+        pn1(std::make_shared<MESH::node>(MESH::node(1, MATH::Vec<3>(std::vector<double>{0.0,0.0})))),
+        pn2(std::make_shared<MESH::node>(MESH::node(2, MATH::Vec<3>(std::vector<double>{1.0,0.0})))),
+        pn3(std::make_shared<MESH::node>(MESH::node(3, MATH::Vec<3>(std::vector<double>{0.0,1.0})))),
+        pn4(std::make_shared<MESH::node>(MESH::node(4, MATH::Vec<3>(std::vector<double>{1.0,1.0})))),
         pf1(std::make_shared<MESH::face>(MESH::face(1, elementTypeEnum::LINE, std::vector<std::weak_ptr<MESH::node>>{pn1,pn2}, true))),
         pf2(std::make_shared<MESH::face>(MESH::face(2, elementTypeEnum::LINE, std::vector<std::weak_ptr<MESH::node>>{pn2,pn3}, false))),
         pf3(std::make_shared<MESH::face>(MESH::face(3, elementTypeEnum::LINE, std::vector<std::weak_ptr<MESH::node>>{pn1,pn3}, true))),
@@ -86,6 +86,26 @@ TEST_F(meshEntities_test, testNodeDistanceWeights)
     EXPECT_EQ(pn2->get_distanceWeights()[1], 0.5);
 }
 
+// * * * * * * * * * * * * * cross product * * * * * * * * * * * * * * //
+TEST_F(meshEntities_test, testNodeCrossProduct)
+{
+    /* Arrange */
+    MESH::node n3D(5, MATH::Vec<3>(std::vector<double>{0.0,0.0,2.0}));
+
+    /* Act */
+    MATH::Vec<3> cross2D = (*this->pn2) / (*this->pn3);
+    MATH::Vec<3> cross3D = (*this->pn2) / n3D;
+
+    /* Assert: 2D nodes lie in the z = 0 plane */
+    ASSERT_EQ(cross2D.size(), 3u);
+    EXPECT_EQ(cross2D[0], 0.0);
+    EXPECT_EQ(cross2D[1], 0.0);
+    EXPECT_EQ(cross2D[2], 1.0);
+    EXPECT_EQ(cross3D[0], 0.0);
+    EXPECT_EQ(cross3D[1], -2.0);
+    EXPECT_EQ(cross3D[2], 0.0);
+}
+
 
 /*------------------------------------------------------------------------*\
 **  testing mesh entity
@@ -229,4 +249,51 @@ TEST_F(meshEntities_test, testElementFaces)
 
 
 
-    
\ No newline at end of file
+    
+// * * * * * * * * * * Quadrilateral with shuffled nodes * * * * * * * * * * * //
+TEST_F(meshEntities_test, testElementQuadOrder)
+{
+    /* Arrange */
+    // Trapezoid (0,0) (2,0) (1,1) (0,1), nodes given out of order
+    std::shared_ptr<MESH::node> a = std::make_shared<MESH::node>(MESH::node(0, MATH::Vec<3>(std::vector<double>{1.0,1.0})));
+    std::shared_ptr<MESH::node> b = std::make_shared<MESH::node>(MESH::node(1, MATH::Vec<3>(std::vector<double>{0.0,0.0})));
+    std::shared_ptr<MESH::node> c = std::make_shared<MESH::node>(MESH::node(2, MATH::Vec<3>(std::vector<double>{0.0,1.0})));
+    std::shared_ptr<MESH::node> d = std::make_shared<MESH::node>(MESH::node(3, MATH::Vec<3>(std::vector<double>{2.0,0.0})));
+
+    /* Act */
+    std::shared_ptr<MESH::element> e = std::make_shared<MESH::element>(MESH::element(1, elementTypeEnum::QUADRILATERAL, std::vector<std::weak_ptr<MESH::node>>{a,b,c,d}));
+    std::vector<MESH::face> faces = e->determineSubElements();
+
+    /* Assert */
+    // Counter-clockwise from the leftmost node (lowest index on ties)
+    std::vector<int> order = {1, 3, 0, 2};
+    EXPECT_EQ(e->get_nodeOrder(), order);
+    // Area and area centroid of the trapezoid
+    EXPECT_DOUBLE_EQ(e->get_volume(), 1.5);
+    EXPECT_DOUBLE_EQ(e->get_centroid()[0], 7.0/9.0);
+    EXPECT_DOUBLE_EQ(e->get_centroid()[1], 4.0/9.0);
+    // Faces follow the perimeter
+    ASSERT_EQ(faces.size(), 4u);
+    EXPECT_EQ(faces[0].get_seed(), "1-3-");
+    EXPECT_EQ(faces[1].get_seed(), "0-3-");
+    EXPECT_EQ(faces[2].get_seed(), "0-2-");
+    EXPECT_EQ(faces[3].get_seed(), "1-2-");
+    EXPECT_DOUBLE_EQ(faces[1].get_volume(), std::sqrt(2.0));
+}
+
+// * * * * * * * * * * Planar element stored with a z coordinate * * * * * * * * * * * //
+TEST_F(meshEntities_test, testElementCentroidKeepsPlane)
+{
+    /* Arrange */
+    std::shared_ptr<MESH::node> a = std::make_shared<MESH::node>(MESH::node(0, MATH::Vec<3>(std::vector<double>{0.0,0.0,2.0})));
+    std::shared_ptr<MESH::node> b = std::make_shared<MESH::node>(MESH::node(1, MATH::Vec<3>(std::vector<double>{3.0,0.0,2.0})));
+    std::shared_ptr<MESH::node> c = std::make_shared<MESH::node>(MESH::node(2, MATH::Vec<3>(std::vector<double>{0.0,3.0,2.0})));
+
+    /* Act */
+    std::shared_ptr<MESH::element> e = std::make_shared<MESH::element>(MESH::element(1, elementTypeEnum::TRIANGLE, std::vector<std::weak_ptr<MESH::node>>{a,b,c}));
+
+    /* Assert */
+    EXPECT_DOUBLE_EQ(e->get_centroid()[0], 1.0);
+    EXPECT_DOUBLE_EQ(e->get_centroid()[1], 1.0);
+    EXPECT_DOUBLE_EQ(e->get_centroid()[2], 2.0);
+}
@@ -73,3 +73,67 @@ TEST_F(mesh_test, readFaceNormalDeltas)
         }
     }
 }
+
+
+// * * * * * * * * * * * * * *  test renumbering * * * * * * * * * * * * * * * //
+TEST(mesh_renumbering, renumberKeepsConnectivity)
+{
+    std::filesystem::path meshFile(SU2_MESH_DIR "/su2/square_wQuad.su2");
+
+    // Largest |owner - neighbor| over the interior faces
+    auto bandwidth = [](const MESH::mesh& m) {
+        int width = 0;
+        for (const std::shared_ptr<MESH::face>& f : m.get_faces()) {
+            if (f->is_boundaryFace()) continue;
+            width = std::max(width, std::abs(f->get_elements()[0]->get_id() - f->get_elements()[1]->get_id()));
+        }
+        return width;
+    };
+
+    for (MESH::renumberingEnum ordering : {MESH::renumberingEnum::RCM, MESH::renumberingEnum::HILBERT, MESH::renumberingEnum::MORTON})
+    {
+        // Arrange
+        MESH::read_su2 reader(meshFile);
+        MESH::mesh m = reader.get_mesh();
+        int originalBandwidth = bandwidth(m);
+        std::vector<MATH::Vec<3>> centroids;
+        for (const std::shared_ptr<MESH::element>& e : m.get_elements()) centroids.push_back(e->get_centroid());
+
+        // Act
+        m.renumber(ordering);
+
+        // Assert: IDs are positions, connectivity and boundary maps follow
+        std::vector<bool> seen(centroids.size(), false);
+        for (int c=0 ; c<m.get_elements().size() ; c++) {
+            ASSERT_EQ(m.get_elements()[c]->get_id(), c);
+            auto it = std::find(centroids.begin(), centroids.end(), m.get_elements()[c]->get_centroid());
+            ASSERT_NE(it, centroids.end());
+            seen[it - centroids.begin()] = true;
+        }
+        EXPECT_EQ(std::count(seen.begin(), seen.end(), true), centroids.size());
+        for (int n=0 ; n<m.get_nodes().size() ; n++) {
+            ASSERT_EQ(m.get_nodes()[n]->get_id(), n);
+        }
+
+        std::vector<double> deltas = m.get_faceNormalDeltas();
+        m.calculateFaceNormalDeltas();
+        for (int f=0 ; f<m.get_faces().size() ; f++) {
+            const std::shared_ptr<MESH::face>& face = m.get_faces()[f];
+            ASSERT_EQ(face->get_id(), f);
+            ASSERT_DOUBLE_EQ(deltas[f], m.get_faceNormalDeltas()[f]);
+            for (int n=0 ; n<face->get_nodes().size() ; n++) {
+                ASSERT_EQ(face->get_nodeIDs()[n], face->get_nodes()[n]->get_id());
+            }
+            for (const std::shared_ptr<MESH::element>& e : face->get_elements()) {
+                ASSERT_EQ(e->get_faces()[*e==*face]->get_id(), f);
+            }
+            if (face->is_boundaryFace()) {
+                EXPECT_TRUE(m.get_boundaries()[m.get_boundaryIdx(face->get_boundaryID())]->onBoundary(f));
+            }
+        }
+
+        if (ordering == MESH::renumberingEnum::RCM) {
+            EXPECT_LE(bandwidth(m), originalBandwidth);
+        }
+    }
+}
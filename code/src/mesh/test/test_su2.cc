@@ -238,7 +238,7 @@ TEST_F(read_su2_mesh_test, readNormals)
         // Assert
         // Loop over elements
         for (int element=0 ; element<elements.size() ; element++){
-            std::vector<MATH::Vector> normals = elements[element]->get_normals();
+            std::vector<MATH::Vec<3>> normals = elements[element]->get_normals();
             // Loop over subelements
             for (int face=0 ; face<elements[element]->get_faces().size() ; face++){                
                 // Loop Over dimensions
@@ -50,7 +50,7 @@ protected:
         // Set Boundary conditions
         BOUNDARIES::viscousWallBC testWallLower(solver,"lower");
         BOUNDARIES::viscousWallBC testWallUpper(solver,"upper");
-        testWallLower.set_velocity(MATH::Vector(std::vector<double>{1.0,2.0}));
+        testWallLower.set_velocity(MATH::Vec<3>(std::vector<double>{1.0,2.0}));
         solver->setBoundaryCondition(std::make_shared<BOUNDARIES::viscousWallBC>(testWallLower));
         solver->setBoundaryCondition(std::make_shared<BOUNDARIES::viscousWallBC>(testWallUpper));
     }
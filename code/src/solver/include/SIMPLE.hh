@@ -13,12 +13,14 @@
 
 #include <memory>
 #include <algorithm>
+#include <filesystem>
 
 #include "Solver.hh"
 #include "BoundaryConditions.hh"
 #include "fields.hh"
 #include "linearSolvers.hh"
 #include "MeshEntities.hh"
+#include "faceOperators.hh"
 
 namespace SOLVER
 {
@@ -53,6 +55,22 @@ public:
         // POSSIBLY SOME FAT TO CUT
         // Function to get face velocities 
         void computeFaceVelocities();
+
+    // Set methods
+        // Select the pressure correction preconditioner (none, jacobi, ic0, ssor, amg)
+        void set_pressurePreconditioner(MATH::preconditionerType type);
+        // Select the pressure correction solver (conjugate_gradient by default, deflated_conjugate_gradient recycles slow modes,
+        //      chebyshev avoids inner products and keeps its eigenvalue estimates across outer iterations,
+        //      direct_cholesky factors the system and keeps its symbolic factorization across outer iterations,
+        //      which only beats the default on small meshes)
+        void set_pressureSolver(MATH::linearSolverType type);
+        // Select the momentum solver (gauss_seidel by default, bicgstab/gmres for strongly convective flows) and its preconditioner
+        void set_momentumSolver(MATH::linearSolverType type, MATH::preconditionerType preconditioner = MATH::preconditionerType::none);
+        // Solve momentum and pressure correction matrix-free (Jacobi preconditioned BiCGSTAB / CG applying A by face loops)
+        void set_matrixFree(bool matrixFree);
+        // Write the assembled momentum and pressure correction systems (Matrix Market) at the given outer iterations (1-based)
+        //      files: momentum_A_<it>.mtx, momentum_b{x,y,z}_<it>.mtx, pressure_A_<it>.mtx, pressure_b_<it>.mtx
+        void set_systemDump(std::filesystem::path directory, std::vector<int> iterations);
         
 
     // Member Data
@@ -66,8 +84,41 @@ private:
         MATH::Vector _momentumSystemb_x;
         MATH::Vector _momentumSystemb_y;
         MATH::Vector _momentumSystemb_z;
+        // Momentum solver (references the momentum system, kept across outer iterations with its workspace)
+        std::unique_ptr<MATH::linear_solver_base<MATH::matrixCSR>> _momentumSolver;
+        // Right-hand sides and solutions of all velocity components for the multi-RHS solve
+        std::vector<MATH::Vector> _momentumRhs;
+        std::vector<MATH::Vector> _momentumSolution;
+        // Pressure Correction system (A), shares the momentum matrix pattern
+        MATH::matrixCSR _pressureCorrectionA;
+        // Pressure Correction operator for the CG solve (CSR or SELL, chosen on the first solve)
+        MATH::matrixAutotuned _pressureCorrectionOperator;
+        // Pressure correction preconditioner (AMG by default, kept across outer iterations)
+        std::shared_ptr<MATH::preconditioner_base<MATH::matrixAutotuned>> _pressurePreconditioner;
+        // Pressure correction solver (references the operator, kept across outer iterations so a
+        //      deflated CG recycles its deflation space and Chebyshev its eigenvalue bounds from one outer iteration to the next)
+        std::unique_ptr<MATH::linear_solver_base<MATH::matrixAutotuned>> _pressureSolver;
         // Pressure Correction
         MATH::Vector _pressureCorrection;
+        // Pressure correction rhs (mass imbalance of every cell), the pressure solvers reference it
+        MATH::Vector _pressureCorrectionRhs;
+        // Initial guess of the pressure correction, stays zero (copied into the solver at every solve)
+        MATH::Vector _pressureCorrectionGuess;
+        // Momentum matrix diagonal (from the assembled matrix or the matrix-free operator)
+        MATH::Vector _momentumDiagonal;
+
+        // Matrix-free systems: face-loop operators and their solvers (replace the assembled systems when enabled)
+        bool _matrixFree = false;
+        std::unique_ptr<momentumOperator> _momentumFaceOperator;
+        std::unique_ptr<pressureCorrectionOperator> _pressureCorrectionFaceOperator;
+        MATH::bicgstab<MATH::linearOperator> _matrixFreeMomentumSolver;
+        MATH::conjugate_gradient<MATH::linearOperator> _matrixFreePressureSolver;
+
+        // System dumps for offline solver tuning
+        std::filesystem::path _dumpDirectory;
+        std::vector<int> _dumpIterations;
+        // Current outer iteration (1-based)
+        int _iteration = 0;
         
     // Member Functions
         // Update momentum system of equations
@@ -76,6 +127,8 @@ private:
         void updateMomentumRHS();
         // Check for convergence
         bool checkConvergence();
+        // Check if the systems are dumped at the current iteration
+        bool dumpSystems() const;
 
 };
 
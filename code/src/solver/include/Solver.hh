@@ -12,10 +12,12 @@
 #define _SOLVER_HH_
 
 #include <memory>
+#include <array>
 #include "mesh.hh"
 #include "sparseMatrix.hh"
 #include "fields.hh"
 #include "Vector.hh"
+#include "Vec.hh"
 
 // Forward Declarations for circular inclusions
 namespace BOUNDARIES {
@@ -37,11 +39,11 @@ protected:
         // smart pointer to mesh
         std::shared_ptr<MESH::mesh> _mesh;
         // Cell Velocity Field
-        UTILITIES::field<MATH::Vector> _cellVelocityField;
+        UTILITIES::field<MATH::Vec<3>> _cellVelocityField;
         // Face Velocity Field
-        UTILITIES::field<MATH::Vector> _faceVelocityField;
+        UTILITIES::field<MATH::Vec<3>> _faceVelocityField;
         // Node Velocity Field
-        UTILITIES::field<MATH::Vector> _nodeVelocityField;
+        UTILITIES::field<MATH::Vec<3>> _nodeVelocityField;
         // Cell Pressure Field
         UTILITIES::field<double> _cellPressureField;
         // Face Pressure Field
@@ -54,6 +56,15 @@ protected:
         MATH::matrixCSR _massFluxDirection;
         // Distance between neighboring cells normal to face (len = nfaces)
         std::vector<double> _faceNormalDeltas;
+        // Face to cell connectivity (len = nfaces, neighbor is -1 on boundary faces)
+        std::vector<int> _faceOwners;
+        std::vector<int> _faceNeighbors;
+        // Distance weight of the owner cell at each face (len = nfaces, 1 on boundary faces)
+        std::vector<double> _faceWeights;
+        // Cell to cell sparsity pattern shared by all cell-centered matrices
+        std::shared_ptr<MATH::sparsityPattern> _cellPattern;
+        // Matrix storage slots of [owner,neighbor] and [neighbor,owner] entries (len = nfaces, -1 on boundary faces)
+        std::vector<std::array<int,2>> _faceSlots;
         // Flag if the system has been solved or not
         bool _solved = false;
         // Boundary Conditions Vector (Use smart pointers to allow polymorphism, Solver owns boundary conditions -> boundary conditions use weak pointers)
@@ -79,6 +90,8 @@ protected:
     // Member Functions
         // Calculate cell center difference normal to face
         void calculateFaceNormalDeltas();
+        // Build face-cell connectivity and the cell matrix pattern
+        void buildCellConnectivity();
         
         
 
@@ -98,13 +111,13 @@ public:
         // Pure virual function for solver
         virtual void solve() {_solved = true;};
         // Calculate cell face pressure gradient
-        std::vector<MATH::Vector> computeCellPressureGradient(std::vector<double>);
+        std::vector<MATH::Vec<3>> computeCellPressureGradient(std::vector<double>);
         // Function to get Pressure gradients across faces
-        std::vector<MATH::Vector> computeFacePressureGradient(std::vector<double>, std::vector<double>);
+        std::vector<MATH::Vec<3>> computeFacePressureGradient(std::vector<double>, std::vector<double>);
         // Calculate face pressures
         std::vector<double> computeFacePressure(std::vector<double>);
         // Get nodal values using of field
-        std::vector<MATH::Vector> computeNodalVector(UTILITIES::field<MATH::Vector>);
+        std::vector<MATH::Vec<3>> computeNodalVector(UTILITIES::field<MATH::Vec<3>>);
         std::vector<double> computeNodalScalar(UTILITIES::field<double>);
         // Set Boundary Conditions
         void setBoundaryCondition(std::shared_ptr<BOUNDARIES::BoundaryCondition> bc);
@@ -120,16 +133,18 @@ public:
         std::shared_ptr<BOUNDARIES::BoundaryCondition> get_boundaryCondition(int idx) { return _BCs[idx]; };
         // get face normal deltas
         const std::vector<double> get_faceNormalDeltas() const { return _faceNormalDeltas; };
+        // get cell matrix pattern
+        const std::shared_ptr<MATH::sparsityPattern> get_cellPattern() const { return _cellPattern; };
         // get cell pressure field
         UTILITIES::field<double> get_cellPressureField() const { return _cellPressureField; };
         // get face pressure field
         UTILITIES::field<double> get_facePressureField() const { return _facePressureField; };
         // get velocity field
-        UTILITIES::field<MATH::Vector> get_cellVelocityField() const { return _cellVelocityField; };
+        UTILITIES::field<MATH::Vec<3>> get_cellVelocityField() const { return _cellVelocityField; };
         // get face velocity field
-        UTILITIES::field<MATH::Vector> get_faceVelocityField() const { return _faceVelocityField; };
+        UTILITIES::field<MATH::Vec<3>> get_faceVelocityField() const { return _faceVelocityField; };
         // get node velocity field
-        UTILITIES::field<MATH::Vector> get_nodeVelocityField() const { return _nodeVelocityField; };
+        UTILITIES::field<MATH::Vec<3>> get_nodeVelocityField() const { return _nodeVelocityField; };
         // get face mass flux field
         UTILITIES::field<double> get_faceMassFluxField() const { return _faceMassFluxField; };
         // get solver variables
@@ -0,0 +1,108 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      faceOperators.hh
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     matrix-free momentum and pressure correction operators of the SIMPLE solver
+**
+\*------------------------------------------------------------------------*/
+
+#ifndef _FACEOPERATORS_HH_
+#define _FACEOPERATORS_HH_
+
+#include <vector>
+
+#include "linearOperator.hh"
+#include "Vector.hh"
+
+namespace SOLVER
+{
+
+/*------------------------------------------------------------------------*\
+**  Class faceOperator Declaration
+\*------------------------------------------------------------------------*/
+
+// Cell-centered operator built from per-face coefficients, applied without an assembled matrix
+//      Every cell gathers the contributions of its faces, so rows are computed independently (in parallel)
+//      and the result matches the assembled matrix of the same coefficients.
+class faceOperator
+:
+    public MATH::linearOperator
+{
+public:
+    // Constructor
+        // Face to cell connectivity (neighbor is -1 on boundary faces)
+        faceOperator(int numCells, const std::vector<int>& faceOwners, const std::vector<int>& faceNeighbors);
+
+protected:
+    // Member Data
+        std::vector<int> _faceOwners;
+        std::vector<int> _faceNeighbors;
+        // Faces of every cell: _cellFaces[_cellFaceOffsets[c]] ... [_cellFaceOffsets[c+1]-1]
+        std::vector<int> _cellFaceOffsets;
+        std::vector<int> _cellFaces;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class momentumOperator Declaration
+\*------------------------------------------------------------------------*/
+
+// Momentum operator with first order upwinding: per face, the diffusion conductance D = mu*area/delta
+//      and the mass flux into the owner and into the neighbor cell
+//      a_PP += (|m_P| + m_P)/2 + D,  a_PN = -(|m_P| - m_P)/2 - D
+class momentumOperator
+:
+    public faceOperator
+{
+public:
+    // Constructor
+        momentumOperator(int numCells, const std::vector<int>& faceOwners, const std::vector<int>& faceNeighbors, std::vector<double> conductance);
+
+    // Member Functions
+        void multiply(const MATH::Vector& x, MATH::Vector& y) const override;
+        MATH::Vector get_diagonal() const override;
+
+    // Set member functions
+        // Mass flux INTO the owner / neighbor cell of every face (neighbor value unused on boundary faces)
+        void set_massFluxes(std::vector<double> ownerFlux, std::vector<double> neighborFlux);
+
+private:
+    // Member Data
+        std::vector<double> _conductance;
+        std::vector<double> _ownerFlux;
+        std::vector<double> _neighborFlux;
+};
+
+
+/*------------------------------------------------------------------------*\
+**  Class pressureCorrectionOperator Declaration
+\*------------------------------------------------------------------------*/
+
+// Pressure correction operator: one symmetric coefficient c_f (< 0) per interior face,
+//      (A p')_P = sum_f c_f (p'_N - p'_P)
+class pressureCorrectionOperator
+:
+    public faceOperator
+{
+public:
+    // Constructor
+        pressureCorrectionOperator(int numCells, const std::vector<int>& faceOwners, const std::vector<int>& faceNeighbors);
+
+    // Member Functions
+        void multiply(const MATH::Vector& x, MATH::Vector& y) const override;
+        MATH::Vector get_diagonal() const override;
+
+    // Set member functions
+        // Off-diagonal coefficient of every face (unused on boundary faces)
+        void set_coefficients(std::vector<double> coefficients) { _coefficients = std::move(coefficients); };
+
+private:
+    // Member Data
+        std::vector<double> _coefficients;
+};
+
+}
+
+#endif // _FACEOPERATORS_HH_
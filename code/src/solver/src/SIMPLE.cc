@@ -11,10 +11,12 @@
 // TEMPORARY, DELETE LATER
 #include <iostream>
 #include <fstream>
+#include <cmath>
 
 #include <chrono>
 
 #include "SIMPLE.hh"
+#include "matrixMarket.hh"
 
 
 /*------------------------------------------------------------------------*\
@@ -25,11 +27,21 @@
 SOLVER::SIMPLE::SIMPLE(std::shared_ptr<MESH::mesh> mesh)
 :
     SOLVER::Solver(mesh),
-    _momentumSystemA(_mesh->get_elements().size(),_mesh->get_elements().size()),
+    _momentumSystemA(_cellPattern),
     _momentumSystemb_x(_mesh->get_elements().size()),
     _momentumSystemb_y(_mesh->get_elements().size()),
-    _momentumSystemb_z(_mesh->get_elements().size())
+    _momentumSystemb_z(_mesh->get_elements().size()),
+    _pressureCorrectionA(_cellPattern),
+    _pressureCorrectionOperator(_pressureCorrectionA),
+    _pressurePreconditioner(MATH::make_preconditioner<MATH::matrixAutotuned>(MATH::preconditionerType::amg)),
+    _pressureCorrectionRhs(_mesh->get_elements().size()),
+    _pressureCorrectionGuess(_mesh->get_elements().size()),
+    _momentumDiagonal(_mesh->get_elements().size())
 {
+    // Linear solvers live as long as the SIMPLE object and reference its systems
+    set_momentumSolver(MATH::linearSolverType::gauss_seidel);
+    set_pressureSolver(MATH::linearSolverType::conjugate_gradient);
+
     // Initialize face mass flux field
     std::cout << "Initializing face mass flux field...";
     _faceMassFluxField = UTILITIES::field(_mesh, 0.0, "face",UTILITIES::fieldTypeEnum::MASSFLUX);
@@ -42,6 +54,76 @@ SOLVER::SIMPLE::SIMPLE(std::shared_ptr<MESH::mesh> mesh)
 
 };
 
+// * * * * * * * * * * * * * *  Set Linear Solvers * * * * * * * * * * * * * * * //
+void SOLVER::SIMPLE::set_pressurePreconditioner(MATH::preconditionerType type)
+{
+    _pressurePreconditioner = MATH::make_preconditioner<MATH::matrixAutotuned>(type);
+    _pressureSolver->set_preconditioner(_pressurePreconditioner);
+}
+
+void SOLVER::SIMPLE::set_pressureSolver(MATH::linearSolverType type)
+{
+    _pressureSolver = MATH::make_linear_solver<MATH::matrixAutotuned>(type);
+    _pressureSolver->set_matrix(_pressureCorrectionOperator);
+    _pressureSolver->set_rhs(_pressureCorrectionRhs);
+    _pressureSolver->set_preconditioner(_pressurePreconditioner);
+}
+
+void SOLVER::SIMPLE::set_momentumSolver(MATH::linearSolverType type, MATH::preconditionerType preconditioner)
+{
+    _momentumSolver = MATH::make_linear_solver<MATH::matrixCSR>(type);
+    _momentumSolver->set_matrix(_momentumSystemA);
+    _momentumSolver->set_preconditioner(MATH::make_preconditioner<MATH::matrixCSR>(preconditioner));
+}
+
+void SOLVER::SIMPLE::set_matrixFree(bool matrixFree)
+{
+    _matrixFree = matrixFree;
+    if (!_matrixFree || _momentumFaceOperator) {
+        updateMomentumMatrix();
+        return;
+    }
+
+    // Diffusion conductance of every face does not change between outer iterations
+    const std::vector<std::shared_ptr<MESH::face>>& faces = _mesh->get_faces();
+    std::vector<double> conductance(faces.size());
+    for (std::size_t f=0 ; f<faces.size() ; f++) {
+        conductance[f] = mu*faces[f]->get_volume()/_faceNormalDeltas[f];
+    }
+
+    int numCells = _mesh->get_elements().size();
+    _momentumFaceOperator = std::make_unique<momentumOperator>(numCells, _faceOwners, _faceNeighbors, conductance);
+    _pressureCorrectionFaceOperator = std::make_unique<pressureCorrectionOperator>(numCells, _faceOwners, _faceNeighbors);
+
+    // Only the diagonal is available without assembly, so both solves are Jacobi preconditioned
+    _matrixFreeMomentumSolver.set_matrix(*_momentumFaceOperator);
+    _matrixFreeMomentumSolver.set_preconditioner(std::make_shared<MATH::jacobi_preconditioner<MATH::linearOperator>>());
+    _matrixFreePressureSolver.set_matrix(*_pressureCorrectionFaceOperator);
+    _matrixFreePressureSolver.set_rhs(_pressureCorrectionRhs);
+    _matrixFreePressureSolver.set_preconditioner(std::make_shared<MATH::jacobi_preconditioner<MATH::linearOperator>>());
+
+    updateMomentumMatrix();
+}
+
+
+void SOLVER::SIMPLE::set_systemDump(std::filesystem::path directory, std::vector<int> iterations)
+{
+    std::filesystem::create_directories(directory);
+    _dumpDirectory = directory;
+    _dumpIterations = iterations;
+}
+
+bool SOLVER::SIMPLE::dumpSystems() const
+{
+    if (std::find(_dumpIterations.begin(), _dumpIterations.end(), _iteration) == _dumpIterations.end()) return false;
+    if (_matrixFree) {
+        std::cout << "  Matrix-free systems are not assembled, skipping the system dump" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+
 // * * * * * * * * * * * * * *  Solve Method * * * * * * * * * * * * * * * //
 void SOLVER::SIMPLE::solve()
 {
@@ -62,6 +144,7 @@ void SOLVER::SIMPLE::solve()
     {
         std::cout << "==========================" << std::endl;
         std::cout << "Iteration: " << i+1 << std::endl;
+        _iteration = i+1;
         
         // Solving momentum system
         std::cout << "Solving Momentum System..." << std::endl;
@@ -108,12 +191,12 @@ void SOLVER::SIMPLE::solve()
 void SOLVER::SIMPLE::computeFaceVelocities()
 {
     // Initialize
-    std::vector<MATH::Vector> faceVelocities;
-    MATH::Vector faceVelocity(_mesh->get_dimension());
+    std::vector<MATH::Vec<3>> faceVelocities;
+    MATH::Vec<3> faceVelocity(_mesh->get_dimension());
 
     // Compute cell and face pressure gradients
-    std::vector<MATH::Vector> cellPressureGradients = computeCellPressureGradient(_facePressureField.get_internal());
-    std::vector<MATH::Vector> facePressureGradients = computeFacePressureGradient(_cellPressureField.get_internal(), _facePressureField.get_internal());
+    std::vector<MATH::Vec<3>> cellPressureGradients = computeCellPressureGradient(_facePressureField.get_internal());
+    std::vector<MATH::Vec<3>> facePressureGradients = computeFacePressureGradient(_cellPressureField.get_internal(), _facePressureField.get_internal());
     
     // Initialize variables
     double w1;
@@ -122,9 +205,12 @@ void SOLVER::SIMPLE::computeFaceVelocities()
     std::shared_ptr<MESH::element> cell1;
     std::shared_ptr<MESH::element> cell2;
 
-    MATH::Vector ucell1;
-    MATH::Vector ucell2;
-    MATH::Vector udp;
+    MATH::Vec<3> ucell1;
+    MATH::Vec<3> ucell2;
+    MATH::Vec<3> udp;
+
+    // Momentum matrix diagonal
+    const MATH::Vector& A0 = _momentumDiagonal;
 
     // Loop over faces
     for (const std::shared_ptr<MESH::face>& f : _mesh->get_faces() ) {
@@ -142,10 +228,10 @@ void SOLVER::SIMPLE::computeFaceVelocities()
             w1 = cell1->get_distanceWeights()[*cell1==*f];
 
             // Cell 1 contribution
-            A0_1 = _momentumSystemA.get_value(cell1->get_id(),cell1->get_id());
+            A0_1 = A0[cell1->get_id()];
             ucell1 = w1 * ( _cellVelocityField.get_internal()[cell1->get_id()] + (1.0/A0_1 )*cell1->get_volume()*cellPressureGradients[cell1->get_id()] );
             // Cell 2 contribution
-            A0_2 = _momentumSystemA.get_value(cell2->get_id(),cell2->get_id());
+            A0_2 = A0[cell2->get_id()];
             ucell2 = (1.0 - w1) * ( _cellVelocityField.get_internal()[cell2->get_id()] + (1.0/A0_2 )*cell2->get_volume()*cellPressureGradients[cell2->get_id()] );
             // Pressure contribution
             udp = (w1*(cell1->get_volume()/A0_1) + (1.0-w1)*(cell2->get_volume()/A0_2)) * facePressureGradients[f->get_id()];
@@ -168,13 +254,13 @@ void SOLVER::SIMPLE::computeFaceVelocities()
 void SOLVER::SIMPLE::computeFaceMassFlux()
 {
     computeFaceVelocities();
-    std::vector<MATH::Vector> faceVelocities = _faceVelocityField.get_internal();
+    std::vector<MATH::Vec<3>> faceVelocities = _faceVelocityField.get_internal();
     std::vector<double> mdotf = _faceMassFluxField.get_internal();
 
     // Initializing variables
     std::shared_ptr<MESH::element> cell1;
     std::shared_ptr<MESH::element> cell2;
-    MATH::Vector faceNormal;
+    MATH::Vec<3> faceNormal;
     
 
     // Loop over faces
@@ -201,7 +287,7 @@ void SOLVER::SIMPLE::computeFaceMassFlux()
             }
 
             // Only track absolute value of mass flux here
-            mdotf[f->get_id()] = abs(mdotf[f->get_id()]);
+            mdotf[f->get_id()] = std::abs(mdotf[f->get_id()]);
         }
         // Internal Face
         else {
@@ -224,7 +310,7 @@ void SOLVER::SIMPLE::computeFaceMassFlux()
             }
 
             // Only track absolute value of mass flux here
-            mdotf[f->get_id()] = abs(mdotf[f->get_id()]);
+            mdotf[f->get_id()] = std::abs(mdotf[f->get_id()]);
         }
         
     }
@@ -236,60 +322,57 @@ void SOLVER::SIMPLE::computeFaceMassFlux()
 
 // * * * * * * * * * * * * * Initialize Momentum System * * * * * * * * * * * * * * //
 // Intialize momentum system
+// NOTE: coefficients are written in place on the shared cell pattern, one pass over the faces
 void SOLVER::SIMPLE::updateMomentumMatrix()
 {
-    double A0;          // diagonal elements
-    double Anb;         // off-diagonal (from neighbors)
-    double mdotf;       // mass flux through face
-    double dface;        // delta_face value: distance between nodes for non-boundary, distance to face for boundary
-    int faceidx;        // face index
-
-    std::shared_ptr<MESH::element> cell;     // cell
-    std::shared_ptr<MESH::element> cellnb;   // cell neighbor
-
-    // reinitialize momentum matrix
-    _momentumSystemA = MATH::matrixCSR(_mesh->get_elements().size(),_mesh->get_elements().size());
-
-    for (int c=0 ; c<_mesh->get_elements().size() ; c++) {
-        // Initialize diagonal element
-        A0 = 0;
-        cell = _mesh->get_elements()[c];
-        // Loop through neighbor elements
-        for (int nb=0 ; nb<cell->get_faces().size() ; nb++ ) {
-
-            // Get mass flux INTO face
-            faceidx = cell->get_faces()[nb]->get_id(); 
-            // boundary or not doesn't matter, that should be accounted for in calculation of mass flux field (Mass flux INTO cell)
-            mdotf = _faceMassFluxField.get_internal()[faceidx] * _massFluxDirection.get_value(c,faceidx);
-            
-            if ( !cell->get_faces()[nb]->is_boundaryFace() ) 
-            // Internal Element
-            {
-                // Neighbor cell
-                cellnb = cell->get_neighbor(nb);
+    double mdotf;       // mass flux through face INTO the cell
+    double Dface;       // diffusion conductance of the face
+    int owner;          // owner cell index
+    int neighbor;       // neighbor cell index
+
+    const std::vector<std::shared_ptr<MESH::face>>& faces = _mesh->get_faces();
+    const std::vector<double>& massFlux = _faceMassFluxField.get_internal();
+
+    // Matrix-free: only the upwinded mass fluxes into the owner and neighbor cells change
+    if (_matrixFree) {
+        std::vector<double> ownerFlux(faces.size(), 0.0);
+        std::vector<double> neighborFlux(faces.size(), 0.0);
+        for (std::size_t f=0 ; f<faces.size() ; f++) {
+            ownerFlux[f] = massFlux[f] * _massFluxDirection.get_value(_faceOwners[f],f);
+            if (_faceNeighbors[f] >= 0) neighborFlux[f] = massFlux[f] * _massFluxDirection.get_value(_faceNeighbors[f],f);
+        }
+        _momentumFaceOperator->set_massFluxes(std::move(ownerFlux), std::move(neighborFlux));
+        _momentumDiagonal = _momentumFaceOperator->get_diagonal();
+        return;
+    }
 
-                // Difference between cell and neighbor centroid, NORMAL TO THE FACE
-                dface = _faceNormalDeltas[faceidx];
+    // reset momentum matrix coefficients
+    const std::vector<int>& diagonalSlots = _cellPattern->get_diagonal_positions();
+    std::vector<double>& A = _momentumSystemA.get_values();
+    std::fill(A.begin(), A.end(), 0.0);
 
-                // Neighbor (off diagonal) coefficients
-                Anb = -(abs(mdotf)-mdotf)/2.0 - mu*cell->get_faces()[nb]->get_volume()/dface;
-                // Update neighbor coefficient
-                _momentumSystemA.set_value(c,cellnb->get_id(),Anb);
+    for (int f=0 ; f<faces.size() ; f++) {
+        // boundary or not doesn't matter, that should be accounted for in calculation of mass flux field
+        Dface = mu*faces[f]->get_volume()/_faceNormalDeltas[f];
 
-                // Incremement cell coefficient (FIRST ORDER UPWIND DIFFERENCING USED HERE)
-                A0 += (abs(mdotf)+mdotf)/2.0 + mu*cell->get_faces()[nb]->get_volume()/dface;
-            }
-            else
-            // Boundary Face
-            {
-                // Use distance to face for delta_face measurement 
-                dface = _faceNormalDeltas[faceidx];
-                // Update diagonal term, but no change to source term
-                A0 += (abs(mdotf)+mdotf)/2.0 + mu*cell->get_faces()[nb]->get_volume()/dface;
-            }
+        // Owner cell (FIRST ORDER UPWIND DIFFERENCING USED HERE)
+        owner = _faceOwners[f];
+        mdotf = massFlux[f] * _massFluxDirection.get_value(owner,f);
+        A[diagonalSlots[owner]] += (std::abs(mdotf)+mdotf)/2.0 + Dface;
+
+        // Internal face: neighbor coefficients and neighbor cell diagonal
+        if ( !faces[f]->is_boundaryFace() ) {
+            neighbor = _faceNeighbors[f];
+            A[_faceSlots[f][0]] += -(std::abs(mdotf)-mdotf)/2.0 - Dface;
+
+            mdotf = massFlux[f] * _massFluxDirection.get_value(neighbor,f);
+            A[diagonalSlots[neighbor]] += (std::abs(mdotf)+mdotf)/2.0 + Dface;
+            A[_faceSlots[f][1]] += -(std::abs(mdotf)-mdotf)/2.0 - Dface;
         }
-        // Update Cell Coefficient
-        _momentumSystemA.set_value(c,c,A0);
+    }
+
+    for (unsigned c=0 ; c<_momentumDiagonal.size() ; c++) {
+        _momentumDiagonal[c] = A[diagonalSlots[c]];
     }
 }
 
@@ -304,22 +387,22 @@ void SOLVER::SIMPLE::updateMomentumRHS()
     MATH::Vector Sz(_mesh->get_elements().size());
 
     // Calculate Source terms due to velocity skew and pressure sources
-    std::vector<MATH::Vector> nodeVelocities = computeNodalVector(_cellVelocityField);
+    std::vector<MATH::Vec<3>> nodeVelocities = computeNodalVector(_cellVelocityField);
 
     // Initializing variables
-    MATH::Vector f_tangent;
-    MATH::Vector skewVelocity;
+    MATH::Vec<3> f_tangent;
+    MATH::Vec<3> skewVelocity;
     double faceSkew;
     std::shared_ptr<MESH::face> f;
     double mdotf;
-    MATH::Vector faceVelocity;
+    MATH::Vec<3> faceVelocity;
 
     // Sources due to Pressure
-    MATH::Vector S_p;
+    MATH::Vec<3> S_p;
     // Sources due to face skew
-    MATH::Vector S_skew;
+    MATH::Vec<3> S_skew;
     // Sources due to boundary conditions
-    MATH::Vector S_bc;
+    MATH::Vec<3> S_bc;
 
     for (const std::shared_ptr<MESH::element>& cell : _mesh->get_elements()) {
         // std::cout << "Cell Coordinates: " << cell.get_centroid() << std::endl;
@@ -357,10 +440,10 @@ void SOLVER::SIMPLE::updateMomentumRHS()
                 // Get face velocity
                 faceVelocity = _BCs[f->get_boundaryID()]->get_velocity(f->get_id());
 
-                S_bc = faceVelocity * ( (abs(mdotf)-mdotf)/2.0 + mu*cell->get_faces()[fi]->get_volume()/_faceNormalDeltas[f->get_id()] );
+                S_bc = faceVelocity * ( (std::abs(mdotf)-mdotf)/2.0 + mu*cell->get_faces()[fi]->get_volume()/_faceNormalDeltas[f->get_id()] );
             }
             else {
-                S_bc = MATH::Vector(_mesh->get_dimension(),0.0);
+                S_bc = MATH::Vec<3>(_mesh->get_dimension(),0.0);
             }
             
 
@@ -369,7 +452,7 @@ void SOLVER::SIMPLE::updateMomentumRHS()
             S_p = -1.0 * _facePressureField.get_internal()[f->get_id()] * cell->get_normals()[fi] * f->get_volume();
             // std::cout << "     Face Normal: " <<cell.get_normals()[fi] << "     Face Coordinates: " << f.get_centroid() << "     Face Volume: " << 
             //         f.get_volume() << "        Face Pressure: " << _facePressureField.get_internal()[f.get_id()] << std::endl;
-            // S_p = MATH::Vector(_mesh->get_dimension(),0.0);
+            // S_p = MATH::Vec<3>(_mesh->get_dimension(),0.0);
 
             // * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * 
             // Total Sources
@@ -395,6 +478,14 @@ void SOLVER::SIMPLE::solveMomentumSystem()
     double tol = 1.0e-6;
     int iter = 1e5;
 
+    if (dumpSystems()) {
+        std::string it = std::to_string(_iteration);
+        MATH::write_matrix_market(_dumpDirectory / ("momentum_A_" + it + ".mtx"), _momentumSystemA);
+        MATH::write_matrix_market(_dumpDirectory / ("momentum_bx_" + it + ".mtx"), _momentumSystemb_x);
+        MATH::write_matrix_market(_dumpDirectory / ("momentum_by_" + it + ".mtx"), _momentumSystemb_y);
+        if (_mesh->get_dimension() == 3) MATH::write_matrix_market(_dumpDirectory / ("momentum_bz_" + it + ".mtx"), _momentumSystemb_z);
+    }
+
     // Set guesses to previous iteration values
     MATH::Vector x_guess(_mesh->get_elements().size());
     MATH::Vector y_guess(_mesh->get_elements().size());
@@ -405,13 +496,31 @@ void SOLVER::SIMPLE::solveMomentumSystem()
         if (_mesh->get_dimension() == 3) z_guess[i] = _cellVelocityField.get_internal()[i][2];
     }
 
-    // Solve x momentum system
-    MATH::gauss_seidel<MATH::matrixCSR> solverx;
-    solverx.set_matrix(_momentumSystemA);
-    solverx.set_rhs(_momentumSystemb_x);
-    solverx.set_guess(x_guess);
-    MATH::Vector x = solverx.solve(iter,tol);
-    std::cout << "x-momentum solver residual: " << solverx.get_residual() << " in " << solverx.get_iterations() << " iterations" << std::endl;
+    // Solve the momentum components together, they share the matrix
+    //      (copies into the persistent right-hand sides and solutions reuse their storage)
+    int numComponents = _mesh->get_dimension() == 3 ? 3 : 2;
+    _momentumRhs.resize(numComponents);
+    _momentumSolution.resize(numComponents);
+    _momentumRhs[0] = _momentumSystemb_x;
+    _momentumRhs[1] = _momentumSystemb_y;
+    _momentumSolution[0] = x_guess;
+    _momentumSolution[1] = y_guess;
+    if (numComponents == 3) {
+        _momentumRhs[2] = _momentumSystemb_z;
+        _momentumSolution[2] = z_guess;
+    }
+    if (_matrixFree) _matrixFreeMomentumSolver.solve_multiple(_momentumRhs, _momentumSolution, iter, tol);
+    else _momentumSolver->solve_multiple(_momentumRhs, _momentumSolution, iter, tol);
+
+    const char components[] = {'x', 'y', 'z'};
+    for (int k = 0; k < numComponents; k++) {
+        double residual = _matrixFree ? _matrixFreeMomentumSolver.get_residual(k) : _momentumSolver->get_residual(k);
+        int iterations = _matrixFree ? _matrixFreeMomentumSolver.get_iterations(k) : _momentumSolver->get_iterations(k);
+        std::cout << components[k] << "-momentum solver residual: " << residual << " in " << iterations << " iterations" << std::endl;
+    }
+    MATH::Vector x = _momentumSolution[0];
+    MATH::Vector y = _momentumSolution[1];
+    MATH::Vector z = numComponents == 3 ? _momentumSolution[2] : MATH::Vector(_mesh->get_elements().size());
 
     // std::cout << "x momentume A: " << std::endl;
     // std::cout << _momentumSystemA << std::endl << std::endl;
@@ -430,14 +539,6 @@ void SOLVER::SIMPLE::solveMomentumSystem()
         // outfile2 << _momentumSystemb_x;
         // outfile2.close();
 
-    // Solve y momentum system
-    MATH::gauss_seidel<MATH::matrixCSR> solvery;
-    solvery.set_matrix(_momentumSystemA);
-    solvery.set_rhs(_momentumSystemb_y);
-    solvery.set_guess(y_guess);
-    MATH::Vector y = solvery.solve(iter,tol);
-    std::cout << "y-momentum solver residual: " << solvery.get_residual() << " in " << solvery.get_iterations() << " iterations" << std::endl;
-
     // std::cout << "y momentume A: " << std::endl;
     // std::cout << _momentumSystemA << std::endl << std::endl;
 
@@ -450,7 +551,7 @@ void SOLVER::SIMPLE::solveMomentumSystem()
     // std::cout << "y-momentum matrix:" << std::endl;
     // std::cout << _momentumSystemA << std::endl;
     // std::cout << "node velocities:" << std::endl;
-    // std::vector<MATH::Vector> nodeVelocities = computeNodalVector(_cellVelocityField);
+    // std::vector<MATH::Vec<3>> nodeVelocities = computeNodalVector(_cellVelocityField);
     // for (int i=0 ; i<_mesh->get_nodes().size() ; i++) {
     //     std::cout << nodeVelocities[i] << std::endl;
     // }
@@ -465,26 +566,15 @@ void SOLVER::SIMPLE::solveMomentumSystem()
     // **********************************************************************
 
 
-    // Solve z momentum system
-    MATH::Vector z(_mesh->get_elements().size());
-    if (_mesh->get_dimension() == 3) {
-        MATH::gauss_seidel<MATH::matrixCSR> solverz;
-        solverz.set_matrix(_momentumSystemA);
-        solverz.set_rhs(_momentumSystemb_z);
-        solverz.set_guess(z_guess);
-        MATH::Vector z = solverz.solve(iter,tol);
-        std::cout << "z-momentum solver residual: " << solverz.get_residual() << " in " << solverz.get_iterations() << " iterations" << std::endl;
-    }
-
     // Relax Momentum Equation
-    x = x*_urelax + x_guess*(1.0-_urelax);
-    y = y*_urelax + y_guess*(1.0-_urelax);
-    if (_mesh->get_dimension() == 3) z = z*_urelax + z_guess*(1.0-_urelax);
+    x.axpby(1.0-_urelax, x_guess, _urelax);
+    y.axpby(1.0-_urelax, y_guess, _urelax);
+    if (_mesh->get_dimension() == 3) z.axpby(1.0-_urelax, z_guess, _urelax);
 
 
     // Assign values back to velocity field
-    std::vector<MATH::Vector> cellVelocities(_mesh->get_elements().size());
-    MATH::Vector v(_mesh->get_dimension());
+    std::vector<MATH::Vec<3>> cellVelocities(_mesh->get_elements().size());
+    MATH::Vec<3> v(_mesh->get_dimension());
     for (const std::shared_ptr<MESH::element>& cell : _mesh->get_elements()) {
         v[0] = x[cell->get_id()];
         v[1] = y[cell->get_id()];
@@ -500,8 +590,9 @@ void SOLVER::SIMPLE::solveMomentumSystem()
 // * * * * * * * * * * * * * Solve Pressure Correction Equation * * * * * * * * * * * * * * //
 void SOLVER::SIMPLE::SolvePressureCorrection()
 {   
-    // First Initialize RHS
-    MATH::Vector mdot_imb(_mesh->get_elements().size());
+    // First Initialize RHS (in place, the pressure solvers reference it)
+    MATH::Vector& mdot_imb = _pressureCorrectionRhs;
+    for (unsigned i = 0; i < mdot_imb.size(); i++) mdot_imb[i] = 0.0;
 
     // pressure correction equation RHS has mass imbalance into cell
     for (const std::shared_ptr<MESH::element>& cell : _mesh->get_elements()) {
@@ -513,53 +604,78 @@ void SOLVER::SIMPLE::SolvePressureCorrection()
     // std::cout << "Mass flux imbalance: " << std::endl;
     // std::cout << mdot_imb << std::endl;
 
-    // Initialize pressure correction matrix
-    double diag;
-    double offdiag;
-    double w1;
-    double mdotbc;
-    std::shared_ptr<MESH::element> cell2;
-    MATH::matrixCSR pc_matrix(_mesh->get_elements().size(),_mesh->get_elements().size());
+    // Boundary mass flux contributions
     for (const std::shared_ptr<MESH::element>& cell : _mesh->get_elements()) {
-        diag = 0.0;
         for (const std::shared_ptr<MESH::face>& f : cell->get_faces()) {
             if (f->is_boundaryFace()) {
                 // Pressure correction is solving for mass flux into cell
-                mdotbc = rho * (_faceVelocityField.get_internal()[f->get_id()] * cell->get_normals()[*cell==*f]);
-                mdot_imb[cell->get_id()] -= mdotbc;
-                continue; // (fine to skip for walls for now, need to fix later...)
-            }
-            else {
-                w1 = cell->get_distanceWeights()[*cell==*f];
-                // Note: faces in cell only contain opposing element
-                cell2 = cell->get_neighbor(*cell==*f);
-
-                // Assign off diagonal
-                offdiag = - (        w1  * cell->get_volume()  / _momentumSystemA.get_value(cell->get_id() ,cell->get_id()  ) 
-                              + (1.0-w1) * cell2->get_volume() / _momentumSystemA.get_value(cell2->get_id(),cell2->get_id() ) 
-                            ) * rho * f->get_volume() / _faceNormalDeltas[f->get_id()];
-                pc_matrix.set_value(cell->get_id(),cell2->get_id(),offdiag);
-
-                // Increment diagonal
-                diag += -offdiag;
+                mdot_imb[cell->get_id()] -= rho * (_faceVelocityField.get_internal()[f->get_id()] * cell->get_normals()[*cell==*f]);
+                // (fine to skip for walls for now, need to fix later...)
             }
         }
-        pc_matrix.set_value(cell->get_id(),cell->get_id(),diag);
     }
 
+    // Assemble pressure correction matrix in place on the shared cell pattern
+    //      (matrix-free: only keep the off diagonal coefficient of every face)
+    double offdiag;
+    double w1;
+    int owner;
+    int neighbor;
+    const std::vector<std::shared_ptr<MESH::face>>& faces = _mesh->get_faces();
+    const std::vector<std::shared_ptr<MESH::element>>& cells = _mesh->get_elements();
+    const MATH::Vector& A0 = _momentumDiagonal;
+    const std::vector<int>& diagonalSlots = _cellPattern->get_diagonal_positions();
+    std::vector<double>& pc = _pressureCorrectionA.get_values();
+    std::fill(pc.begin(), pc.end(), 0.0);
+    std::vector<double> faceCoefficients(_matrixFree ? faces.size() : 0, 0.0);
+    for (int f=0 ; f<faces.size() ; f++) {
+        if (faces[f]->is_boundaryFace()) continue;
+
+        owner = _faceOwners[f];
+        neighbor = _faceNeighbors[f];
+        w1 = _faceWeights[f];
+
+        // Off diagonal is symmetric
+        offdiag = - (        w1  * cells[owner]->get_volume()    / A0[owner] 
+                      + (1.0-w1) * cells[neighbor]->get_volume() / A0[neighbor] 
+                    ) * rho * faces[f]->get_volume() / _faceNormalDeltas[f];
+        if (_matrixFree) {
+            faceCoefficients[f] = offdiag;
+            continue;
+        }
+        pc[_faceSlots[f][0]] += offdiag;
+        pc[_faceSlots[f][1]] += offdiag;
+
+        // Increment diagonals
+        pc[diagonalSlots[owner]] -= offdiag;
+        pc[diagonalSlots[neighbor]] -= offdiag;
+    }
+
+
+    if (dumpSystems()) {
+        std::string it = std::to_string(_iteration);
+        MATH::write_matrix_market(_dumpDirectory / ("pressure_A_" + it + ".mtx"), _pressureCorrectionA);
+        MATH::write_matrix_market(_dumpDirectory / ("pressure_b_" + it + ".mtx"), mdot_imb);
+    }
 
     // Solve the system for the pressure correction
     double iter = 500;
     double tol = 1.0e-6;
-    MATH::conjugate_gradient<MATH::matrixCSR> solverpc;
-    solverpc.set_matrix(pc_matrix);
-    solverpc.set_rhs(mdot_imb);
-    solverpc.set_guess(std::vector(_mesh->get_elements().size(),0.0)); // Pressure correction needs to be initialized to 0
-    _pressureCorrection = solverpc.solve(iter,tol);
-    std::cout << "Pressure Correction solver residual: " << solverpc.get_residual() << " in " << solverpc.get_iterations() << " iterations" << std::endl;
+    if (_matrixFree) {
+        _pressureCorrectionFaceOperator->set_coefficients(std::move(faceCoefficients));
+        _matrixFreePressureSolver.set_guess(_pressureCorrectionGuess);
+        _pressureCorrection = _matrixFreePressureSolver.solve(iter,tol);
+        std::cout << "Pressure Correction solver residual: " << _matrixFreePressureSolver.get_residual() << " in " << _matrixFreePressureSolver.get_iterations() << " iterations" << std::endl;
+    }
+    else {
+        _pressureCorrectionOperator.update(_pressureCorrectionA);
+        _pressureSolver->set_guess(_pressureCorrectionGuess); // Pressure correction needs to be initialized to 0
+        _pressureCorrection = _pressureSolver->solve(iter,tol);
+        std::cout << "Pressure Correction solver residual: " << _pressureSolver->get_residual() << " in " << _pressureSolver->get_iterations() << " iterations" << std::endl;
+    }
 
     // RELAX PRESSURE CORRECTION
-    _pressureCorrection = _prelax * _pressureCorrection;
+    _pressureCorrection.scale(_prelax);
 
     // ****************************************************************************
     // DEBUGGING
@@ -591,12 +707,15 @@ void SOLVER::SIMPLE::correctCellVelocity()
     // Get gradient of pressure correction in the cells
     std::vector<double> pcface = computeFacePressure(_pressureCorrection.get_vector());;
 
-    std::vector<MATH::Vector> vnew = _cellVelocityField.get_internal();
+    std::vector<MATH::Vec<3>> vnew = _cellVelocityField.get_internal();
+
+    // Momentum matrix diagonal
+    const MATH::Vector& A0 = _momentumDiagonal;
 
     // Loop through each cell and correct
     for (const std::shared_ptr<MESH::element>& cell : _mesh->get_elements()) 
     {
-        MATH::Vector vc(_mesh->get_dimension());
+        MATH::Vec<3> vc(_mesh->get_dimension());
         // std::cout << "centroid: " << cell.get_centroid() << std::endl;
         for (int fi=0 ; fi<cell->get_faces().size() ; fi++) {
             // std::cout << "    face normal: " << cell.get_normals()[fi] << "     pc: " << pcface[cell.get_faces()[fi].get_id()] << std::endl;
@@ -604,7 +723,7 @@ void SOLVER::SIMPLE::correctCellVelocity()
             vc = vc + ( pcface[cell->get_faces()[fi]->get_id()] * cell->get_faces()[fi]->get_volume() * (cell->get_normals()[fi]) );
         }
         //          Divide by A0
-        vc = vc * (-1.0/_momentumSystemA.get_value(cell->get_id(),cell->get_id()));
+        vc = vc * (-1.0/A0[cell->get_id()]);
         
         // Correct velocities (relaxation done to pressure correction)
         vnew[cell->get_id()] = vnew[cell->get_id()] + vc;
@@ -625,7 +744,8 @@ void SOLVER::SIMPLE::correctFaceMassFlux()
     std::shared_ptr<MESH::element> cell2;
     double w1;
 
-
+    // Momentum matrix diagonal
+    const MATH::Vector& A0 = _momentumDiagonal;
 
     for (const std::shared_ptr<MESH::face>& f : _mesh->get_faces()) {
 
@@ -653,8 +773,8 @@ void SOLVER::SIMPLE::correctFaceMassFlux()
 
             // Calculate mass flux correction going INTO cell 1
             mdotf_cor[f->get_id()] = -1.0 * rho*f->get_volume() 
-                                        * (w1*cell1->get_volume()/_momentumSystemA.get_value(cell1->get_id(),cell1->get_id()) 
-                                                    + (1-w1)*cell2->get_volume()/_momentumSystemA.get_value(cell2->get_id(),cell2->get_id()))
+                                        * (w1*cell1->get_volume()/A0[cell1->get_id()] 
+                                                    + (1-w1)*cell2->get_volume()/A0[cell2->get_id()])
                                         * ( _pressureCorrection[cell2->get_id()] - _pressureCorrection[cell1->get_id()]) / _faceNormalDeltas[f->get_id()] ;
 
             // Correct face
@@ -689,7 +809,7 @@ void SOLVER::SIMPLE::correctFaceMassFlux()
 bool SOLVER::SIMPLE::checkConvergence()
 {
     double presid = _pressureCorrection.getL2Norm();
-    MATH::Vector v_resid = _cellVelocityField.get_residual();
+    MATH::Vec<3> v_resid = _cellVelocityField.get_residual();
 
     // Output convergences
     std::cout << "Pressure correction convergence: " << _pressureCorrection.getL2Norm() << std::endl;
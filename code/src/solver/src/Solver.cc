@@ -8,6 +8,8 @@
 **
 \*------------------------------------------------------------------------*/
 
+#include <cmath>
+
 #include "Solver.hh"
 #include "BoundaryConditions.hh"
 
@@ -19,9 +21,9 @@
 SOLVER::Solver::Solver(std::shared_ptr<MESH::mesh> mesh)
 :
     _mesh(mesh), 
-    _cellVelocityField(mesh, MATH::Vector(mesh->get_dimension()), "cell", UTILITIES::fieldTypeEnum::VELOCITY),
-    _faceVelocityField(mesh, MATH::Vector(mesh->get_dimension()), "face", UTILITIES::fieldTypeEnum::VELOCITY),
-    _nodeVelocityField(mesh, MATH::Vector(mesh->get_dimension()), "node", UTILITIES::fieldTypeEnum::VELOCITY),
+    _cellVelocityField(mesh, MATH::Vec<3>(mesh->get_dimension()), "cell", UTILITIES::fieldTypeEnum::VELOCITY),
+    _faceVelocityField(mesh, MATH::Vec<3>(mesh->get_dimension()), "face", UTILITIES::fieldTypeEnum::VELOCITY),
+    _nodeVelocityField(mesh, MATH::Vec<3>(mesh->get_dimension()), "node", UTILITIES::fieldTypeEnum::VELOCITY),
     _cellPressureField(mesh, 0.0, "cell", UTILITIES::fieldTypeEnum::PRESSURE),
     _facePressureField(mesh, 0.0, "face", UTILITIES::fieldTypeEnum::PRESSURE),
     _faceMassFluxField(mesh, 0.0, "face", UTILITIES::fieldTypeEnum::MASSFLUX),
@@ -30,6 +32,7 @@ SOLVER::Solver::Solver(std::shared_ptr<MESH::mesh> mesh)
     // Calculate any geometric data that remains constant
     std::cout << "Calculating geometric data..." << std::endl;
     calculateFaceNormalDeltas();
+    buildCellConnectivity();
 }
 
 
@@ -38,7 +41,7 @@ SOLVER::Solver::Solver(std::shared_ptr<MESH::mesh> mesh)
 void SOLVER::Solver::calculateFaceNormalDeltas() {
     std::cout << "  Calculating face normal deltas...";
 
-    MATH::Vector delta(_mesh->get_dimension());
+    MATH::Vec<3> delta(_mesh->get_dimension());
     std::shared_ptr<MESH::element> elem;
     std::shared_ptr<MESH::element> elem2;
 
@@ -57,7 +60,57 @@ void SOLVER::Solver::calculateFaceNormalDeltas() {
             auto faceNormal = elem2->get_centroid() - elem->get_centroid();
             delta = elem2->get_centroid() - elem->get_centroid();
         }
-        _faceNormalDeltas.push_back( abs(delta * elem->get_normals()[*elem==*f]) );
+        _faceNormalDeltas.push_back( std::abs(delta * elem->get_normals()[*elem==*f]) );
+    }
+
+    std::cout << " done!" << std::endl;
+}
+
+
+// * * * * * * * * * * * * * Build Cell Connectivity * * * * * * * * * * * * * * //
+// The cell-to-cell coupling through faces never changes, so the matrix pattern and
+// the storage slot of every face coefficient are computed once and reused every iteration
+void SOLVER::Solver::buildCellConnectivity() {
+    std::cout << "  Building cell connectivity...";
+
+    int nCells = _mesh->get_elements().size();
+    int nFaces = _mesh->get_faces().size();
+
+    _faceOwners.assign(nFaces, -1);
+    _faceNeighbors.assign(nFaces, -1);
+    _faceWeights.assign(nFaces, 1.0);
+
+    // Pattern has a diagonal entry for every cell and two entries per internal face
+    MATH::matrixCOO pattern(nCells, nCells);
+    pattern.reserve(nCells + 2*nFaces);
+    for (int c=0 ; c<nCells ; c++) {
+        pattern.add_value(c, c, 0.0);
+    }
+
+    std::shared_ptr<MESH::element> owner;
+    std::shared_ptr<MESH::element> neighbor;
+    for (const std::shared_ptr<MESH::face>& f : _mesh->get_faces() ) {
+        owner = f->get_elements()[0];
+        _faceOwners[f->get_id()] = owner->get_id();
+
+        if (!f->is_boundaryFace()) {
+            neighbor = f->get_elements()[1];
+            _faceNeighbors[f->get_id()] = neighbor->get_id();
+            _faceWeights[f->get_id()] = owner->get_distanceWeights()[*owner==*f];
+
+            pattern.add_value(owner->get_id(), neighbor->get_id(), 0.0);
+            pattern.add_value(neighbor->get_id(), owner->get_id(), 0.0);
+        }
+    }
+    _cellPattern = pattern.to_CSR().get_pattern();
+
+    // Storage slots of the face coefficients (diagonal slots are cached by the pattern)
+    _faceSlots.assign(nFaces, {-1, -1});
+    for (int f=0 ; f<nFaces ; f++) {
+        if (_faceNeighbors[f] >= 0) {
+            _faceSlots[f] = { _cellPattern->find(_faceOwners[f], _faceNeighbors[f]),
+                              _cellPattern->find(_faceNeighbors[f], _faceOwners[f]) };
+        }
     }
 
     std::cout << " done!" << std::endl;
@@ -65,16 +118,16 @@ void SOLVER::Solver::calculateFaceNormalDeltas() {
 
 
 // * * * * * * * * * * * * * Compute Pressure Gradients * * * * * * * * * * * * * * //
-std::vector<MATH::Vector> SOLVER::Solver::computeCellPressureGradient(std::vector<double> facePressure)
+std::vector<MATH::Vec<3>> SOLVER::Solver::computeCellPressureGradient(std::vector<double> facePressure)
 {
 
     assert(facePressure.size() == _mesh->get_faces().size() && "Invalid face pressure field size!");
 
-    std::vector<MATH::Vector> pressureGradientField;
+    std::vector<MATH::Vec<3>> pressureGradientField;
     
     // Loop over elements to calculte pressure gradient
     for (const std::shared_ptr<MESH::element>& elem : _mesh->get_elements() ) {
-        MATH::Vector pgrad(_mesh->get_dimension());
+        MATH::Vec<3> pgrad(_mesh->get_dimension());
         // Loop over faces to calculate pressure gradient
         for (const std::shared_ptr<MESH::face>& f : elem->get_faces() ) {
             pgrad = pgrad + ( facePressure[f->get_id()] * f->get_volume() * elem->get_normals()[*elem==*f] );
@@ -90,13 +143,13 @@ std::vector<MATH::Vector> SOLVER::Solver::computeCellPressureGradient(std::vecto
 
 
 // * * * * * * * * * * * * * * Compute Face Pressure Gradient * * * * * * * * * * * * * * //
-std::vector<MATH::Vector> SOLVER::Solver::computeFacePressureGradient(std::vector<double> cellPressure, std::vector<double> facePressure)
+std::vector<MATH::Vec<3>> SOLVER::Solver::computeFacePressureGradient(std::vector<double> cellPressure, std::vector<double> facePressure)
 {
     assert(facePressure.size() == _mesh->get_faces().size() && "Invalid face pressure field size!");
     assert(cellPressure.size() == _mesh->get_elements().size() && "Invalid cell pressure field size!");
 
-    std::vector<MATH::Vector> pressureGradientField;
-    MATH::Vector pgrad(_mesh->get_dimension());
+    std::vector<MATH::Vec<3>> pressureGradientField;
+    MATH::Vec<3> pgrad(_mesh->get_dimension());
     double pdiff;
     
     // Loop over elements to calculte pressure gradient
@@ -127,15 +180,15 @@ std::vector<MATH::Vector> SOLVER::Solver::computeFacePressureGradient(std::vecto
 }
 
 // * * * * * * * * * * * * * * Implement nodal calculations * * * * * * * * * * * * * * // 
-std::vector<MATH::Vector> SOLVER::Solver::computeNodalVector(UTILITIES::field<MATH::Vector> field)
+std::vector<MATH::Vec<3>> SOLVER::Solver::computeNodalVector(UTILITIES::field<MATH::Vec<3>> field)
 {
     // Initialize nodal values
-    std::vector<MATH::Vector> nodalValues(_mesh->get_nodes().size());
+    std::vector<MATH::Vec<3>> nodalValues(_mesh->get_nodes().size());
 
     // Loop over nodes
     for (int node=0 ; node<_mesh->get_nodes().size() ; node++)
     {
-        nodalValues[node] = MATH::Vector(_mesh->get_dimension());
+        nodalValues[node] = MATH::Vec<3>(_mesh->get_dimension());
 
         // BOUNDARY NODE VALUE
         if (_mesh->get_nodes()[node]->is_boundaryNode()) {
@@ -149,7 +202,7 @@ std::vector<MATH::Vector> SOLVER::Solver::computeNodalVector(UTILITIES::field<MA
                 }
             }
 
-            MATH::Vector val(std::vector<double>(_mesh->get_dimension(), 0.0));
+            MATH::Vec<3> val(_mesh->get_dimension(), 0.0);
             // Average the node value over the boundary face values
             for (const int& f : faceIdxs) {
                 if (field.get_type() == UTILITIES::fieldTypeEnum::VELOCITY) {
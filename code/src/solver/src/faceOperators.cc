@@ -0,0 +1,157 @@
+/*------------------------------------------------------------------------*\
+**
+**  @file:      faceOperators.cc
+**
+**  @author:    Isaiah Helt (ihelt@gatech.edu)
+**
+**  @brief:     Implementation of the matrix-free SIMPLE operators
+**
+\*------------------------------------------------------------------------*/
+
+#include <cmath>
+#include <cassert>
+#include <utility>
+
+#include "faceOperators.hh"
+#include "threadPool.hh"
+
+
+/*------------------------------------------------------------------------*\
+**  Class faceOperator Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  Constructor * * * * * * * * * * * * * * * //
+SOLVER::faceOperator::faceOperator(int numCells, const std::vector<int>& faceOwners, const std::vector<int>& faceNeighbors)
+:
+    MATH::linearOperator(numCells, numCells),
+    _faceOwners(faceOwners),
+    _faceNeighbors(faceNeighbors),
+    _cellFaceOffsets(numCells + 1, 0)
+{
+    // Count the faces of every cell, then fill in face order
+    for (int f = 0; f < _faceOwners.size(); f++) {
+        _cellFaceOffsets[_faceOwners[f] + 1]++;
+        if (_faceNeighbors[f] >= 0) _cellFaceOffsets[_faceNeighbors[f] + 1]++;
+    }
+    for (int c = 0; c < numCells; c++) {
+        _cellFaceOffsets[c + 1] += _cellFaceOffsets[c];
+    }
+
+    _cellFaces.resize(_cellFaceOffsets[numCells]);
+    std::vector<int> next(_cellFaceOffsets.begin(), _cellFaceOffsets.end() - 1);
+    for (int f = 0; f < _faceOwners.size(); f++) {
+        _cellFaces[next[_faceOwners[f]]++] = f;
+        if (_faceNeighbors[f] >= 0) _cellFaces[next[_faceNeighbors[f]]++] = f;
+    }
+}
+
+
+/*------------------------------------------------------------------------*\
+**  Class momentumOperator Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  Constructor * * * * * * * * * * * * * * * //
+SOLVER::momentumOperator::momentumOperator(int numCells, const std::vector<int>& faceOwners, const std::vector<int>& faceNeighbors, std::vector<double> conductance)
+:
+    faceOperator(numCells, faceOwners, faceNeighbors),
+    _conductance(std::move(conductance)),
+    _ownerFlux(_faceOwners.size(), 0.0),
+    _neighborFlux(_faceOwners.size(), 0.0)
+{
+    assert(_conductance.size() == _faceOwners.size() && "Need one conductance per face");
+}
+
+
+// * * * * * * * * * * * * * *  set_massFluxes * * * * * * * * * * * * * * * //
+void SOLVER::momentumOperator::set_massFluxes(std::vector<double> ownerFlux, std::vector<double> neighborFlux)
+{
+    assert(ownerFlux.size() == _faceOwners.size() && neighborFlux.size() == _faceOwners.size() && "Need one mass flux per face");
+    _ownerFlux = std::move(ownerFlux);
+    _neighborFlux = std::move(neighborFlux);
+}
+
+
+// * * * * * * * * * * * * * *  multiply * * * * * * * * * * * * * * * //
+void SOLVER::momentumOperator::multiply(const MATH::Vector& x, MATH::Vector& y) const
+{
+    assert(x.size() == _num_columns && y.size() == _num_rows && "Vector sizes do not match the operator");
+
+    MATH::parallel_for(MATH::partition_uniform(_num_rows), [&](int cellBegin, int cellEnd) {
+        for (int c = cellBegin; c < cellEnd; c++) {
+            double sum = 0.0;
+            for (int k = _cellFaceOffsets[c]; k < _cellFaceOffsets[c + 1]; k++) {
+                int f = _cellFaces[k];
+                bool owner = (_faceOwners[f] == c);
+                double mdotf = owner ? _ownerFlux[f] : _neighborFlux[f];
+
+                sum += ((std::abs(mdotf) + mdotf)/2.0 + _conductance[f]) * x[c];
+                if (_faceNeighbors[f] >= 0) {
+                    int other = owner ? _faceNeighbors[f] : _faceOwners[f];
+                    sum += (-(std::abs(mdotf) - mdotf)/2.0 - _conductance[f]) * x[other];
+                }
+            }
+            y[c] = sum;
+        }
+    });
+}
+
+
+// * * * * * * * * * * * * * *  get_diagonal * * * * * * * * * * * * * * * //
+MATH::Vector SOLVER::momentumOperator::get_diagonal() const
+{
+    MATH::Vector diagonal(_num_rows);
+    for (int c = 0; c < _num_rows; c++) {
+        for (int k = _cellFaceOffsets[c]; k < _cellFaceOffsets[c + 1]; k++) {
+            int f = _cellFaces[k];
+            double mdotf = (_faceOwners[f] == c) ? _ownerFlux[f] : _neighborFlux[f];
+            diagonal[c] += (std::abs(mdotf) + mdotf)/2.0 + _conductance[f];
+        }
+    }
+    return diagonal;
+}
+
+
+/*------------------------------------------------------------------------*\
+**  Class pressureCorrectionOperator Implementation
+\*------------------------------------------------------------------------*/
+
+// * * * * * * * * * * * * * *  Constructor * * * * * * * * * * * * * * * //
+SOLVER::pressureCorrectionOperator::pressureCorrectionOperator(int numCells, const std::vector<int>& faceOwners, const std::vector<int>& faceNeighbors)
+:
+    faceOperator(numCells, faceOwners, faceNeighbors),
+    _coefficients(_faceOwners.size(), 0.0)
+{}
+
+
+// * * * * * * * * * * * * * *  multiply * * * * * * * * * * * * * * * //
+void SOLVER::pressureCorrectionOperator::multiply(const MATH::Vector& x, MATH::Vector& y) const
+{
+    assert(x.size() == _num_columns && y.size() == _num_rows && "Vector sizes do not match the operator");
+
+    MATH::parallel_for(MATH::partition_uniform(_num_rows), [&](int cellBegin, int cellEnd) {
+        for (int c = cellBegin; c < cellEnd; c++) {
+            double sum = 0.0;
+            for (int k = _cellFaceOffsets[c]; k < _cellFaceOffsets[c + 1]; k++) {
+                int f = _cellFaces[k];
+                if (_faceNeighbors[f] < 0) continue;
+                int other = (_faceOwners[f] == c) ? _faceNeighbors[f] : _faceOwners[f];
+                sum += _coefficients[f] * (x[other] - x[c]);
+            }
+            y[c] = sum;
+        }
+    });
+}
+
+
+// * * * * * * * * * * * * * *  get_diagonal * * * * * * * * * * * * * * * //
+MATH::Vector SOLVER::pressureCorrectionOperator::get_diagonal() const
+{
+    MATH::Vector diagonal(_num_rows);
+    for (int c = 0; c < _num_rows; c++) {
+        for (int k = _cellFaceOffsets[c]; k < _cellFaceOffsets[c + 1]; k++) {
+            int f = _cellFaces[k];
+            if (_faceNeighbors[f] >= 0) diagonal[c] -= _coefficients[f];
+        }
+    }
+    return diagonal;
+}
@@ -84,7 +84,7 @@ TEST_F(simple_test, testFaceVelocities)
     simpleSolver->computeFaceVelocities();
     const auto& faceVelocityField = simpleSolver->get_faceVelocityField();
 
-    std::vector<MATH::Vector> faceVelocities = faceVelocityField.get_internal();
+    std::vector<MATH::Vec<3>> faceVelocities = faceVelocityField.get_internal();
     
     // Assert
     ASSERT_EQ(faceVelocities.size(), simpleSolver->get_mesh()->get_faces().size());
@@ -123,6 +123,31 @@ TEST_F(solver_test, readFaceNormalDistance)
     }
 }
 
+// * * * * * * * * * * * * * *  test cell matrix pattern * * * * * * * * * * * * * * * //
+TEST_F(solver_test, testCellPattern)
+{
+    // Arrange
+    const auto& pattern = solver->get_cellPattern();
+    int nCells = solver->get_mesh()->get_elements().size();
+    int nInternalFaces = 0;
+    for (const auto& f : solver->get_mesh()->get_faces()) {
+        if (!f->is_boundaryFace()) nInternalFaces++;
+    }
+
+    // Act
+
+    // Assert: one diagonal per cell and two couplings per internal face
+    ASSERT_EQ(pattern->get_num_rows(), nCells);
+    ASSERT_EQ(pattern->get_nnz(), nCells + 2*nInternalFaces);
+    for (const auto& f : solver->get_mesh()->get_faces()) {
+        if (f->is_boundaryFace()) continue;
+        int c1 = f->get_elements()[0]->get_id();
+        int c2 = f->get_elements()[1]->get_id();
+        ASSERT_GE(pattern->find(c1,c2), 0);
+        ASSERT_GE(pattern->find(c2,c1), 0);
+    }
+}
+
 // * * * * * * * * * * * * * *  test setting boundary conditions * * * * * * * * * * * * * * * //
 TEST_F(solver_test, test_set_BC)
 {
@@ -139,7 +164,7 @@ TEST_F(solver_test, test_set_BC)
     // - - - - - - - - - - - - - - - - Complete Boundaries - - - - - - - - - - - - - - - - //
     // Arrange
     BOUNDARIES::viscousWallBC bc2(solver,"upper");
-    bc2.set_velocity(MATH::Vector(std::vector<double>{2.0,0.0}));
+    bc2.set_velocity(MATH::Vec<3>(std::vector<double>{2.0,0.0}));
 
     // Act
     solver->setBoundaryCondition(std::make_shared<BOUNDARIES::viscousWallBC>(bc2));
@@ -155,7 +180,7 @@ TEST_F(solver_test, testFacePressureGradients)
     // Arrange
 
     // Act
-    const std::vector<MATH::Vector> pressureGradientField = 
+    const std::vector<MATH::Vec<3>> pressureGradientField = 
         solver->computeFacePressureGradient(solver->get_cellPressureField().get_internal(), solver->get_facePressureField().get_internal());
 
     // Assert
@@ -175,7 +200,7 @@ TEST_F(solver_test, testFacePressureGradients)
     solver->set_cellPressureField(testPressureField);
 
     // Act
-    const std::vector<MATH::Vector> perturbedPressureGradientField = 
+    const std::vector<MATH::Vec<3>> perturbedPressureGradientField = 
         solver->computeFacePressureGradient(solver->get_cellPressureField().get_internal(), solver->get_facePressureField().get_internal());
 
     // Assert
@@ -192,7 +217,7 @@ TEST_F(solver_test, testCellPressureGradients)
     // Arrange
 
     // Act
-    const std::vector<MATH::Vector> pressureGradientField = solver->computeCellPressureGradient(solver->get_facePressureField().get_internal());
+    const std::vector<MATH::Vec<3>> pressureGradientField = solver->computeCellPressureGradient(solver->get_facePressureField().get_internal());
 
     // Assert
     ASSERT_EQ(pressureGradientField.size(), solver->get_mesh()->get_elements().size());
@@ -212,7 +237,7 @@ TEST_F(solver_test, testCellPressureGradients)
     solver->set_facePressureField(testPressureField);
 
     // Act
-    const std::vector<MATH::Vector> perturbedPressureGradientField = solver->computeCellPressureGradient(solver->get_facePressureField().get_internal());
+    const std::vector<MATH::Vec<3>> perturbedPressureGradientField = solver->computeCellPressureGradient(solver->get_facePressureField().get_internal());
 
     // Assert
     for (int face=0 ; face<solver->get_mesh()->get_elements().size() ; face++){
@@ -252,7 +277,7 @@ TEST_F(solver_test, testNodeValues)
     // Arrange
 
     // Act
-    const std::vector<MATH::Vector> nodeValuesVector = solver->computeNodalVector(solver->get_cellVelocityField());
+    const std::vector<MATH::Vec<3>> nodeValuesVector = solver->computeNodalVector(solver->get_cellVelocityField());
 
     // Assert
     for (int node=0 ; node<solver->get_mesh()->get_nodes().size() ; node++){
@@ -100,7 +100,10 @@ private:
         bool _initialized = false;
 };
 
-
+// Residuals are specialized per field type (fields.cc)
+template<> MATH::Vec<3> field<MATH::Vec<3>>::get_residual();
+template<> double field<double>::get_residual();
+template<> std::vector<double> field<std::vector<double>>::get_residual();
 
 };
 
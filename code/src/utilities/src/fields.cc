@@ -9,8 +9,10 @@
 \*------------------------------------------------------------------------*/
 
 #include <type_traits>
+#include <cmath>
 
 #include "fields.hh"
+#include "threadPool.hh"
 
 /*------------------------------------------------------------------------*\
 **  Class field Implementation
@@ -29,36 +31,41 @@ void UTILITIES::field<fieldType>::set_internal(const std::vector<fieldType>& int
 }
 
 
-MATH::Vector UTILITIES::field<MATH::Vector>::get_residual()
+template<>
+MATH::Vec<3> UTILITIES::field<MATH::Vec<3>>::get_residual()
 {
     if (!_initialized) {
         std::cerr << "ERROR: Old Field not initialized" << std::endl;
     }
 
-    MATH::Vector residual(_internal[0].size());
+    // Fixed-order blocked sums: the same residual for any thread count
+    MATH::Vec<3> residual(_internal[0].size());
 
-    for (int i = 0; i < _internal.size(); i++) {
-        for (int j = 0; j < _internal[i].size(); j++) {
-            residual[j] = residual[j] + abs(_internal[i][j] - _old[i][j]);
-        }
+    for (int j = 0; j < residual.size(); j++) {
+        residual[j] = MATH::deterministic_sum(_internal.size(), [&](int begin, int end) {
+            double sum = 0.0;
+            for (int i = begin; i < end; i++) sum += std::abs(_internal[i][j] - _old[i][j]);
+            return sum;
+        });
     }
     return residual;
 }
 
+template<>
 double UTILITIES::field<double>::get_residual()
 {
     if (!_initialized) {
         std::cerr << "ERROR: Old Field not initialized" << std::endl;
     }
 
-    double residual = 0;
-
-    for (int i = 0; i < _internal.size(); i++) {
-        residual = residual + abs(_internal[i] - _old[i]);
-    }
-    return residual;
+    return MATH::deterministic_sum(_internal.size(), [&](int begin, int end) {
+        double sum = 0.0;
+        for (int i = begin; i < end; i++) sum += std::abs(_internal[i] - _old[i]);
+        return sum;
+    });
 }
 
+template<>
 std::vector<double> UTILITIES::field<std::vector<double>>::get_residual()
 {
     if (!_initialized) {
@@ -67,17 +74,18 @@ std::vector<double> UTILITIES::field<std::vector<double>>::get_residual()
     
     std::vector<double> residual(_internal[0].size());
 
-    for (int i = 0; i < _internal.size(); i++) {
-        for (int j = 0; j < _internal[i].size(); j++) {
-            residual[j] = residual[j] + abs(_internal[i][j] - _old[i][j]);
-        }
+    for (int j = 0; j < residual.size(); j++) {
+        residual[j] = MATH::deterministic_sum(_internal.size(), [&](int begin, int end) {
+            double sum = 0.0;
+            for (int i = begin; i < end; i++) sum += std::abs(_internal[i][j] - _old[i][j]);
+            return sum;
+        });
     }
     return residual;
 }
 
-
 // Explicity Template Instantiation
-template class UTILITIES::field<MATH::Vector>;
+template class UTILITIES::field<MATH::Vec<3>>;
 template class UTILITIES::field<std::vector<double>>;
 template class UTILITIES::field<double>;
 
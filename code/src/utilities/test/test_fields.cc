@@ -22,7 +22,7 @@ class test_fields : public ::testing::Test
 protected:
     // Member Data
     std::unique_ptr<UTILITIES::field<std::vector<double>>> test_vec_field;
-    std::unique_ptr<UTILITIES::field<MATH::Vector>> test_Vec_field;
+    std::unique_ptr<UTILITIES::field<MATH::Vec<3>>> test_Vec_field;
     std::unique_ptr<UTILITIES::field<double>> test_scalar_field;
 
     // Node Coordinates
@@ -41,8 +41,8 @@ protected:
     // Vector Internal Field
     std::vector<std::vector<double>> vector_field = {{0.0, 1.0, 2.0} , {0.0, 1.0, 2.0} , {0.0, 1.0, 2.0}};
 
-    // MATH::Vector Internal Field
-    MATH::Vector vi = MATH::Vector(std::vector<double>{0.0, 1.0, 2.0});
+    // MATH::Vec<3> Internal Field
+    MATH::Vec<3> vi = MATH::Vec<3>(std::vector<double>{0.0, 1.0, 2.0});
 
     void SetUp() override
     {
@@ -63,8 +63,8 @@ protected:
         std::cout << "Assigning scalar field" << std::endl;
         test_scalar_field = std::make_unique<UTILITIES::field<double>>(mesh_ptr, 0.0, "cell");
 
-        std::cout << "Assigning MATH::Vector field" << std::endl;
-        test_Vec_field = std::make_unique<UTILITIES::field<MATH::Vector>>(mesh_ptr, vi, "cell");
+        std::cout << "Assigning MATH::Vec<3> field" << std::endl;
+        test_Vec_field = std::make_unique<UTILITIES::field<MATH::Vec<3>>>(mesh_ptr, vi, "cell");
         
         // Initialize test_scalar_field if needed
         // double scalar_initial_value = 0.0;  // Example initialization
@@ -161,13 +161,13 @@ TEST_F(test_fields, test_scalar_residuals)
     ASSERT_DOUBLE_EQ(resid, 6.0);
 }
 
-// Test MATH::Vector field residual
+// Test MATH::Vec<3> field residual
 TEST_F(test_fields, test_MATHVector_residuals)
 {
-    std::cout << "testing MATH::Vector field residuals" << std::endl;
+    std::cout << "testing MATH::Vec<3> field residuals" << std::endl;
     // Arrange
     auto& fieldi = *test_Vec_field;
-    MATH::Vector v2(std::vector<double>{2.0,2.0,2.0});
+    MATH::Vec<3> v2(std::vector<double>{2.0,2.0,2.0});
     fieldi.set_internal({v2, v2, v2});
 
     // Act